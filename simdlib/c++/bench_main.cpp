@@ -0,0 +1,1736 @@
+﻿#include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "benchmark.h"
+#include "elementwise.h"
+#include "expr.h"
+#include "file_search.h"
+#include "gemm.h"
+#include "kernels.h"
+#include "low_precision.h"
+#include "memory.h"
+#include "multi_pattern.h"
+#include "parallel.h"
+#include "perf_counters.h"
+#include "reduce.h"
+#include "similarity.h"
+#include "small_gemm.h"
+#include "sparse.h"
+#include "text_index.h"
+
+// Параметри командного рядка
+struct Options {
+    simd::ReportFormat format = simd::ReportFormat::Text;
+    std::string out_path;               // Порожній — друкуємо в stdout
+    simd::BenchmarkOptions bench;
+    size_t max_bytes = 256u << 20;      // Найбільший робочий набір: має перевищувати LLC
+    size_t max_gemm = 1024;
+    bool all_tiers = false;             // Вимірювати всі підтримувані рівні, а не лише активний
+    bool roofline = false;              // Після звіту надрукувати звіт roofline (лише текстовий формат)
+
+    // Режим пошуку у файлі: --search FILE PATTERN замість вимірювань
+    std::string search_path;
+    std::string search_pattern;
+    bool use_mmap = true;
+    simd::MatchOptions match;           // --ignore-case, --wildcard
+};
+
+void print_usage() {
+    std::cerr << "Usage: simd_bench [--format text|csv|json] [--out FILE] [--trials N] [--warmup N]\n"
+                 "                  [--max-mb N] [--max-gemm N] [--all-tiers] [--roofline] [--no-counters]\n"
+                 "       simd_bench --search FILE PATTERN [--no-mmap] [--ignore-case] [--wildcard]\n";
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--format" && has_value) {
+            if (!simd::parse_report_format(argv[++i], options.format)) {
+                return false;
+            }
+        }
+        else if (arg == "--out" && has_value) {
+            options.out_path = argv[++i];
+        }
+        else if (arg == "--trials" && has_value) {
+            options.bench.trials = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--warmup" && has_value) {
+            options.bench.warmup_runs = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--max-mb" && has_value) {
+            options.max_bytes = std::strtoul(argv[++i], nullptr, 10) << 20;
+        }
+        else if (arg == "--max-gemm" && has_value) {
+            options.max_gemm = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--all-tiers") {
+            options.all_tiers = true;
+        }
+        else if (arg == "--roofline") {
+            options.roofline = true;
+        }
+        else if (arg == "--no-counters") {
+            options.bench.counters = false;
+        }
+        else if (arg == "--search" && i + 2 < argc) {
+            options.search_path = argv[++i];
+            options.search_pattern = argv[++i];
+        }
+        else if (arg == "--no-mmap") {
+            options.use_mmap = false;
+        }
+        else if (arg == "--ignore-case") {
+            options.match.ignore_case = true;
+        }
+        else if (arg == "--wildcard") {
+            options.match.wildcard = true;
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Вхідні дані, спільні для всіх вимірювань. Виділяються й заповнюються один раз
+// під найбільший розмір, менші розміри працюють із префіксами тих самих масивів.
+struct Workload {
+    simd::AlignedBuffer<int> ia, ib, iresult;
+    simd::AlignedBuffer<float> fa, fb, fresult;
+    simd::AlignedBuffer<uint16_t> ha, hb, ba, bb;  // fa і fb у fp16 і bf16
+    simd::AlignedBuffer<int8_t> qa, qb;            // fa і fb, квантовані до int8
+    std::string str;
+    std::string csv;                    // CSV з полями в лапках, зокрема з роздільниками й newline всередині
+    std::vector<std::string> keywords;  // Набір шаблонів для багатошаблонного пошуку
+    std::vector<float> ma, mb, mc;
+    std::string file_path;              // Копія str на диску для пошуку у файлі
+};
+
+// Випадкове "слово" з малих латинських літер
+std::string random_word(std::mt19937& generator, size_t min_len, size_t max_len, char last = 'z') {
+    std::uniform_int_distribution<size_t> len_distribution(min_len, max_len);
+    std::uniform_int_distribution<int> char_distribution('a', last);
+    std::string word(len_distribution(generator), ' ');
+    for (char& c : word) {
+        c = static_cast<char>(char_distribution(generator));
+    }
+    return word;
+}
+
+void fill_workload(Workload& w, size_t max_bytes, size_t max_gemm, std::mt19937& generator) {
+    const size_t elements = max_bytes / (2 * sizeof(float));  // Найбільший набір — у dot_product (два масиви)
+    std::uniform_int_distribution<int> int_distribution(0, 100);
+    std::uniform_real_distribution<float> float_distribution(0.0f, 1.0f);
+    std::uniform_int_distribution<int> char_distribution('a', 'z' + 1);  // 'z' + 1 — пробіл
+
+    w.ia.resize(elements);
+    w.ib.resize(elements);
+    w.iresult.resize(elements);
+    w.fa.resize(elements);
+    w.fb.resize(elements);
+    w.fresult.resize(elements);
+    for (size_t i = 0; i < elements; ++i) {
+        w.ia[i] = int_distribution(generator);
+        w.ib[i] = int_distribution(generator);
+        w.fa[i] = float_distribution(generator);
+        w.fb[i] = float_distribution(generator);
+    }
+    w.ha.resize(elements);
+    w.hb.resize(elements);
+    w.ba.resize(elements);
+    w.bb.resize(elements);
+    w.qa.resize(elements);
+    w.qb.resize(elements);
+    simd::convert_f32_to_f16(w.fa.data(), w.ha.data(), elements);
+    simd::convert_f32_to_f16(w.fb.data(), w.hb.data(), elements);
+    simd::convert_f32_to_bf16(w.fa.data(), w.ba.data(), elements);
+    simd::convert_f32_to_bf16(w.fb.data(), w.bb.data(), elements);
+    simd::quantize_i8(w.fa.data(), w.qa.data(), elements);
+    simd::quantize_i8(w.fb.data(), w.qb.data(), elements);
+    w.str.resize(max_bytes);
+    for (char& c : w.str) {
+        const int value = char_distribution(generator);
+        c = value > 'z' ? ' ' : static_cast<char>(value);
+    }
+    w.csv.clear();
+    w.csv.reserve(max_bytes + 256);
+    std::uniform_int_distribution<int> field_distribution(0, 9);
+    while (w.csv.size() < max_bytes) {
+        for (int field = 0, fields = 4 + field_distribution(generator); field < fields; ++field) {
+            if (field > 0) {
+                w.csv += ',';
+            }
+            if (field_distribution(generator) == 0) {
+                w.csv += '"' + random_word(generator, 2, 10) + ",\n\"\"" + random_word(generator, 0, 10) + '"';
+            }
+            else {
+                w.csv += random_word(generator, 1, 12);
+            }
+        }
+        w.csv += '\n';
+    }
+    w.csv.resize(max_bytes);
+    w.keywords.clear();
+    for (size_t i = 0; i < 200; ++i) {
+        w.keywords.push_back(random_word(generator, 4, 12));
+    }
+    w.ma.resize(max_gemm * max_gemm);
+    w.mb.resize(max_gemm * max_gemm);
+    w.mc.resize(max_gemm * max_gemm);
+    for (size_t i = 0; i < w.ma.size(); ++i) {
+        w.ma[i] = float_distribution(generator) - 0.5f;
+        w.mb[i] = float_distribution(generator) - 0.5f;
+    }
+}
+
+void report(bool match, const std::string& label) {
+    std::cerr << label << (match ? ": results match!" : ": results do not match!") << std::endl;
+}
+
+// Еталонне множення в double для перевірки sgemm
+void gemm_reference(size_t M, size_t N, size_t K, const float* A, size_t lda,
+                    const float* B, size_t ldb, std::vector<double>& C) {
+    C.assign(M * N, 0.0);
+    for (size_t i = 0; i < M; ++i) {
+        for (size_t k = 0; k < K; ++k) {
+            const double a = A[i * lda + k];
+            for (size_t j = 0; j < N; ++j) {
+                C[i * N + j] += a * B[k * ldb + j];
+            }
+        }
+    }
+}
+
+// Перевіряє sgemm на "незручних" розмірах і кроках рядків
+bool check_gemm(std::mt19937& generator) {
+    const size_t M = 131, N = 77, K = 301, lda = K + 3, ldb = N + 5, ldc = N + 1;
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> A(M * lda), B(K * ldb), C(M * ldc, 1.0f);
+    for (float& x : A) x = distribution(generator);
+    for (float& x : B) x = distribution(generator);
+
+    std::vector<double> reference;
+    gemm_reference(M, N, K, A.data(), lda, B.data(), ldb, reference);
+    simd::sgemm(M, N, K, 2.0f, A.data(), lda, B.data(), ldb, 0.5f, C.data(), ldc);
+
+    for (size_t i = 0; i < M; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            const double expected = 2.0 * reference[i * N + j] + 0.5;
+            if (std::abs(C[i * ldc + j] - expected) > 1e-3 * (1.0 + std::abs(expected))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Пакетне множення малих матриць проти gemm_reference в обох розкладках. Матриці AoS розділені
+// проміжками, які мають лишитися незаписаними, B спільна для пакета (крок 0); Interleaved отримує
+// ті самі матриці, переставлені по групах.
+template <size_t M, size_t N, size_t K>
+bool check_small_gemm_shape(std::mt19937& generator, size_t batch) {
+    const size_t L = simd::SMALL_GEMM_LANES;
+    const size_t groups = (batch + L - 1) / L;
+    const size_t stride_a = M * K + 3, stride_c = M * N + 5;
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> A(batch * stride_a), B(K * N), C(batch * stride_c, NAN);
+    for (float& x : A) x = distribution(generator);
+    for (float& x : B) x = distribution(generator);
+    simd::small_gemm_batch<M, N, K>(batch, A.data(), stride_a, B.data(), 0, C.data(), stride_c);
+
+    std::vector<float> Ai(groups * M * K * L), Bi(groups * K * N * L), Ci(groups * M * N * L);
+    for (size_t b = 0; b < batch; ++b) {
+        for (size_t e = 0; e < M * K; ++e) Ai[(b / L * M * K + e) * L + b % L] = A[b * stride_a + e];
+        for (size_t e = 0; e < K * N; ++e) Bi[(b / L * K * N + e) * L + b % L] = B[e];
+    }
+    simd::small_gemm_batch<M, N, K>(batch, Ai.data(), M * K * L, Bi.data(), K * N * L, Ci.data(), M * N * L,
+                                    simd::BatchLayout::Interleaved);
+
+    std::vector<double> reference;
+    bool ok = true;
+    for (size_t b = 0; b < batch && ok; ++b) {
+        gemm_reference(M, N, K, A.data() + b * stride_a, K, B.data(), N, reference);
+        for (size_t e = 0; e < M * N; ++e) {
+            const double tolerance = 1e-5 * (K + std::abs(reference[e]));
+            ok &= std::abs(C[b * stride_c + e] - reference[e]) <= tolerance;
+            ok &= std::abs(Ci[(b / L * M * N + e) * L + b % L] - reference[e]) <= tolerance;
+        }
+        ok &= std::isnan(C[b * stride_c + M * N]);
+    }
+    return ok;
+}
+
+// Форми з неповними регістрами й блоками, пакети, не кратні групі, і пакет, що ділиться між потоками
+bool check_small_gemm(std::mt19937& generator) {
+    bool ok = check_small_gemm_shape<4, 4, 4>(generator, 37);
+    ok &= check_small_gemm_shape<8, 16, 32>(generator, 1);
+    ok &= check_small_gemm_shape<16, 4, 8>(generator, 16);
+    ok &= check_small_gemm_shape<4, 32, 16>(generator, 5);
+    ok &= check_small_gemm_shape<32, 32, 32>(generator, 21);
+    ok &= check_small_gemm_shape<8, 8, 8>(generator, 3001);
+    return ok;
+}
+
+// Випадкова розріджена матриця: кількість ненульових у рядку рівномірна від 0 до 2 * density * cols,
+// тож рядки різної довжини й порожні рядки є завжди; стовпець 0 лишається порожнім
+simd::CsrMatrix random_csr(std::mt19937& generator, size_t rows, size_t cols, double density) {
+    const size_t longest = std::min<size_t>(cols - 1, static_cast<size_t>(2 * density * cols));
+    std::uniform_int_distribution<size_t> len_distribution(0, longest);
+    std::uniform_int_distribution<uint32_t> col_distribution(1, static_cast<uint32_t>(cols - 1));
+    std::uniform_real_distribution<float> value_distribution(-1.0f, 1.0f);
+    simd::CsrMatrix csr;
+    csr.rows = rows;
+    csr.cols = cols;
+    csr.row_ptr.push_back(0);
+    std::vector<uint32_t> row;
+    for (size_t r = 0; r < rows; ++r) {
+        row.clear();
+        for (size_t len = len_distribution(generator); row.size() < len;) {
+            row.push_back(col_distribution(generator));
+            if (row.size() == len) {
+                std::sort(row.begin(), row.end());
+                row.erase(std::unique(row.begin(), row.end()), row.end());
+            }
+        }
+        for (uint32_t c : row) {
+            csr.col_idx.push_back(c);
+            csr.values.push_back(value_distribution(generator));
+        }
+        csr.row_ptr.push_back(csr.values.size());
+    }
+    return csr;
+}
+
+// SpMV обох форматів проти суми в double. x[0] — нескінченність: стовпець 0 порожній, тож доповнення
+// SELL і хвости, прочитані gather'ом без маски, дали б NaN. Останній випадок ділиться між потоками.
+bool check_sparse(std::mt19937& generator) {
+    struct Case { size_t rows, cols; double density; size_t sigma; };
+    const Case cases[] = { { 1, 1, 0.0, 1 }, { 5, 40, 0.2, 1 }, { 37, 100, 0.3, 16 }, { 100, 1000, 0.05, 1024 },
+                           { 333, 64, 0.9, 1 }, { 20000, 5000, 0.004, 256 } };
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    bool ok = true;
+    for (const Case& c : cases) {
+        const simd::CsrMatrix csr = random_csr(generator, c.rows, c.cols, c.density);
+        const simd::SellMatrix sell = simd::sell_from_csr(csr, c.sigma);
+        std::vector<float> x(c.cols);
+        for (float& v : x) v = distribution(generator);
+        x[0] = std::numeric_limits<float>::infinity();
+
+        std::vector<float> y_csr(c.rows, NAN), y_sell(c.rows, NAN);
+        simd::spmv(csr, x.data(), y_csr.data());
+        simd::spmv(sell, x.data(), y_sell.data());
+        for (size_t r = 0; r < c.rows; ++r) {
+            double expected = 0.0, magnitude = 0.0;
+            for (size_t i = csr.row_ptr[r]; i < csr.row_ptr[r + 1]; ++i) {
+                expected += double(csr.values[i]) * x[csr.col_idx[i]];
+                magnitude += std::abs(double(csr.values[i]) * x[csr.col_idx[i]]);
+            }
+            const double tolerance = 1e-6 * (1.0 + magnitude);
+            ok &= std::abs(y_csr[r] - expected) <= tolerance && std::abs(y_sell[r] - expected) <= tolerance;
+        }
+    }
+
+    // Щільна матриця з нулями дає той самий CSR, що й випадкова
+    const simd::CsrMatrix csr = random_csr(generator, 50, 70, 0.2);
+    std::vector<float> dense(50 * 73, 0.0f);
+    for (size_t r = 0; r < csr.rows; ++r) {
+        for (size_t i = csr.row_ptr[r]; i < csr.row_ptr[r + 1]; ++i) {
+            dense[r * 73 + csr.col_idx[i]] = csr.values[i];
+        }
+    }
+    const simd::CsrMatrix converted = simd::csr_from_dense(dense.data(), 50, 70, 73);
+    ok &= converted.row_ptr == csr.row_ptr && converted.col_idx == csr.col_idx && converted.values == csr.values;
+    return ok;
+}
+
+// Порівнює PatternSet із окремими викликами count_substring на тексті з малого алфавіту,
+// де збігів багато, а частина шаблонів є префіксами одна одної
+bool check_multi_pattern(std::mt19937& generator) {
+    const std::string text = random_word(generator, 100003, 100003, 'h');
+    const simd::KernelTable& scalar = simd::kernels_for(simd::CpuTier::Scalar);
+
+    std::vector<std::vector<std::string>> sets(2);
+    for (size_t i = 0; i < 300; ++i) {
+        sets[0].push_back(random_word(generator, 2, 7, 'h'));
+    }
+    sets[0].push_back(sets[0][0]);                      // Дублікат рахується окремо
+    sets[0].push_back(sets[0][1] + "abc");
+    sets[1] = { "a", "", "hgf", "abcabc", "h" };         // Префікс довжини 1 і порожній шаблон
+
+    for (const std::vector<std::string>& patterns : sets) {
+        const simd::PatternSet set(patterns);
+        const std::vector<uint64_t> counts = set.count(text.data(), text.size());
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            const size_t expected = scalar.count_substring(text.data(), text.size(), patterns[i].data(), patterns[i].size(), {});
+            if (counts[i] != expected) {
+                return false;
+            }
+        }
+    }
+
+    // Набір, з якого перемістили, лишається придатним і порожнім
+    simd::PatternSet moved(sets[1]);
+    const simd::PatternSet target(std::move(moved));
+    uint64_t untouched = 7;
+    moved.count(text.data(), text.size(), &untouched);
+    return moved.size() == 0 && untouched == 7 && moved.count(text.data(), text.size()).empty() &&
+           target.size() == sets[1].size();
+}
+
+// Чи збігається байт тексту з байтом шаблону в режимах options
+bool naive_byte_match(char t, char p, const simd::MatchOptions& options) {
+    if (options.wildcard && p == '?') {
+        return true;
+    }
+    if (options.ignore_case && std::isalpha(static_cast<unsigned char>(p))) {
+        return std::tolower(static_cast<unsigned char>(t)) == std::tolower(static_cast<unsigned char>(p)) &&
+               std::isalpha(static_cast<unsigned char>(t));
+    }
+    return t == p;
+}
+
+// Зміщення всіх входжень простим перебором — еталон для find_all і count_substring
+std::vector<size_t> naive_find(const std::string& text, const std::string& pattern,
+                               const simd::MatchOptions& options = simd::MatchOptions()) {
+    std::vector<size_t> positions;
+    for (size_t i = 0; !pattern.empty() && i + pattern.size() <= text.size(); ++i) {
+        size_t j = 0;
+        while (j < pattern.size() && naive_byte_match(text[i + j], pattern[j], options)) {
+            ++j;
+        }
+        if (j == pattern.size()) {
+            positions.push_back(i);
+        }
+    }
+    return positions;
+}
+
+// Перевіряє find_all і count_substring на коротких рядках (включно з коротшими за регістр)
+// та на довгому тексті з малого алфавіту, де збігів багато й буфер позицій переповнюється
+bool check_find_all(std::mt19937& generator) {
+    bool ok = true;
+    std::vector<size_t> positions(150);
+    for (size_t len = 0; len < positions.size(); ++len) {
+        const std::string text = random_word(generator, len, len, 'c');
+        for (const std::string& pattern : { std::string("a"), std::string("ab"), std::string("aa"),
+                                            std::string("cab"), std::string("abcabca"), text }) {
+            const std::vector<size_t> expected = naive_find(text, pattern);
+            size_t cursor = 0;
+            const size_t found = simd::find_all(text.data(), text.size(), pattern.data(), pattern.size(),
+                                                positions.data(), positions.size(), cursor);
+            ok &= simd::count_substring(text.data(), text.size(), pattern.data(), pattern.size()) == expected.size();
+            ok &= found == expected.size() && std::equal(expected.begin(), expected.end(), positions.begin());
+        }
+    }
+
+    const std::string text = random_word(generator, 1000003, 1000003, 'd');
+    positions.resize(37);
+    for (const std::string& pattern : { std::string("ab"), std::string("dcba"), std::string("aaaaa") }) {
+        const std::vector<size_t> expected = naive_find(text, pattern);
+        std::vector<size_t> all;
+        size_t cursor = 0;
+        size_t found;
+        do {
+            found = simd::find_all(text.data(), text.size(), pattern.data(), pattern.size(),
+                                   positions.data(), positions.size(), cursor);
+            all.insert(all.end(), positions.begin(), positions.begin() + found);
+        } while (found == positions.size());
+        ok &= all == expected;
+    }
+    return ok;
+}
+
+// Режими ігнорування регістру й '?' проти перебору. Текст містить обидва регістри, '?' і байти, які
+// від | 0x20 стають малими літерами ('@' і '[' -> '`' і '{', 'A' ^ 0x80), тож хибний збіг зі згортки
+// регістру помітний. Шаблони до 150 байтів перевіряються кількома регістрами, а в кінці тексту — побайтово.
+bool check_match_modes(std::mt19937& generator) {
+    const char alphabet[] = "aAbB?@[`{\xC1";
+    std::uniform_int_distribution<size_t> char_distribution(0, sizeof(alphabet) - 2);
+    std::uniform_int_distribution<size_t> len_distribution(1, 150);
+    const auto random_text = [&](size_t len) {
+        std::string text(len, ' ');
+        for (char& c : text) {
+            c = alphabet[char_distribution(generator)];
+        }
+        return text;
+    };
+    std::vector<simd::MatchOptions> modes(3);
+    modes[0].ignore_case = true;
+    modes[1].wildcard = true;
+    modes[2].ignore_case = modes[2].wildcard = true;
+
+    bool ok = true;
+    std::vector<size_t> positions(64);
+    for (size_t iteration = 0; iteration < 300 && ok; ++iteration) {
+        const std::string text = random_text(iteration < 200 ? len_distribution(generator) : 5000);
+        std::string pattern = text.substr(text.size() / 3, std::min<size_t>(text.size() - text.size() / 3, iteration % 70 + 1));
+        std::uniform_int_distribution<size_t> pos_distribution(0, pattern.size() - 1);
+        if (iteration % 3 == 0) {
+            pattern[pos_distribution(generator)] = 'B';  // Регістр, інший за текстовий
+        }
+        if (iteration % 5 == 0) {
+            pattern = std::string(pattern.size(), '?');
+        }
+        for (const simd::MatchOptions& mode : modes) {
+            const std::vector<size_t> expected = naive_find(text, pattern, mode);
+            std::vector<size_t> all;
+            size_t cursor = 0, found;
+            do {
+                found = simd::find_all(text.data(), text.size(), pattern.data(), pattern.size(),
+                                       positions.data(), positions.size(), cursor, mode);
+                all.insert(all.end(), positions.begin(), positions.begin() + found);
+            } while (found == positions.size());
+            ok &= all == expected;
+            ok &= simd::count_substring(text.data(), text.size(), pattern.data(), pattern.size(), mode) == expected.size();
+        }
+    }
+    return ok;
+}
+
+// Порівнює пошук у файлі з пошуком у пам'яті. Шматки мінімального розміру, щоб меж було багато;
+// серед шаблонів є довший за шматок і довга серія однакових символів із перекривними збігами.
+bool check_file_search(const std::string& str) {
+    std::string text = str.substr(0, std::min<size_t>(str.size(), 1000003));
+    text.replace(text.size() / 3, 20000, 20000, 'a');
+    const std::string path = (std::filesystem::temp_directory_path() / "simd_bench_check.txt").string();
+    std::ofstream(path, std::ios::binary).write(text.data(), text.size());
+
+    bool ok = true;
+    const std::vector<std::string> patterns = { "a", "aaa", "abcd", text.substr(4093, 7), text.substr(8000, 5000), text };
+    for (const std::string& pattern : patterns) {
+        const size_t expected = simd::count_substring(text.data(), text.size(), pattern.data(), pattern.size());
+        for (bool use_mmap : { true, false }) {
+            simd::FileSearchOptions search;
+            search.chunk_bytes = 4096;
+            search.use_mmap = use_mmap;
+            uint64_t count = 0;
+            ok &= simd::count_substring_in_file(path, pattern.data(), pattern.size(), count, search) && count == expected;
+        }
+    }
+
+    // Режими порівняння передаються кожному шматку
+    simd::FileSearchOptions search;
+    search.chunk_bytes = 4096;
+    search.match.ignore_case = search.match.wildcard = true;
+    const std::string pattern = "A?CD";
+    uint64_t count = 0;
+    ok &= simd::count_substring_in_file(path, pattern.data(), pattern.size(), count, search) &&
+          count == simd::count_substring(text.data(), text.size(), pattern.data(), pattern.size(), search.match);
+    std::remove(path.c_str());
+    return ok;
+}
+
+const simd::TypedKernels<int8_t>& typed(const simd::ElementwiseTable& table, int8_t) { return table.i8; }
+const simd::TypedKernels<int16_t>& typed(const simd::ElementwiseTable& table, int16_t) { return table.i16; }
+const simd::TypedKernels<int32_t>& typed(const simd::ElementwiseTable& table, int32_t) { return table.i32; }
+const simd::TypedKernels<int64_t>& typed(const simd::ElementwiseTable& table, int64_t) { return table.i64; }
+const simd::TypedKernels<float>& typed(const simd::ElementwiseTable& table, float) { return table.f32; }
+const simd::TypedKernels<double>& typed(const simd::ElementwiseTable& table, double) { return table.f64; }
+
+template <typename T>
+std::vector<T> random_elements(std::mt19937& generator, size_t count) {
+    std::vector<T> values(count);
+    if constexpr (std::is_integral<T>::value) {
+        std::uniform_int_distribution<int64_t> distribution(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
+        for (T& x : values) x = static_cast<T>(distribution(generator));
+    }
+    else {
+        std::uniform_real_distribution<T> distribution(-100, 100);
+        for (T& x : values) x = distribution(generator);
+    }
+    return values;
+}
+
+// Типізовані ядра активного рівня проти скалярних на довжинах 0..130 (усі залишки для всіх ширин регістрів)
+// і на довгому масиві непарної довжини. Елементи після size не повинні змінюватися. Дійсне fma
+// на рівнях з FMA порівнюється з std::fma (одне округлення), на інших — зі скалярним ядром.
+template <typename T>
+bool check_elementwise_type(std::mt19937& generator) {
+    const simd::TypedKernels<T>& scalar = typed(simd::elementwise_kernels_for(simd::CpuTier::Scalar), T());
+    const simd::TypedKernels<T>& active = typed(simd::elementwise_kernels(), T());
+    const bool fused = std::is_floating_point<T>::value && simd::active_tier() >= simd::CpuTier::AVX2;
+    const size_t guard = 64;
+    const size_t long_size = 100003;
+    const std::vector<T> a = random_elements<T>(generator, long_size);
+    const std::vector<T> b = random_elements<T>(generator, long_size);
+    const std::vector<T> c = random_elements<T>(generator, long_size);
+    std::vector<T> expected(long_size + guard), actual(long_size + guard);
+
+    std::vector<size_t> sizes;
+    for (size_t size = 0; size <= 130; ++size) sizes.push_back(size);
+    sizes.push_back(long_size);
+
+    using Binary = void (*)(const T*, const T*, T*, size_t);
+    for (size_t size : sizes) {
+        for (int op = 0; op < 6; ++op) {
+            std::fill(expected.begin(), expected.end(), T(90));
+            std::fill(actual.begin(), actual.end(), T(90));
+            if (op == 5) {
+                if (fused) {
+                    for (size_t i = 0; i < size; ++i) expected[i] = std::fma(a[i], b[i], c[i]);
+                }
+                else {
+                    scalar.fma(a.data(), b.data(), c.data(), expected.data(), size);
+                }
+                active.fma(a.data(), b.data(), c.data(), actual.data(), size);
+            }
+            else {
+                const Binary scalar_ops[] = { scalar.add, scalar.sub, scalar.mul, scalar.min, scalar.max };
+                const Binary active_ops[] = { active.add, active.sub, active.mul, active.min, active.max };
+                scalar_ops[op](a.data(), b.data(), expected.data(), size);
+                active_ops[op](a.data(), b.data(), actual.data(), size);
+            }
+            if (memcmp(expected.data(), actual.data(), expected.size() * sizeof(T)) != 0) {
+                return false;
+            }
+        }
+    }
+
+    // Публічна обгортка йде через ту саму таблицю
+    scalar.add(a.data(), b.data(), expected.data(), 77);
+    simd::add(a.data(), b.data(), actual.data(), 77);
+    return memcmp(expected.data(), actual.data(), 77 * sizeof(T)) == 0;
+}
+
+bool check_elementwise(std::mt19937& generator) {
+    return check_elementwise_type<int8_t>(generator) && check_elementwise_type<int16_t>(generator) &&
+           check_elementwise_type<int32_t>(generator) && check_elementwise_type<int64_t>(generator) &&
+           check_elementwise_type<float>(generator) && check_elementwise_type<double>(generator);
+}
+
+// Згортки активного рівня проти скалярних на довжинах 0..130 і на довгому масиві непарної довжини.
+// Цілі, min/max, argmin/argmax і count_if мають збігатися точно; дійсні суми й префіксні суми —
+// з допуском відносно суми модулів, бо порядок додавань різний. Цілі з малого діапазону дають
+// повтори, на яких argmin/argmax мають повертати першу появу.
+bool check_reductions(std::mt19937& generator) {
+    const simd::ReduceTable& scalar = simd::reduce_kernels_for(simd::CpuTier::Scalar);
+    const simd::ReduceTable& active = simd::reduce_kernels();
+    const size_t long_size = 100003;
+    const std::vector<int32_t> wide = random_elements<int32_t>(generator, long_size);
+    const std::vector<float> reals = random_elements<float>(generator, long_size);
+    std::vector<int32_t> narrow(long_size);
+    std::uniform_int_distribution<int32_t> digit(0, 9);
+    for (int32_t& x : narrow) x = digit(generator);
+    std::vector<int32_t> iexpected(long_size), iactual(long_size);
+    std::vector<float> fexpected(long_size), factual(long_size);
+
+    std::vector<size_t> sizes;
+    for (size_t size = 0; size <= 130; ++size) sizes.push_back(size);
+    sizes.push_back(long_size);
+
+    const simd::Compare compares[] = { simd::Compare::Less, simd::Compare::LessEqual, simd::Compare::Equal,
+                                       simd::Compare::NotEqual, simd::Compare::Greater, simd::Compare::GreaterEqual };
+    bool ok = true;
+    for (size_t size : sizes) {
+        for (const int32_t* x : { wide.data(), static_cast<const int32_t*>(narrow.data()) }) {
+            ok &= scalar.i32.sum(x, size) == active.i32.sum(x, size);
+            ok &= scalar.i32.min(x, size) == active.i32.min(x, size);
+            ok &= scalar.i32.max(x, size) == active.i32.max(x, size);
+            ok &= scalar.i32.argmin(x, size) == active.i32.argmin(x, size);
+            ok &= scalar.i32.argmax(x, size) == active.i32.argmax(x, size);
+            for (simd::Compare compare : compares) {
+                ok &= scalar.i32.count_if(x, size, compare, 5) == active.i32.count_if(x, size, compare, 5);
+            }
+            scalar.i32.inclusive_scan(x, iexpected.data(), size, 7);
+            active.i32.inclusive_scan(x, iactual.data(), size, 7);
+            ok &= std::equal(iexpected.begin(), iexpected.begin() + size, iactual.begin());
+            scalar.i32.exclusive_scan(x, iexpected.data(), size, 7);
+            active.i32.exclusive_scan(x, iactual.data(), size, 7);
+            ok &= std::equal(iexpected.begin(), iexpected.begin() + size, iactual.begin());
+        }
+
+        const float* x = reals.data();
+        double magnitude = 0.0;
+        for (size_t i = 0; i < size; ++i) magnitude += std::abs(x[i]);
+        const double tolerance = 1e-5 * magnitude + 1e-6;
+        ok &= std::abs(double(scalar.f32.sum(x, size)) - active.f32.sum(x, size)) <= tolerance;
+        ok &= scalar.f32.min(x, size) == active.f32.min(x, size);
+        ok &= scalar.f32.max(x, size) == active.f32.max(x, size);
+        ok &= scalar.f32.argmin(x, size) == active.f32.argmin(x, size);
+        ok &= scalar.f32.argmax(x, size) == active.f32.argmax(x, size);
+        for (simd::Compare compare : compares) {
+            ok &= scalar.f32.count_if(x, size, compare, x[0]) == active.f32.count_if(x, size, compare, x[0]);
+        }
+        for (int inclusive = 0; inclusive < 2; ++inclusive) {
+            const auto scalar_scan = inclusive ? scalar.f32.inclusive_scan : scalar.f32.exclusive_scan;
+            const auto active_scan = inclusive ? active.f32.inclusive_scan : active.f32.exclusive_scan;
+            scalar_scan(x, fexpected.data(), size, 1.5f);
+            active_scan(x, factual.data(), size, 1.5f);
+            for (size_t i = 0; i < size; ++i) {
+                ok &= std::abs(double(fexpected[i]) - factual[i]) <= tolerance + 1e-5 * std::abs(fexpected[i]);
+            }
+        }
+    }
+
+    // Порожній масив і масив, що складається лише з нейтрального елемента
+    ok &= simd::argmin(wide.data(), 0) == 0 && simd::reduce_min(reals.data(), 0) == std::numeric_limits<float>::infinity();
+    const std::vector<float> infinities(37, std::numeric_limits<float>::infinity());
+    ok &= simd::argmin(infinities.data(), infinities.size()) == 0;
+
+    // Публічні префіксні суми на масиві, що йде двопрохідним шляхом, на місці
+    const size_t big = (size_t(1) << 20) + 13;
+    std::vector<int32_t> scanned(big), reference(big);
+    for (size_t i = 0; i < big; ++i) scanned[i] = wide[i % long_size];
+    scalar.i32.inclusive_scan(scanned.data(), reference.data(), big, 0);
+    simd::inclusive_scan(scanned.data(), scanned.data(), big);
+    ok &= scanned == reference;
+    return ok;
+}
+
+// Пошук k найближчих проти повного перебору з сортуванням. Цілі значення з малого діапазону роблять
+// добутки, відстані й норми точними, тож порядок (разом із рівними оцінками, що впорядковуються за
+// номером рядка) і оцінки мають збігатися точно. Рядки й запити мають крок, більший за розмірність.
+bool check_similarity(std::mt19937& generator) {
+    struct Case { size_t rows, dim, queries, k; };
+    const Case cases[] = { { 0, 8, 2, 3 }, { 1, 1, 1, 5 }, { 5, 3, 3, 2 }, { 37, 15, 5, 4 }, { 100, 17, 9, 10 },
+                           { 3, 257, 2, 8 }, { 1000, 100, 4, 16 }, { 20000, 33, 6, 7 } };
+    const simd::Metric metrics[] = { simd::Metric::Dot, simd::Metric::Cosine, simd::Metric::L2 };
+    std::uniform_int_distribution<int> digit(-3, 3);
+    bool ok = true;
+    for (const Case& c : cases) {
+        const size_t ld = c.dim + 3, query_ld = c.dim + 1;
+        std::vector<float> matrix(c.rows * ld), queries(c.queries * query_ld);
+        for (float& x : matrix) x = float(digit(generator));
+        for (float& x : queries) x = float(digit(generator));
+
+        for (simd::Metric metric : metrics) {
+            std::vector<simd::Neighbor> found(c.queries * c.k);
+            const size_t count = simd::top_k(matrix.data(), c.rows, c.dim, ld, queries.data(), c.queries, query_ld,
+                                             c.k, metric, found.data());
+            ok &= count == std::min(c.k, c.rows);
+            for (size_t j = 0; j < c.queries && ok; ++j) {
+                const float* q = queries.data() + j * query_ld;
+                float query_norm = 0.0f;
+                for (size_t d = 0; d < c.dim; ++d) query_norm += q[d] * q[d];
+                std::vector<std::pair<float, size_t>> expected;  // (ключ, більший — краще; рядок)
+                for (size_t r = 0; r < c.rows; ++r) {
+                    const float* x = matrix.data() + r * ld;
+                    float dot = 0.0f, norm = 0.0f, distance = 0.0f;
+                    for (size_t d = 0; d < c.dim; ++d) {
+                        dot += x[d] * q[d];
+                        norm += x[d] * x[d];
+                        distance += (x[d] - q[d]) * (x[d] - q[d]);
+                    }
+                    const double denominator = std::sqrt(static_cast<double>(norm) * query_norm);
+                    const float cosine = denominator > 0.0 ? static_cast<float>(dot / denominator) : 0.0f;
+                    expected.push_back({ metric == simd::Metric::Dot ? dot : metric == simd::Metric::Cosine ? cosine : -distance, r });
+                }
+                std::sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) {
+                    return a.first > b.first || (a.first == b.first && a.second < b.second);
+                });
+                for (size_t i = 0; i < count; ++i) {
+                    const float score = metric == simd::Metric::L2 ? -expected[i].first : expected[i].first;
+                    ok &= found[j * c.k + i].row == expected[i].second && found[j * c.k + i].score == score;
+                }
+            }
+        }
+    }
+
+    // Рядок, що дорівнює запиту, за косинусом дає рівно 1 на довільних float
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    for (size_t dim : { 3, 7, 37, 100, 1000 }) {
+        const size_t rows = 50;
+        std::vector<float> matrix(rows * dim);
+        for (float& x : matrix) x = value(generator);
+        for (size_t r = 0; r < rows && ok; r += 7) {
+            const std::vector<float> query(matrix.begin() + r * dim, matrix.begin() + (r + 1) * dim);
+            simd::Neighbor best;
+            simd::top_k(matrix.data(), rows, dim, dim, query.data(), 1, dim, 1, simd::Metric::Cosine, &best);
+            ok &= best.score == 1.0f && best.row == r;
+        }
+    }
+    return ok;
+}
+
+// Ядра зниженої точності активного рівня (з розширеннями процесора і без них) проти скалярних.
+// Перетворення й поелементні добутки мають збігатися побітово (NaN — лише як NaN): усі 2^16 значень
+// fp16/bf16 і випадкові бітові образи float разом з межами округлення. dot_i8 точний, зокрема на
+// довгих векторах з крайніми значеннями, де суми виходять за int32; dot_f16 і dot_bf16 — з допуском.
+bool check_low_precision(std::mt19937& generator) {
+    const simd::LowPrecisionTable& scalar = simd::low_precision_kernels_for(simd::CpuTier::Scalar);
+    const simd::LowPrecisionTable* tables[] = { &simd::low_precision_kernels(),
+                                                &simd::low_precision_kernels_for(simd::active_tier(), false) };
+    const auto same16 = [](const std::vector<uint16_t>& x, const std::vector<uint16_t>& y, bool bf16) {
+        for (size_t i = 0; i < x.size(); ++i) {
+            const float fx = bf16 ? simd::bf16_to_f32(x[i]) : simd::f16_to_f32(x[i]);
+            const float fy = bf16 ? simd::bf16_to_f32(y[i]) : simd::f16_to_f32(y[i]);
+            if (x[i] != y[i] && !(std::isnan(fx) && std::isnan(fy))) return false;
+        }
+        return true;
+    };
+
+    // Усі 16-бітні образи й float: випадкові біти, межі округлення до fp16 і спеціальні значення
+    std::vector<uint16_t> halves(1 << 16);
+    for (size_t i = 0; i < halves.size(); ++i) halves[i] = static_cast<uint16_t>(i);
+    std::vector<float> floats = { 0.0f, -0.0f, 65504.0f, 65519.99f, 65520.0f, -65520.0f, 0x1p-14f, 0x1.ffcp-15f,
+                                  0x1p-25f, 0x1.000002p-25f, 0x1.8p-24f, 0x1.4p-23f, 0x1p-149f,
+                                  std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+                                  std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::max() };
+    std::uniform_int_distribution<uint32_t> bits;
+    for (size_t i = 0; i < 100003; ++i) {
+        const uint32_t b = bits(generator);
+        float x;
+        memcpy(&x, &b, sizeof(x));
+        floats.push_back(x);
+    }
+    bool ok = true;
+    for (const simd::LowPrecisionTable* table : tables) {
+        for (int bf16 = 0; bf16 < 2; ++bf16) {
+            const auto narrow = bf16 ? &simd::LowPrecisionTable::f32_to_bf16 : &simd::LowPrecisionTable::f32_to_f16;
+            const auto widen = bf16 ? &simd::LowPrecisionTable::bf16_to_f32 : &simd::LowPrecisionTable::f16_to_f32;
+            const auto multiply = bf16 ? &simd::LowPrecisionTable::multiply_bf16 : &simd::LowPrecisionTable::multiply_f16;
+            std::vector<uint16_t> expected(floats.size()), actual(floats.size());
+            (scalar.*narrow)(floats.data(), expected.data(), floats.size());
+            (table->*narrow)(floats.data(), actual.data(), floats.size());
+            ok &= same16(expected, actual, bf16);
+
+            std::vector<float> wide_expected(halves.size()), wide_actual(halves.size());
+            (scalar.*widen)(halves.data(), wide_expected.data(), halves.size());
+            (table->*widen)(halves.data(), wide_actual.data(), halves.size());
+            for (size_t i = 0; i < halves.size(); ++i) {
+                ok &= memcmp(&wide_expected[i], &wide_actual[i], sizeof(float)) == 0 ||
+                      (std::isnan(wide_expected[i]) && std::isnan(wide_actual[i]));
+            }
+
+            // Добутки всіх значень на зсунуті на випадковий крок; на довжинах 0..130 елемент після size не змінюється
+            std::vector<uint16_t> shifted(halves.size());
+            const size_t shift = bits(generator) % halves.size();
+            for (size_t i = 0; i < halves.size(); ++i) shifted[i] = halves[(i + shift) % halves.size()];
+            expected.assign(halves.size(), 0);
+            actual.assign(halves.size(), 0);
+            (scalar.*multiply)(halves.data(), shifted.data(), expected.data(), halves.size());
+            (table->*multiply)(halves.data(), shifted.data(), actual.data(), halves.size());
+            ok &= same16(expected, actual, bf16);
+            for (size_t size = 0; size <= 130; ++size) {
+                std::vector<uint16_t> tail(size + 1, 0xABCD);
+                (table->*multiply)(halves.data() + 15360, shifted.data(), tail.data(), size);
+                ok &= tail[size] == 0xABCD;
+            }
+        }
+
+        // Квантування: однакові коди й масштаби, відхилення після деквантування не більше за scale / 2
+        const size_t long_size = 100003;
+        std::vector<float> x = random_elements<float>(generator, long_size), restored(long_size), reference(long_size);
+        std::vector<int8_t> qa(long_size), qb(long_size), qa_expected(long_size);
+        for (size_t size : { size_t(0), size_t(1), size_t(7), size_t(31), size_t(33), size_t(64), size_t(129), long_size }) {
+            const float max_abs = table->max_abs(x.data(), size);
+            ok &= max_abs == scalar.max_abs(x.data(), size);
+            const float multiplier = max_abs > 0.0f ? 127.0f / max_abs : 0.0f;
+            scalar.quantize_i8(x.data(), qa_expected.data(), size, multiplier);
+            table->quantize_i8(x.data(), qa.data(), size, multiplier);
+            ok &= std::equal(qa.begin(), qa.begin() + size, qa_expected.begin());
+            const float scale = max_abs / 127.0f;
+            scalar.dequantize_i8(qa.data(), reference.data(), size, scale);
+            table->dequantize_i8(qa.data(), restored.data(), size, scale);
+            ok &= std::equal(restored.begin(), restored.begin() + size, reference.begin());
+            for (size_t i = 0; i < size; ++i) {
+                ok &= std::abs(restored[i] - x[i]) <= scale * 0.5f * 1.001f;
+            }
+        }
+
+        // Скалярні добутки на всіх довжинах 0..130 і на довгому масиві
+        std::uniform_int_distribution<int> code(-127, 127);
+        for (int8_t& q : qa) q = static_cast<int8_t>(code(generator));
+        for (int8_t& q : qb) q = static_cast<int8_t>(code(generator));
+        std::vector<uint16_t> ha(long_size), hb(long_size), ba(long_size), bb(long_size);
+        std::vector<float> y = random_elements<float>(generator, long_size);
+        scalar.f32_to_f16(x.data(), ha.data(), long_size);
+        scalar.f32_to_f16(y.data(), hb.data(), long_size);
+        scalar.f32_to_bf16(x.data(), ba.data(), long_size);
+        scalar.f32_to_bf16(y.data(), bb.data(), long_size);
+        std::vector<size_t> sizes;
+        for (size_t size = 0; size <= 130; ++size) sizes.push_back(size);
+        sizes.push_back(long_size);
+        for (size_t size : sizes) {
+            ok &= table->dot_i8(qa.data(), qb.data(), size) == scalar.dot_i8(qa.data(), qb.data(), size);
+            double f16_exact = 0.0, bf16_exact = 0.0, magnitude = 0.0;
+            for (size_t i = 0; i < size; ++i) {
+                f16_exact += double(simd::f16_to_f32(ha[i])) * simd::f16_to_f32(hb[i]);
+                bf16_exact += double(simd::bf16_to_f32(ba[i])) * simd::bf16_to_f32(bb[i]);
+                magnitude += std::abs(double(x[i]) * y[i]);
+            }
+            const double tolerance = 1e-5 * magnitude + 1e-6;
+            ok &= std::abs(table->dot_f16(ha.data(), hb.data(), size) - f16_exact) <= tolerance;
+            ok &= std::abs(table->dot_bf16(ba.data(), bb.data(), size) - bf16_exact) <= tolerance;
+        }
+
+        // Крайні значення на кількох блоках накопичення в int32: сума за межами int32
+        const size_t big = (size_t(3) << 20) + 5;
+        std::vector<int8_t> plus(big, 127), minus(big, -127);
+        ok &= table->dot_i8(plus.data(), plus.data(), big) == int64_t(big) * 127 * 127;
+        ok &= table->dot_i8(plus.data(), minus.data(), big) == -int64_t(big) * 127 * 127;
+        ok &= table->dot_i8(minus.data(), minus.data(), big) == int64_t(big) * 127 * 127;
+    }
+
+    // Публічне квантування: масштаб і коди симетричні, найбільший модуль стає 127
+    const std::vector<float> values = { -2.0f, 0.5f, 1.0f, 0.0f };
+    std::vector<int8_t> codes(values.size());
+    const float scale = simd::quantize_i8(values.data(), codes.data(), values.size());
+    ok &= scale == 2.0f / 127.0f && codes[0] == -127 && codes[1] == 32 && codes[2] == 64 && codes[3] == 0;
+    return ok;
+}
+
+// Побайтовий розбір, як у скалярному розбивачі CSV: еталон для index_fields і базовий рядок у simd_bench
+simd::FieldIndex index_fields_reference(const char* text, size_t len, const simd::TextDialect& dialect) {
+    simd::FieldIndex index;
+    bool quoted = false;
+    for (size_t i = 0; i < len; ++i) {
+        const char c = text[i];
+        if (dialect.quote != '\0' && c == dialect.quote) {
+            quoted = !quoted;
+        }
+        else if (!quoted && (c == dialect.delimiter || c == dialect.newline)) {
+            index.field_ends.push_back(i);
+            if (c == dialect.newline) {
+                index.row_ends.push_back(index.field_ends.size());
+            }
+        }
+    }
+    const bool terminated = !index.row_ends.empty() && index.row_ends.back() == index.field_ends.size() &&
+                            index.field_ends.back() == len - 1;
+    if (len > 0 && !terminated) {
+        index.field_ends.push_back(len);
+        index.row_ends.push_back(index.field_ends.size());
+    }
+    return index;
+}
+
+// Сканер тексту на випадкових текстах з роздільників, лапок і newline: короткі зачіпають неповні блоки,
+// текст на кілька МіБ — паралельну обробку шматками зі станом лапок, перенесеним через межі шматків
+bool check_text_index(std::mt19937& generator) {
+    const char alphabet[] = "ab,\"\n\t";
+    std::uniform_int_distribution<int> char_distribution(0, sizeof(alphabet) - 2);
+    std::uniform_int_distribution<size_t> len_distribution(0, 300);
+    const simd::TextDialect tsv = { '\t', '\0', '\n' };
+    bool ok = true;
+
+    std::vector<uint64_t> positions;
+    ok &= !simd::find_bytes("abc", 3, "", positions);
+    ok &= !simd::find_bytes("abc", 3, "abcdefghi", positions);
+    for (size_t iteration = 0; iteration < 201 && ok; ++iteration) {
+        std::string text(iteration == 200 ? (3u << 20) + 17 : len_distribution(generator), ' ');
+        for (char& c : text) {
+            c = alphabet[char_distribution(generator)];
+        }
+
+        std::vector<uint64_t> lines_ref, bytes_ref;
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (i == 0 || text[i - 1] == '\n') {
+                lines_ref.push_back(i);
+            }
+            if (text[i] == ',' || text[i] == '\t' || text[i] == '"') {
+                bytes_ref.push_back(i);
+            }
+        }
+        ok &= simd::line_index(text.data(), text.size()) == lines_ref;
+        ok &= simd::find_bytes(text.data(), text.size(), ",\t\",", positions) && positions == bytes_ref;
+
+        for (const simd::TextDialect& dialect : { simd::TextDialect(), tsv }) {
+            const simd::FieldIndex index = simd::index_fields(text.data(), text.size(), dialect);
+            const simd::FieldIndex ref = index_fields_reference(text.data(), text.size(), dialect);
+            ok &= index.field_ends == ref.field_ends && index.row_ends == ref.row_ends;
+        }
+    }
+    return ok;
+}
+
+// Ліниві вирази проти тих самих операцій окремими викликами ядер: add і mul округлюються однаково
+// на всіх рівнях, тож результат має збігатися побітово; dot — з відносним допуском
+bool check_expressions(const Workload& w, size_t size) {
+    using namespace simd::expr;
+    const simd::KernelTable& scalar = simd::kernels_for(simd::CpuTier::Scalar);
+    const float* a = w.fa.data();
+    const float* b = w.fb.data();
+    const float* c = w.fa.data() + w.fa.size() - size;  // Третій масив — кінець fa
+    std::vector<float> ref(size), tmp(size), result(size);
+
+    scalar.add_f32(a, b, tmp.data(), size);
+    scalar.mul_f32(tmp.data(), c, ref.data(), size);
+    simd::expr::evaluate(result.data(), (vec(a, size) + vec(b, size)) * vec(c, size));
+    bool ok = ref == result;
+
+    std::vector<float> twos(size, 2.0f), ones(size, 1.0f);
+    scalar.mul_f32(a, twos.data(), tmp.data(), size);
+    scalar.add_f32(tmp.data(), ones.data(), ref.data(), size);
+    simd::expr::evaluate(result.data(), 2.0f * vec(a, size) + 1.0f);
+    ok &= ref == result;
+
+    // FMA порівнюється з ядром активного рівня: на рівнях без FMA округлення інше
+    simd::fma_vectors(a, b, c, ref.data(), size);
+    simd::expr::evaluate(result.data(), fma(vec(a, size), vec(b, size), vec(c, size)));
+    ok &= ref == result;
+
+    // Результат на місці одного з входів
+    scalar.add_f32(a, b, ref.data(), size);
+    std::copy(a, a + size, result.begin());
+    simd::expr::evaluate(result.data(), vec(result) + vec(b, size));
+    ok &= ref == result;
+
+    double dot_ref = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+        dot_ref += (double(a[i]) + double(b[i])) * c[i];
+    }
+    const float dot_value = dot(vec(a, size) + vec(b, size), vec(c, size));
+    ok &= std::abs(dot_value - dot_ref) <= 1e-4 * std::abs(dot_ref);
+
+    double sum_ref = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+        sum_ref += a[i];
+    }
+    ok &= std::abs(simd::expr::sum(vec(a, size)) - sum_ref) <= 1e-4 * std::abs(sum_ref);
+
+    // Масиви різної довжини відхиляються до запису, а не обрізаються до коротшого
+    std::fill(result.begin(), result.end(), 3.0f);
+    bool rejected = false;
+    try {
+        simd::expr::evaluate(result.data(), vec(a, size) + vec(b, size - 1));
+    }
+    catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    ok &= rejected && result[0] == 3.0f;
+    rejected = false;
+    try {
+        dot(vec(a, size), vec(b, size) * vec(c, size / 2));
+    }
+    catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    ok &= rejected;
+    return ok;
+}
+
+// Перевіряє режими dot_product на даних зі знакозмінними доданками різних порядків проти еталона
+// в long double і їхніх задокументованих меж похибки (див. DotMode). Детермінований результат
+// має збігатися побітово з першим обчисленим (на скалярному рівні), тому дані генеруються з фіксованого зерна.
+bool check_dot_modes(float& deterministic) {
+    const size_t size = 1000003;
+    std::mt19937 generator(2024);
+    std::uniform_real_distribution<float> mantissa(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> exponent(0, 12);
+    std::vector<float> a(size), b(size);
+    long double exact = 0.0L;
+    double magnitude = 0.0;  // S = sum |a[i] * b[i]|
+    for (size_t i = 0; i < size; ++i) {
+        a[i] = std::ldexp(mantissa(generator), exponent(generator));
+        b[i] = std::ldexp(mantissa(generator), exponent(generator));
+        exact += static_cast<long double>(a[i]) * b[i];
+        magnitude += std::abs(static_cast<double>(a[i]) * b[i]);
+    }
+    const double u = std::ldexp(1.0, -24);
+    const double dot = static_cast<double>(exact);
+    const double n = static_cast<double>(size);
+
+    const double fast_error = std::abs(simd::dot_product(a.data(), b.data(), size, simd::DotMode::Fast) - dot);
+    const double compensated_error = std::abs(simd::dot_product(a.data(), b.data(), size, simd::DotMode::Compensated) - dot);
+    const float det = simd::dot_product(a.data(), b.data(), size, simd::DotMode::Deterministic);
+    const double det_error = std::abs(det - dot);
+
+    bool ok = fast_error <= (n + 1) * u * magnitude;
+    ok &= compensated_error <= u * std::abs(dot) + (n * u) * (n * u) * magnitude;
+    ok &= det_error <= u * std::abs(dot) + (n / 16 + n / 65536 + 4) * std::ldexp(1.0, -53) * magnitude;
+    if (std::isnan(deterministic)) {
+        deterministic = det;
+    }
+    ok &= memcmp(&det, &deterministic, sizeof(float)) == 0;
+    return ok;
+}
+
+// Перевіряє всі ядра поточного рівня проти скалярних реалізацій
+bool verify_tier(const Workload& w, std::mt19937& generator, float& deterministic_dot) {
+    const size_t size = std::min<size_t>(w.fa.size(), 1000003);  // Непарний розмір, щоб зачепити хвости
+    const size_t str_len = std::min<size_t>(w.str.size(), 10000019);
+    const char substr[] = "abcd";
+    const simd::KernelTable& scalar = simd::kernels_for(simd::CpuTier::Scalar);
+    bool ok = true;
+
+    std::vector<int> iref(size), iresult(size);
+    scalar.add_i32(w.ia.data(), w.ib.data(), iref.data(), size);
+    simd::add_arrays(w.ia.data(), w.ib.data(), iresult.data(), size);
+    ok &= iref == iresult;
+    report(iref == iresult, "add_arrays");
+
+    std::vector<float> fref(size), fresult(size);
+    scalar.add_f32(w.fa.data(), w.fb.data(), fref.data(), size);
+    simd::add_vectors(w.fa.data(), w.fb.data(), fresult.data(), size);
+    ok &= fref == fresult;
+    report(fref == fresult, "add_vectors");
+
+    scalar.mul_f32(w.fa.data(), w.fb.data(), fref.data(), size);
+    simd::multiply_vectors(w.fa.data(), w.fb.data(), fresult.data(), size);
+    ok &= fref == fresult;
+    report(fref == fresult, "multiply_vectors");
+
+    // Паралельні версії на зсунутому на один елемент результаті, щоб межі частин не збігалися з початком
+    std::vector<int> iparallel(size + 1);
+    std::vector<float> fparallel(size + 1);
+    scalar.add_i32(w.ia.data(), w.ib.data(), iref.data(), size);
+    simd::parallel_add_arrays(w.ia.data(), w.ib.data(), iparallel.data() + 1, size);
+    bool parallel_ok = std::equal(iref.begin(), iref.end(), iparallel.begin() + 1);
+    scalar.add_f32(w.fa.data(), w.fb.data(), fref.data(), size);
+    simd::parallel_add_vectors(w.fa.data(), w.fb.data(), fparallel.data() + 1, size);
+    parallel_ok &= std::equal(fref.begin(), fref.end(), fparallel.begin() + 1);
+    scalar.mul_f32(w.fa.data(), w.fb.data(), fref.data(), size);
+    simd::parallel_multiply_vectors(w.fa.data(), w.fb.data(), fparallel.data() + 1, size);
+    parallel_ok &= std::equal(fref.begin(), fref.end(), fparallel.begin() + 1);
+    ok &= parallel_ok;
+    report(parallel_ok, "parallel element-wise kernels");
+
+    // Потокові версії викликаються напряму, бо автоматичний вибір вмикає їх лише на великих масивах
+    const simd::KernelTable& table = simd::kernels();
+    table.add_i32_stream(w.ia.data(), w.ib.data(), iparallel.data() + 1, size);
+    scalar.add_i32(w.ia.data(), w.ib.data(), iref.data(), size);
+    bool stream_ok = std::equal(iref.begin(), iref.end(), iparallel.begin() + 1);
+    table.add_f32_stream(w.fa.data(), w.fb.data(), fparallel.data() + 1, size);
+    scalar.add_f32(w.fa.data(), w.fb.data(), fref.data(), size);
+    stream_ok &= std::equal(fref.begin(), fref.end(), fparallel.begin() + 1);
+    table.mul_f32_stream(w.fa.data(), w.fb.data(), fparallel.data() + 1, size);
+    scalar.mul_f32(w.fa.data(), w.fb.data(), fref.data(), size);
+    stream_ok &= std::equal(fref.begin(), fref.end(), fparallel.begin() + 1);
+    ok &= stream_ok;
+    report(stream_ok, "streaming element-wise kernels");
+
+    // Порядок підсумовування різний, тому порівнюємо з відносним допуском
+    const float dot_ref = scalar.dot_f32(w.fa.data(), w.fb.data(), size);
+    const float dot = simd::dot_product(w.fa.data(), w.fb.data(), size);
+    const bool dot_ok = std::abs(dot - dot_ref) <= 1e-3f * std::abs(dot_ref);
+    ok &= dot_ok;
+    report(dot_ok, "dot_product");
+
+    const bool typed_ok = check_elementwise(generator);
+    ok &= typed_ok;
+    report(typed_ok, "typed element-wise kernels");
+
+    const bool reduce_ok = check_reductions(generator);
+    ok &= reduce_ok;
+    report(reduce_ok, "reductions and scans");
+
+    const bool expr_ok = check_expressions(w, size);
+    ok &= expr_ok;
+    report(expr_ok, "lazy expressions");
+
+    const bool modes_ok = check_dot_modes(deterministic_dot);
+    ok &= modes_ok;
+    report(modes_ok, "dot_product modes");
+
+    const size_t count_ref = scalar.count_substring(w.str.data(), str_len, substr, strlen(substr), {});
+    const size_t count = simd::count_substring(w.str.data(), str_len, substr, strlen(substr));
+    ok &= count == count_ref;
+    report(count == count_ref, "count_substring");
+
+    const bool find_ok = check_find_all(generator);
+    ok &= find_ok;
+    report(find_ok, "find_all");
+
+    const bool modes_match_ok = check_match_modes(generator);
+    ok &= modes_match_ok;
+    report(modes_match_ok, "count_substring modes");
+
+    const bool file_ok = check_file_search(w.str);
+    ok &= file_ok;
+    report(file_ok, "count_substring_in_file");
+
+    const bool multi_ok = check_multi_pattern(generator);
+    ok &= multi_ok;
+    report(multi_ok, "PatternSet::count");
+
+    const bool gemm_ok = check_gemm(generator);
+    ok &= gemm_ok;
+    report(gemm_ok, "sgemm");
+
+    const bool small_gemm_ok = check_small_gemm(generator);
+    ok &= small_gemm_ok;
+    report(small_gemm_ok, "small_gemm_batch");
+
+    const bool sparse_ok = check_sparse(generator);
+    ok &= sparse_ok;
+    report(sparse_ok, "spmv");
+
+    const bool similarity_ok = check_similarity(generator);
+    ok &= similarity_ok;
+    report(similarity_ok, "top_k");
+
+    const bool low_precision_ok = check_low_precision(generator);
+    ok &= low_precision_ok;
+    report(low_precision_ok, "low-precision kernels");
+
+    const bool text_ok = check_text_index(generator);
+    ok &= text_ok;
+    report(text_ok, "text index");
+    return ok;
+}
+
+// Пакет матриць M x K на K x N із робочим набором близько 4 МіБ: розкладки AoS і Interleaved
+// та окремий виклик sgemm на кожну матрицю, тобто те, що пакетне API замінює
+template <size_t M, size_t N, size_t K>
+void run_small_gemm(Workload& w, const Options& options, std::vector<simd::BenchmarkResult>& results) {
+    const size_t L = simd::SMALL_GEMM_LANES;
+    const size_t per_matrix = M * K + K * N + M * N;
+    const size_t fit = std::min({ w.fa.size() / (M * K), w.fb.size() / (K * N), w.fresult.size() / (M * N) });
+    const size_t batch = std::min(fit, (size_t(4) << 20) / (per_matrix * sizeof(float))) / L * L;
+    if (batch == 0) {
+        return;
+    }
+    const std::string name = "small_gemm_" + std::to_string(M) + "x" + std::to_string(N) + "x" + std::to_string(K);
+    const size_t bytes = batch * per_matrix * sizeof(float);
+    const double flops = 2.0 * M * N * K * batch;
+    const float* A = w.fa.data();
+    const float* B = w.fb.data();
+    float* C = w.fresult.data();
+    results.push_back(simd::run_benchmark({ name + "_aos", batch, bytes, flops,
+        [&] { simd::small_gemm_batch<M, N, K>(batch, A, M * K, B, K * N, C, M * N); } }, options.bench));
+    results.push_back(simd::run_benchmark({ name + "_interleaved", batch, bytes, flops,
+        [&] {
+            simd::small_gemm_batch<M, N, K>(batch, A, M * K * L, B, K * N * L, C, M * N * L, simd::BatchLayout::Interleaved);
+        } }, options.bench));
+    results.push_back(simd::run_benchmark({ name + "_sgemm", batch, bytes, flops,
+        [&] {
+            for (size_t b = 0; b < batch; ++b) {
+                simd::sgemm(M, N, K, 1.0f, A + b * M * K, K, B + b * K * N, N, 0.0f, C + b * M * N, N);
+            }
+        } }, options.bench));
+}
+
+// Проганяє розгортку розмірів для всіх ядер на активному рівні
+void run_sweep(Workload& w, const Options& options, std::vector<simd::BenchmarkResult>& results) {
+    const char substr[] = "abcd";
+    const simd::PatternSet keywords(w.keywords);
+    std::vector<uint64_t> keyword_counts(keywords.size());
+    std::vector<size_t> positions(1024);
+    std::vector<uint64_t> text_positions;
+    std::string lowered(w.str.size(), ' ');
+    simd::MatchOptions ignore_case, wildcard;
+    ignore_case.ignore_case = true;
+    wildcard.wildcard = true;
+
+    for (size_t bytes : simd::sweep_working_sets(options.max_bytes)) {
+        // Елементні ядра: два вхідні масиви й результат
+        const size_t n3 = bytes / (3 * sizeof(float));
+        results.push_back(simd::run_benchmark({ "add_arrays", n3, n3 * 3 * sizeof(int), 0,
+            [&] { simd::add_arrays(w.ia.data(), w.ib.data(), w.iresult.data(), n3); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "add_vectors", n3, n3 * 3 * sizeof(float), double(n3),
+            [&] { simd::add_vectors(w.fa.data(), w.fb.data(), w.fresult.data(), n3); } }, options.bench));
+        // Ті самі додавання з примусовим вибором запису: через кеш і потоковими записами
+        const simd::KernelTable& table = simd::kernels();
+        results.push_back(simd::run_benchmark({ "add_vectors_cached", n3, n3 * 3 * sizeof(float), double(n3),
+            [&] { table.add_f32(w.fa.data(), w.fb.data(), w.fresult.data(), n3); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "add_vectors_stream", n3, n3 * 3 * sizeof(float), double(n3),
+            [&] { table.add_f32_stream(w.fa.data(), w.fb.data(), w.fresult.data(), n3); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "multiply_vectors", n3, n3 * 3 * sizeof(float), double(n3),
+            [&] { simd::multiply_vectors(w.fa.data(), w.fb.data(), w.fresult.data(), n3); } }, options.bench));
+
+        // Типізовані ядра на 8-бітних цілих і FMA на double (чотири масиви)
+        const size_t n3_i8 = bytes / 3;
+        results.push_back(simd::run_benchmark({ "typed_add_i8", n3_i8, n3_i8 * 3, 0,
+            [&] {
+                simd::add(reinterpret_cast<const int8_t*>(w.ia.data()), reinterpret_cast<const int8_t*>(w.ib.data()),
+                          reinterpret_cast<int8_t*>(w.iresult.data()), n3_i8);
+            } }, options.bench));
+        const size_t n4_f64 = bytes / (4 * sizeof(double));
+        const double* da = reinterpret_cast<const double*>(w.fa.data());
+        const double* db = reinterpret_cast<const double*>(w.fb.data());
+        const double* dc = reinterpret_cast<const double*>(w.fa.data() + w.fa.size() / 2);
+        results.push_back(simd::run_benchmark({ "typed_fma_f64", n4_f64, n4_f64 * 4 * sizeof(double), 2.0 * n4_f64,
+            [&] { simd::fma(da, db, dc, reinterpret_cast<double*>(w.fresult.data()), n4_f64); } }, options.bench));
+
+        // (a + b) * c: три входи й результат. Злитий вираз проходить пам'ять один раз, окремі виклики —
+        // двічі через тимчасовий масив. Третій вхід і тимчасовий масив — другі половини fa і fb.
+        // Байти й операції однакові для обох варіантів, тож пропускна здатність показує виграш від злиття.
+        const size_t n4 = bytes / (4 * sizeof(float));
+        const size_t half = w.fa.size() / 2;
+        const float* fc = w.fa.data() + half;
+        float* ftmp = w.fb.data() + half;
+        results.push_back(simd::run_benchmark({ "expr_add_mul_fused", n4, n4 * 4 * sizeof(float), 2.0 * n4,
+            [&] {
+                using namespace simd::expr;
+                simd::expr::evaluate(w.fresult.data(), (vec(w.fa.data(), n4) + vec(w.fb.data(), n4)) * vec(fc, n4));
+            } }, options.bench));
+        results.push_back(simd::run_benchmark({ "expr_add_mul_separate", n4, n4 * 4 * sizeof(float), 2.0 * n4,
+            [&] {
+                simd::add_vectors(w.fa.data(), w.fb.data(), ftmp, n4);
+                simd::multiply_vectors(ftmp, fc, w.fresult.data(), n4);
+            } }, options.bench));
+        volatile float sink = 0.0f;
+        results.push_back(simd::run_benchmark({ "expr_dot_sum_fused", n4, n4 * 3 * sizeof(float), 3.0 * n4,
+            [&] {
+                using namespace simd::expr;
+                sink = simd::expr::dot(vec(w.fa.data(), n4) + vec(w.fb.data(), n4), vec(fc, n4));
+            } }, options.bench));
+        results.push_back(simd::run_benchmark({ "expr_dot_sum_separate", n4, n4 * 3 * sizeof(float), 3.0 * n4,
+            [&] {
+                simd::add_vectors(w.fa.data(), w.fb.data(), ftmp, n4);
+                sink = simd::dot_product(ftmp, fc, n4);
+            } }, options.bench));
+
+        // Скалярний добуток лише читає два масиви
+        const size_t n2 = bytes / (2 * sizeof(float));
+        results.push_back(simd::run_benchmark({ "dot_product", n2, n2 * 2 * sizeof(float), 2.0 * n2,
+            [&] { sink = simd::dot_product(w.fa.data(), w.fb.data(), n2); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "dot_product_compensated", n2, n2 * 2 * sizeof(float), 2.0 * n2,
+            [&] { sink = simd::dot_product(w.fa.data(), w.fb.data(), n2, simd::DotMode::Compensated); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "dot_product_deterministic", n2, n2 * 2 * sizeof(float), 2.0 * n2,
+            [&] { sink = simd::dot_product(w.fa.data(), w.fb.data(), n2, simd::DotMode::Deterministic); } }, options.bench));
+
+        // Ті самі n2 елементів у зниженій точності: fp16 і bf16 займають удвічі, int8 — вчетверо менше байтів.
+        // Варіанти *_base — ядра рівня без розширень процесора (vpmaddubsw замість VNNI, зсув замість vdpbf16ps).
+        const simd::LowPrecisionTable& base = simd::low_precision_kernels_for(simd::active_tier(), false);
+        results.push_back(simd::run_benchmark({ "dot_f16", n2, n2 * 2 * sizeof(uint16_t), 2.0 * n2,
+            [&] { sink = simd::dot_f16(w.ha.data(), w.hb.data(), n2); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "dot_bf16", n2, n2 * 2 * sizeof(uint16_t), 2.0 * n2,
+            [&] { sink = simd::dot_bf16(w.ba.data(), w.bb.data(), n2); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "dot_bf16_base", n2, n2 * 2 * sizeof(uint16_t), 2.0 * n2,
+            [&] { sink = base.dot_bf16(w.ba.data(), w.bb.data(), n2); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "dot_i8", n2, n2 * 2, 0,
+            [&] { sink = float(simd::dot_i8(w.qa.data(), w.qb.data(), n2)); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "dot_i8_base", n2, n2 * 2, 0,
+            [&] { sink = float(base.dot_i8(w.qa.data(), w.qb.data(), n2)); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "multiply_f16", n3, n3 * 3 * sizeof(uint16_t), double(n3),
+            [&] { simd::multiply_f16(w.ha.data(), w.hb.data(), reinterpret_cast<uint16_t*>(w.fresult.data()), n3); } }, options.bench));
+
+        // Згортки читають один масив (розміром як у dot_product, бо довших масивів у наборі немає);
+        // префіксні суми ще й пишуть результат
+        const size_t n1 = n2;
+        volatile size_t index_sink = 0;
+        results.push_back(simd::run_benchmark({ "reduce_sum_f32", n1, n1 * sizeof(float), double(n1),
+            [&] { sink = simd::reduce_sum(w.fa.data(), n1); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "reduce_sum_i32", n1, n1 * sizeof(int), 0,
+            [&] { index_sink = size_t(simd::reduce_sum(w.ia.data(), n1)); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "reduce_min_f32", n1, n1 * sizeof(float), double(n1),
+            [&] { sink = simd::reduce_min(w.fa.data(), n1); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "argmin_f32", n1, n1 * sizeof(float), double(n1),
+            [&] { index_sink = simd::argmin(w.fa.data(), n1); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "count_if_f32", n1, n1 * sizeof(float), double(n1),
+            [&] { index_sink = simd::count_if(w.fa.data(), n1, simd::Compare::Less, 0.5f); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "inclusive_scan_f32", n2, n2 * 2 * sizeof(float), double(n2),
+            [&] { simd::inclusive_scan(w.fa.data(), w.fresult.data(), n2); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "inclusive_scan_i32", n2, n2 * 2 * sizeof(int), 0,
+            [&] { simd::inclusive_scan(w.ia.data(), w.iresult.data(), n2); } }, options.bench));
+
+        results.push_back(simd::run_benchmark({ "count_substring", bytes, bytes, 0,
+            [&] { sink = float(simd::count_substring(w.str.data(), bytes, substr, strlen(substr))); } }, options.bench));
+        // Ті самі збіги без урахування регістру і з '?' та те, що ці режими замінюють: мала копія тексту й точний пошук
+        results.push_back(simd::run_benchmark({ "count_substring_icase", bytes, bytes, 0,
+            [&] { sink = float(simd::count_substring(w.str.data(), bytes, "AbCd", 4, ignore_case)); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "count_substring_wildcard", bytes, bytes, 0,
+            [&] { sink = float(simd::count_substring(w.str.data(), bytes, "a?cd", 4, wildcard)); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "count_substring_lower_copy", bytes, bytes, 0,
+            [&] {
+                std::transform(w.str.begin(), w.str.begin() + bytes, lowered.begin(),
+                               [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c | 0x20) : c; });
+                sink = float(simd::count_substring(lowered.data(), bytes, substr, strlen(substr)));
+            } }, options.bench));
+        results.push_back(simd::run_benchmark({ "find_all", bytes, bytes, 0,
+            [&] {
+                size_t cursor = 0;
+                while (simd::find_all(w.str.data(), bytes, substr, strlen(substr), positions.data(), positions.size(), cursor) ==
+                       positions.size()) {
+                }
+            } }, options.bench));
+        results.push_back(simd::run_benchmark({ "multi_pattern_count_200", bytes, bytes, 0,
+            [&] { keywords.count(w.str.data(), bytes, keyword_counts.data()); } }, options.bench));
+
+        // Індекси CSV (разом із виділенням результату); index_fields_baseline — побайтовий розбір
+        results.push_back(simd::run_benchmark({ "line_index", bytes, bytes, 0,
+            [&] { sink = float(simd::line_index(w.csv.data(), bytes).size()); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "find_bytes_4", bytes, bytes, 0,
+            [&] {
+                simd::find_bytes(w.csv.data(), bytes, ",\n\"\t", text_positions);
+                sink = float(text_positions.size());
+            } }, options.bench));
+        results.push_back(simd::run_benchmark({ "index_fields", bytes, bytes, 0,
+            [&] { sink = float(simd::index_fields(w.csv.data(), bytes).field_ends.size()); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "index_fields_baseline", bytes, bytes, 0,
+            [&] { sink = float(index_fields_reference(w.csv.data(), bytes, simd::TextDialect()).field_ends.size()); } },
+            options.bench));
+    }
+
+    // Пакет коротких масивів довжиною 1..64 (типово для пакетних навантажень): типізоване ядро з маскованим
+    // залишком проти add_vectors зі скалярним циклом залишку. Кожні 64 виклики проходять ті самі 25 КіБ,
+    // тож дані лежать в L1 і вимірюється саме обробка залишків і виклик.
+    {
+        const size_t calls = 4096;
+        const size_t total = calls / 64 * (64 * 65 / 2);
+        results.push_back(simd::run_benchmark({ "short_add_f32_typed", total, total * 3 * sizeof(float), double(total),
+            [&] {
+                size_t offset = 0;
+                for (size_t k = 0; k < calls; ++k) {
+                    const size_t len = k % 64 + 1;
+                    simd::add(w.fa.data() + offset, w.fb.data() + offset, w.fresult.data() + offset, len);
+                    offset = len == 64 ? 0 : offset + len;
+                }
+            } }, options.bench));
+        results.push_back(simd::run_benchmark({ "short_add_f32_kernel", total, total * 3 * sizeof(float), double(total),
+            [&] {
+                size_t offset = 0;
+                for (size_t k = 0; k < calls; ++k) {
+                    const size_t len = k % 64 + 1;
+                    simd::add_vectors(w.fa.data() + offset, w.fb.data() + offset, w.fresult.data() + offset, len);
+                    offset = len == 64 ? 0 : offset + len;
+                }
+            } }, options.bench));
+    }
+
+    // Виділення масивів у кожній ітерації: з пулу пам'яті сторінки вже відображені, напряму з ОС кожен
+    // перший запис у сторінку — page fault. Обидва варіанти копіюють входи й додають на найбільшому наборі.
+    {
+        const size_t n = options.max_bytes / (3 * sizeof(float));
+        const auto alloc_and_add = [&](simd::MemoryPool* pool) {
+            simd::AlignedBuffer<float> a(n, simd::HugePages::Auto, pool), b(n, simd::HugePages::Auto, pool),
+                result(n, simd::HugePages::Auto, pool);
+            memcpy(a.data(), w.fa.data(), n * sizeof(float));
+            memcpy(b.data(), w.fb.data(), n * sizeof(float));
+            simd::add_vectors(a.data(), b.data(), result.data(), n);
+        };
+        results.push_back(simd::run_benchmark({ "alloc_add_vectors_pooled", n, n * 5 * sizeof(float), double(n),
+            [&] { alloc_and_add(&simd::default_memory_pool()); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "alloc_add_vectors_fresh", n, n * 5 * sizeof(float), double(n),
+            [&] { alloc_and_add(nullptr); } }, options.bench));
+        simd::default_memory_pool().trim();
+    }
+
+    // Пошук у файлі з кешу сторінок: межа, до якої має наближатися читання з диска
+    if (!w.file_path.empty()) {
+        const size_t bytes = w.str.size();
+        results.push_back(simd::run_benchmark({ "count_substring_file", bytes, bytes, 0,
+            [&] {
+                uint64_t count = 0;
+                simd::count_substring_in_file(w.file_path, substr, strlen(substr), count);
+            } }, options.bench));
+    }
+
+    // k = 10 найближчих рядків матриці N x 256 (увесь fa) для одного запиту й пакета з 16 запитів.
+    // rowwise — те, що пошук замінює: dot_product для кожної пари рядок-запит і часткове сортування;
+    // він читає матрицю з пам'яті окремо для кожного запиту.
+    {
+        const size_t dim = 256, k = 10, batch = 16;
+        const size_t rows = w.fa.size() / dim;
+        const size_t matrix_bytes = rows * dim * sizeof(float);
+        const double flops = 2.0 * rows * dim;
+        const float* matrix = w.fa.data();
+        const float* queries = w.fb.data();
+        std::vector<simd::Neighbor> found(batch * k);
+        const auto search = [&](size_t count, simd::Metric metric) {
+            simd::top_k(matrix, rows, dim, queries, count, k, metric, found.data());
+        };
+        results.push_back(simd::run_benchmark({ "top_k_dot_1q", rows, matrix_bytes, flops,
+            [&] { search(1, simd::Metric::Dot); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "top_k_dot_16q", rows, matrix_bytes, flops * batch,
+            [&] { search(batch, simd::Metric::Dot); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "top_k_cosine_16q", rows, matrix_bytes, flops * batch,
+            [&] { search(batch, simd::Metric::Cosine); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "top_k_l2_16q", rows, matrix_bytes, flops * batch,
+            [&] { search(batch, simd::Metric::L2); } }, options.bench));
+        std::vector<std::pair<float, size_t>> scored(rows);
+        results.push_back(simd::run_benchmark({ "top_k_rowwise_dot_16q", rows, matrix_bytes * batch, flops * batch,
+            [&] {
+                for (size_t j = 0; j < batch; ++j) {
+                    for (size_t r = 0; r < rows; ++r) {
+                        scored[r] = { simd::dot_product(matrix + r * dim, queries + j * dim, dim), r };
+                    }
+                    std::partial_sort(scored.begin(), scored.begin() + k, scored.end(), std::greater<>());
+                }
+            } }, options.bench));
+    }
+
+    // SpMV квадратної матриці n x n (до 4096) у CSR і SELL-C-sigma за різної щільності проти щільного
+    // множення на вектор (dot_product для кожного рядка). Операції — лише корисні, 2 * nnz,
+    // для щільного — 2 * n * n; щільний шлях не залежить від щільності й вимірюється один раз.
+    {
+        size_t n = 1024;
+        while (n < 4096 && 4 * n * n <= w.fa.size()) {
+            n *= 2;
+        }
+        n = std::min(n, static_cast<size_t>(std::sqrt(double(w.fa.size()))));
+        std::mt19937 sparse_generator(7);
+        const float* x = w.fb.data();
+        float* y = w.fresult.data();
+        results.push_back(simd::run_benchmark({ "spmv_dense", n * n, (n * n + 2 * n) * sizeof(float), 2.0 * n * n,
+            [&] {
+                for (size_t r = 0; r < n; ++r) {
+                    y[r] = simd::dot_product(w.fa.data() + r * n, x, n);
+                }
+            } }, options.bench));
+        const std::pair<double, const char*> densities[] = { { 0.3, "30pct" }, { 0.1, "10pct" }, { 0.01, "1pct" }, { 0.001, "0.1pct" } };
+        for (const auto& density : densities) {
+            const simd::CsrMatrix csr = random_csr(sparse_generator, n, n, density.first);
+            const simd::SellMatrix sell = simd::sell_from_csr(csr);
+            const double flops = 2.0 * csr.nnz();
+            const size_t csr_bytes = csr.nnz() * 8 + n * (sizeof(size_t) + 2 * sizeof(float));
+            const size_t sell_bytes = sell.values.size() * 8 + n * (3 * sizeof(uint32_t) + 2 * sizeof(float));
+            results.push_back(simd::run_benchmark({ std::string("spmv_csr_") + density.second, csr.nnz(), csr_bytes, flops,
+                [&] { simd::spmv(csr, x, y); } }, options.bench));
+            results.push_back(simd::run_benchmark({ std::string("spmv_sell_") + density.second, csr.nnz(), sell_bytes, flops,
+                [&] { simd::spmv(sell, x, y); } }, options.bench));
+        }
+    }
+
+    run_small_gemm<4, 4, 4>(w, options, results);
+    run_small_gemm<8, 8, 8>(w, options, results);
+    run_small_gemm<16, 16, 16>(w, options, results);
+    run_small_gemm<32, 32, 32>(w, options, results);
+
+    for (size_t n = 128; n <= options.max_gemm; n *= 2) {
+        const double flops = 2.0 * n * n * n;
+        const size_t bytes = 3 * n * n * sizeof(float);
+        results.push_back(simd::run_benchmark({ "sgemm", n * n, bytes, flops,
+            [&] { simd::sgemm(n, n, n, 1.0f, w.ma.data(), n, w.mb.data(), n, 0.0f, w.mc.data(), n); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "sgemm_baseline", n * n, bytes, flops,
+            [&] { simd::sgemm_baseline(n, w.ma.data(), w.mb.data(), w.mc.data()); } }, options.bench));
+    }
+}
+
+// Рахує входження шаблону у файлі й друкує час і пропускну здатність
+int search_file(const Options& options) {
+    simd::FileSearchOptions search;
+    search.use_mmap = options.use_mmap;
+    search.match = options.match;
+    const std::string& pattern = options.search_pattern;
+    uint64_t count = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    if (!simd::count_substring_in_file(options.search_path, pattern.data(), pattern.size(), count, search)) {
+        std::cerr << "Cannot read " << options.search_path << std::endl;
+        return 1;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double bytes = static_cast<double>(std::filesystem::file_size(options.search_path));
+
+    std::cout << "Substring count: " << count << std::endl;
+    std::cerr << "Tier: " << simd::tier_name(simd::active_tier()) << ", " << seconds << " s, "
+              << bytes / seconds * 1e-9 << " GB/s" << std::endl;
+    return 0;
+}
+
+// Масштабування паралельних поелементних ядер на найбільшому робочому наборі: 1, 2, 4, ... потоків
+// і розмір спільного пулу (SIMDLIB_THREADS або кількість ядер). Для кожної кількості потоків масиви виділяються заново й розміщуються через first_touch
+// тим самим пулом, щоб на NUMA-системах кожен потік читав пам'ять свого вузла.
+void run_scaling(const Workload& w, const Options& options, std::vector<simd::BenchmarkResult>& results) {
+    const size_t n = options.max_bytes / (3 * sizeof(float));
+    const size_t hw = simd::default_pool().size();
+    std::vector<size_t> thread_counts;
+    for (size_t t = 1; t < hw; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    thread_counts.push_back(hw);
+
+    for (size_t threads : thread_counts) {
+        simd::ThreadPool pool(threads);
+        // Повз пул пам'яті: закешовані сторінки вже розміщені попереднім пулом потоків
+        simd::AlignedBuffer<float> a(n, simd::HugePages::Auto, nullptr), b(n, simd::HugePages::Auto, nullptr),
+            result(n, simd::HugePages::Auto, nullptr);
+        simd::first_touch(a.data(), n * sizeof(float), pool);
+        simd::first_touch(b.data(), n * sizeof(float), pool);
+        simd::first_touch(result.data(), n * sizeof(float), pool);
+        memcpy(a.data(), w.fa.data(), n * sizeof(float));
+        memcpy(b.data(), w.fb.data(), n * sizeof(float));
+
+        // Цілочисельне додавання працює з тими самими байтами як з int
+        const int* ia = reinterpret_cast<const int*>(a.data());
+        const int* ib = reinterpret_cast<const int*>(b.data());
+        int* iresult = reinterpret_cast<int*>(result.data());
+        const std::string suffix = "_t" + std::to_string(threads);
+        results.push_back(simd::run_benchmark({ "parallel_add_arrays" + suffix, n, n * 3 * sizeof(int), 0,
+            [&] { simd::parallel_add_arrays(ia, ib, iresult, n, pool); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "parallel_add_vectors" + suffix, n, n * 3 * sizeof(float), double(n),
+            [&] { simd::parallel_add_vectors(a.data(), b.data(), result.data(), n, pool); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "parallel_multiply_vectors" + suffix, n, n * 3 * sizeof(float), double(n),
+            [&] { simd::parallel_multiply_vectors(a.data(), b.data(), result.data(), n, pool); } }, options.bench));
+    }
+}
+
+// Порт multiply_matrices_regular із task4: скалярне множення з обходом B по стовпцях
+void matmul_scalar(size_t n, const float* A, const float* B, float* C) {
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            float sum = 0.0f;
+            for (size_t k = 0; k < n; ++k) {
+                sum += A[i * n + k] * B[k * n + j];
+            }
+            C[i * n + j] = sum;
+        }
+    }
+}
+
+// Перевіряє ядра task1–task5 на інтринсиках активного рівня проти скалярних на тих самих буферах,
+// а скалярний порт множення task4 — проти еталона в double
+bool check_task_kernels(const Workload& w) {
+    const size_t size = std::min<size_t>(w.fa.size(), 1000003);
+    const size_t str_len = std::min<size_t>(w.str.size(), 10000019);
+    const simd::KernelTable& scalar = simd::kernels_for(simd::CpuTier::Scalar);
+    const simd::KernelTable& table = simd::kernels();
+    bool ok = true;
+
+    std::vector<int> iref(size), iresult(size);
+    scalar.add_i32(w.ia.data(), w.ib.data(), iref.data(), size);
+    table.add_i32(w.ia.data(), w.ib.data(), iresult.data(), size);
+    ok &= iref == iresult;
+
+    std::vector<float> fref(size), fresult(size);
+    scalar.add_f32(w.fa.data(), w.fb.data(), fref.data(), size);
+    table.add_f32(w.fa.data(), w.fb.data(), fresult.data(), size);
+    ok &= fref == fresult;
+
+    // Порядок підсумовування різний, тому порівнюємо з відносним допуском
+    const float dot_ref = scalar.dot_f32(w.fa.data(), w.fb.data(), size);
+    const float dot = table.dot_f32(w.fa.data(), w.fb.data(), size);
+    ok &= std::abs(dot - dot_ref) <= 1e-3f * std::abs(dot_ref);
+
+    // Шаблони різної довжини, зокрема довший за регістр і порожній
+    const std::string patterns[] = { "a", "abcd", "ab cd", std::string(40, 'a'), std::string() };
+    for (const std::string& pattern : patterns) {
+        const size_t count_ref = scalar.count_substring(w.str.data(), str_len, pattern.data(), pattern.size(), {});
+        const size_t count = table.count_substring(w.str.data(), str_len, pattern.data(), pattern.size(), {});
+        ok &= count == count_ref;
+    }
+
+    // Розмір, не кратний 8, зачіпає скалярні стовпці; sgemm_baseline на ньому сам переходить на скалярний цикл
+    const size_t n = std::min<size_t>(131, static_cast<size_t>(std::sqrt(w.ma.size())));
+    std::vector<double> cref;
+    std::vector<float> cbase(n * n), cscalar(n * n);
+    gemm_reference(n, n, n, w.ma.data(), n, w.mb.data(), n, cref);
+    simd::sgemm_baseline(n, w.ma.data(), w.mb.data(), cbase.data());
+    matmul_scalar(n, w.ma.data(), w.mb.data(), cscalar.data());
+    for (size_t i = 0; i < n * n; ++i) {
+        const double tolerance = 1e-4 * n;  // |a|, |b| <= 0.5
+        ok &= std::abs(cbase[i] - cref[i]) <= tolerance && std::abs(cscalar[i] - cref[i]) <= tolerance;
+    }
+    return ok;
+}
+
+// Ядра task1–task5 на інтринсиках активного рівня проти скалярних на тих самих буферах, поруч у звіті.
+// Ядра рівнів викликаються з таблиць, повз потокові записи, тож порівнюється лише сам цикл.
+void run_task_comparison(Workload& w, const Options& options, std::vector<simd::BenchmarkResult>& results) {
+    const simd::KernelTable& scalar = simd::kernels_for(simd::CpuTier::Scalar);
+    const simd::KernelTable& table = simd::kernels();
+    const char substr[] = "abcd";
+    const size_t substr_len = strlen(substr);
+    volatile float sink = 0.0f;
+
+    for (size_t bytes : simd::sweep_working_sets(options.max_bytes)) {
+        const size_t n3 = bytes / (3 * sizeof(float));
+        results.push_back(simd::run_benchmark({ "add_arrays_intrinsics", n3, n3 * 3 * sizeof(int), 0,
+            [&] { table.add_i32(w.ia.data(), w.ib.data(), w.iresult.data(), n3); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "add_arrays_scalar", n3, n3 * 3 * sizeof(int), 0,
+            [&] { scalar.add_i32(w.ia.data(), w.ib.data(), w.iresult.data(), n3); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "add_vectors_intrinsics", n3, n3 * 3 * sizeof(float), double(n3),
+            [&] { table.add_f32(w.fa.data(), w.fb.data(), w.fresult.data(), n3); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "add_vectors_scalar", n3, n3 * 3 * sizeof(float), double(n3),
+            [&] { scalar.add_f32(w.fa.data(), w.fb.data(), w.fresult.data(), n3); } }, options.bench));
+
+        const size_t n2 = bytes / (2 * sizeof(float));
+        results.push_back(simd::run_benchmark({ "dot_product_intrinsics", n2, n2 * 2 * sizeof(float), 2.0 * n2,
+            [&] { sink = table.dot_f32(w.fa.data(), w.fb.data(), n2); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "dot_product_scalar", n2, n2 * 2 * sizeof(float), 2.0 * n2,
+            [&] { sink = scalar.dot_f32(w.fa.data(), w.fb.data(), n2); } }, options.bench));
+
+        results.push_back(simd::run_benchmark({ "count_substring_intrinsics", bytes, bytes, 0,
+            [&] { sink = float(table.count_substring(w.str.data(), bytes, substr, substr_len, {})); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "count_substring_scalar", bytes, bytes, 0,
+            [&] { sink = float(scalar.count_substring(w.str.data(), bytes, substr, substr_len, {})); } }, options.bench));
+    }
+
+    // Скалярне множення з обходом B по стовпцях на великих матрицях займає секунди, тож розміри обмежені
+    for (size_t n = 128; n <= std::min<size_t>(options.max_gemm, 512); n *= 2) {
+        const double flops = 2.0 * n * n * n;
+        const size_t bytes = 3 * n * n * sizeof(float);
+        results.push_back(simd::run_benchmark({ "matmul_intrinsics", n * n, bytes, flops,
+            [&] { simd::sgemm_baseline(n, w.ma.data(), w.mb.data(), w.mc.data()); } }, options.bench));
+        results.push_back(simd::run_benchmark({ "matmul_scalar", n * n, bytes, flops,
+            [&] { matmul_scalar(n, w.ma.data(), w.mb.data(), w.mc.data()); } }, options.bench));
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return 2;
+    }
+    if (!options.search_path.empty()) {
+        return search_file(options);
+    }
+
+    std::mt19937 generator(std::random_device{}());
+    Workload workload;
+    fill_workload(workload, options.max_bytes, options.max_gemm, generator);
+    workload.file_path = (std::filesystem::temp_directory_path() / "simd_bench_search.txt").string();
+    if (!std::ofstream(workload.file_path, std::ios::binary).write(workload.str.data(), workload.str.size())) {
+        workload.file_path.clear();
+    }
+
+    std::cerr << "Best supported tier: " << simd::tier_name(simd::max_supported_tier()) << std::endl;
+    std::cerr << "Active tier: " << simd::tier_name(simd::active_tier()) << std::endl;
+    std::cerr << "Last-level cache: " << (simd::cpu_features().llc_bytes >> 10) << " KiB, streaming stores from "
+              << (simd::streaming_threshold() >> 10) << " KiB" << std::endl;
+    std::string counters_error;
+    if (!options.bench.counters) {
+        std::cerr << "Performance counters: disabled" << std::endl;
+    }
+    else if (simd::perf_counters_supported(&counters_error)) {
+        std::cerr << "Performance counters: cycles, instructions, ref-cycles, L1D and LLC misses" << std::endl;
+    }
+    else {
+        std::cerr << "Performance counters: unavailable, " << counters_error << "; reporting time only" << std::endl;
+    }
+
+    // Спершу перевіряємо правильність на всіх підтримуваних рівнях
+    const simd::CpuTier active = simd::active_tier();
+    bool ok = true;
+    float deterministic_dot = NAN;
+    for (int t = 0; t <= static_cast<int>(simd::max_supported_tier()); ++t) {
+        simd::set_tier(static_cast<simd::CpuTier>(t));
+        std::cerr << "--- " << simd::tier_name(simd::active_tier()) << " ---" << std::endl;
+        ok &= verify_tier(workload, generator, deterministic_dot);
+    }
+    simd::set_tier(active);
+    std::cerr << "--- task1-task5 (intrinsics: " << simd::tier_name(active) << ") ---" << std::endl;
+    const bool task_ok = check_task_kernels(workload);
+    ok &= task_ok;
+    report(task_ok, "task1-task5 kernels");
+
+    std::vector<simd::BenchmarkResult> results;
+    for (int t = 0; t <= static_cast<int>(simd::max_supported_tier()); ++t) {
+        const simd::CpuTier tier = static_cast<simd::CpuTier>(t);
+        if (!options.all_tiers && tier != active) {
+            continue;
+        }
+        simd::set_tier(tier);
+        run_sweep(workload, options, results);
+        run_scaling(workload, options, results);
+    }
+    simd::set_tier(active);
+    run_task_comparison(workload, options, results);
+    if (!workload.file_path.empty()) {
+        std::remove(workload.file_path.c_str());
+    }
+
+    std::ofstream file;
+    if (!options.out_path.empty()) {
+        file.open(options.out_path);
+    }
+    std::ostream& out = options.out_path.empty() ? std::cout : file;
+    simd::write_report(out, results, options.format);
+    if (options.roofline && options.format == simd::ReportFormat::Text) {
+        out << "\n";
+        simd::write_roofline(out, results, simd::estimate_roofline(results));
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+﻿#include "benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+#include "kernels.h"
+#include "perf_counters.h"
+
+namespace simd {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ns(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+// Значення перцентиля p (0..1) з відсортованого масиву (найближчий ранг)
+double percentile(const std::vector<double>& sorted, double p) {
+    const size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank ? rank - 1 : 0)];
+}
+
+// Екранування рядка для JSON (назви ядер прості, але лапки й \ все одно обробляємо)
+std::string json_string(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out + "\"";
+}
+
+// Значення для CSV (порожнє, якщо NaN) і JSON (null)
+std::string csv_number(double value) {
+    if (std::isnan(value)) {
+        return std::string();
+    }
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+std::string json_number(double value) {
+    return std::isnan(value) ? std::string("null") : csv_number(value);
+}
+
+// Метрика лічильника для текстового звіту: "-", якщо недоступна
+void write_metric(std::ostream& out, int width, double value, int precision) {
+    if (std::isnan(value) || std::isinf(value)) {
+        out << std::setw(width) << "-";
+    }
+    else {
+        out << std::fixed << std::setprecision(precision) << std::setw(width) << value;
+        out.unsetf(std::ios::floatfield);
+    }
+}
+
+}  // namespace
+
+BenchmarkResult run_benchmark(const BenchmarkCase& bench, const BenchmarkOptions& options) {
+    BenchmarkResult result;
+    result.kernel = bench.kernel;
+    result.tier = tier_name(active_tier());
+    result.elements = bench.elements;
+    result.bytes = bench.bytes;
+    result.flops = bench.flops;
+
+    // Прогрів: перші дотики до сторінок, заповнення кешів і TLB, запуск потоків пулу
+    double warm_ns = 0;
+    for (size_t i = 0; i < std::max<size_t>(options.warmup_runs, 1); ++i) {
+        const Clock::time_point start = Clock::now();
+        bench.func();
+        warm_ns = elapsed_ns(start, Clock::now());
+    }
+
+    // Коротке ядро повторюємо, щоб вимірювання було значно довшим за роздільність таймера
+    size_t iterations = 1;
+    if (warm_ns < options.min_trial_ns) {
+        iterations = static_cast<size_t>(options.min_trial_ns / std::max(warm_ns, 1.0)) + 1;
+    }
+    result.iterations = iterations;
+
+    std::vector<double> samples;
+    samples.reserve(options.trials);
+    std::unique_ptr<PerfCounters> counters;
+    if (options.counters && perf_counters_supported()) {
+        counters.reset(new PerfCounters());
+        counters->start();
+    }
+    const Clock::time_point begin = Clock::now();
+    for (size_t trial = 0; trial < options.trials; ++trial) {
+        const Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            bench.func();
+        }
+        const Clock::time_point end = Clock::now();
+        samples.push_back(elapsed_ns(start, end) / iterations);
+
+        if (samples.size() >= 3 && elapsed_ns(begin, end) * 1e-9 > options.max_total_s) {
+            break;
+        }
+    }
+
+    if (counters) {
+        const CounterValues values = counters->stop();
+        const double calls = static_cast<double>(samples.size() * iterations);
+        result.cycles = values[Counter::Cycles] / calls;
+        result.instructions = values[Counter::Instructions] / calls;
+        result.ref_cycles = values[Counter::RefCycles] / calls;
+        result.l1d_misses = values[Counter::L1dMisses] / calls;
+        result.llc_misses = values[Counter::LlcMisses] / calls;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    result.trials = samples.size();
+    result.min_ns = samples.front();
+    result.median_ns = percentile(samples, 0.5);
+    result.p99_ns = percentile(samples, 0.99);
+    double sum = 0;
+    for (double s : samples) {
+        sum += s;
+    }
+    result.mean_ns = sum / samples.size();
+    return result;
+}
+
+std::vector<size_t> sweep_working_sets(size_t max_bytes) {
+    std::vector<size_t> sizes;
+    for (size_t bytes = 16 * 1024; bytes <= max_bytes; bytes *= 4) {
+        sizes.push_back(bytes);
+    }
+    return sizes;
+}
+
+bool parse_report_format(const std::string& name, ReportFormat& format) {
+    if (name == "text") {
+        format = ReportFormat::Text;
+    }
+    else if (name == "csv") {
+        format = ReportFormat::Csv;
+    }
+    else if (name == "json") {
+        format = ReportFormat::Json;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+void write_report(std::ostream& out, const std::vector<BenchmarkResult>& results, ReportFormat format) {
+    switch (format) {
+    case ReportFormat::Text:
+        out << std::left << std::setw(32) << "kernel" << std::setw(8) << "tier"
+            << std::right << std::setw(12) << "elements" << std::setw(14) << "median_ns"
+            << std::setw(14) << "min_ns" << std::setw(14) << "p99_ns"
+            << std::setw(10) << "GB/s" << std::setw(12) << "Melem/s" << std::setw(10) << "GFLOP/s" << "\n";
+        for (const BenchmarkResult& r : results) {
+            out << std::left << std::setw(32) << r.kernel << std::setw(8) << r.tier
+                << std::right << std::setw(12) << r.elements
+                << std::fixed << std::setprecision(1)
+                << std::setw(14) << r.median_ns << std::setw(14) << r.min_ns << std::setw(14) << r.p99_ns
+                << std::setprecision(2)
+                << std::setw(10) << r.gb_per_s() << std::setw(12) << r.elements_per_s() * 1e-6
+                << std::setw(10) << r.gflop_per_s() << "\n";
+            out.unsetf(std::ios::floatfield);
+        }
+        break;
+
+    case ReportFormat::Csv:
+        out << "kernel,tier,elements,bytes,flops,trials,iterations,min_ns,median_ns,p99_ns,mean_ns,"
+               "gb_per_s,elements_per_s,gflop_per_s,cycles,instructions,ref_cycles,l1d_misses,llc_misses\n";
+        for (const BenchmarkResult& r : results) {
+            out << r.kernel << ',' << r.tier << ',' << r.elements << ',' << r.bytes << ',' << r.flops << ','
+                << r.trials << ',' << r.iterations << ',' << r.min_ns << ',' << r.median_ns << ','
+                << r.p99_ns << ',' << r.mean_ns << ',' << r.gb_per_s() << ',' << r.elements_per_s() << ','
+                << r.gflop_per_s() << ',' << csv_number(r.cycles) << ',' << csv_number(r.instructions) << ','
+                << csv_number(r.ref_cycles) << ',' << csv_number(r.l1d_misses) << ',' << csv_number(r.llc_misses) << "\n";
+        }
+        break;
+
+    case ReportFormat::Json:
+        out << "[\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchmarkResult& r = results[i];
+            out << "  {\"kernel\": " << json_string(r.kernel) << ", \"tier\": " << json_string(r.tier)
+                << ", \"elements\": " << r.elements << ", \"bytes\": " << r.bytes << ", \"flops\": " << r.flops
+                << ", \"trials\": " << r.trials << ", \"iterations\": " << r.iterations
+                << ", \"min_ns\": " << r.min_ns << ", \"median_ns\": " << r.median_ns
+                << ", \"p99_ns\": " << r.p99_ns << ", \"mean_ns\": " << r.mean_ns
+                << ", \"gb_per_s\": " << r.gb_per_s() << ", \"elements_per_s\": " << r.elements_per_s()
+                << ", \"gflop_per_s\": " << r.gflop_per_s() << ", \"cycles\": " << json_number(r.cycles)
+                << ", \"instructions\": " << json_number(r.instructions) << ", \"ref_cycles\": " << json_number(r.ref_cycles)
+                << ", \"l1d_misses\": " << json_number(r.l1d_misses) << ", \"llc_misses\": " << json_number(r.llc_misses)
+                << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "]\n";
+        break;
+    }
+}
+
+double Roofline::bandwidth_for(size_t bytes) const {
+    for (const BandwidthCeiling& ceiling : bandwidth) {
+        if (bytes <= ceiling.max_bytes) {
+            return ceiling.gb_per_s;
+        }
+    }
+    return bandwidth.empty() ? 0 : bandwidth.back().gb_per_s;
+}
+
+Roofline estimate_roofline(const std::vector<BenchmarkResult>& results) {
+    Roofline roofline;
+    for (const BenchmarkResult& r : results) {
+        roofline.peak_gflop_per_s = std::max(roofline.peak_gflop_per_s, r.gflop_per_s());
+        if (r.bytes == 0) {
+            continue;
+        }
+        // Діапазон (4^(k-1), 4^k]: ядра одного кроку розгортки читають трохи менше за його розмір
+        size_t max_bytes = 1;
+        while (max_bytes < r.bytes) {
+            max_bytes *= 4;
+        }
+        auto it = std::find_if(roofline.bandwidth.begin(), roofline.bandwidth.end(),
+                               [&](const BandwidthCeiling& c) { return c.max_bytes >= max_bytes; });
+        if (it == roofline.bandwidth.end() || it->max_bytes != max_bytes) {
+            it = roofline.bandwidth.insert(it, { max_bytes, 0 });
+        }
+        it->gb_per_s = std::max(it->gb_per_s, r.gb_per_s());
+    }
+    // Менший набір лежить не нижче в ієрархії пам'яті, тож його стеля не нижча
+    for (size_t i = roofline.bandwidth.size(); i-- > 1;) {
+        roofline.bandwidth[i - 1].gb_per_s = std::max(roofline.bandwidth[i - 1].gb_per_s, roofline.bandwidth[i].gb_per_s);
+    }
+    return roofline;
+}
+
+RooflinePoint classify(const BenchmarkResult& result, const Roofline& roofline) {
+    RooflinePoint point;
+    const double bandwidth = roofline.bandwidth_for(result.bytes);
+    if (result.flops > 0 && result.bytes > 0) {
+        point.intensity = result.flops / result.bytes;
+        const double memory_roof = point.intensity * bandwidth;
+        point.bound = memory_roof < roofline.peak_gflop_per_s ? Bound::Memory : Bound::Compute;
+        point.roof = std::min(memory_roof, roofline.peak_gflop_per_s);
+        point.efficiency = point.roof > 0 ? result.gflop_per_s() / point.roof : 0;
+    }
+    else {
+        point.roof = bandwidth;
+        point.efficiency = bandwidth > 0 ? result.gb_per_s() / bandwidth : 0;
+        point.bound = point.efficiency >= 0.5 ? Bound::Memory : Bound::Compute;
+    }
+    return point;
+}
+
+void write_roofline(std::ostream& out, const std::vector<BenchmarkResult>& results, const Roofline& roofline) {
+    out << std::fixed << std::setprecision(2) << "roofline: peak " << roofline.peak_gflop_per_s << " GFLOP/s; bandwidth, GB/s:";
+    for (const BandwidthCeiling& ceiling : roofline.bandwidth) {
+        out << " " << ceiling.gb_per_s << " (<= " << (ceiling.max_bytes >> 10) << " KiB)";
+    }
+    out << "\n";
+    out.unsetf(std::ios::floatfield);
+    out << std::left << std::setw(32) << "kernel" << std::setw(8) << "tier"
+        << std::right << std::setw(12) << "elements" << std::setw(9) << "FLOP/B" << std::setw(10) << "roof"
+        << std::setw(8) << "%roof" << std::setw(9) << "bound" << std::setw(7) << "IPC" << std::setw(9) << "B/cyc"
+        << std::setw(10) << "FLOP/cyc" << std::setw(10) << "L1D/KiB" << std::setw(10) << "LLC/KiB" << std::setw(7) << "freq" << "\n";
+    for (const BenchmarkResult& r : results) {
+        const RooflinePoint point = classify(r, roofline);
+        const double kib = r.bytes / 1024.0;
+        out << std::left << std::setw(32) << r.kernel << std::setw(8) << r.tier << std::right << std::setw(12) << r.elements;
+        write_metric(out, 9, point.intensity, 3);
+        write_metric(out, 10, point.roof, 1);
+        write_metric(out, 8, point.efficiency * 100, 1);
+        out << std::setw(9) << (point.bound == Bound::Memory ? "memory" : "compute");
+        write_metric(out, 7, r.ipc(), 2);
+        write_metric(out, 9, r.bytes_per_cycle(), 2);
+        write_metric(out, 10, r.flops > 0 ? r.flops_per_cycle() : NAN, 2);
+        write_metric(out, 10, r.l1d_misses / kib, 2);
+        write_metric(out, 10, r.llc_misses / kib, 2);
+        write_metric(out, 7, r.frequency_ratio(), 2);
+        out << "\n";
+    }
+}
+
+}  // namespace simd
@@ -0,0 +1,119 @@
+﻿#pragma once
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace simd {
+
+// Параметри одного вимірювання
+struct BenchmarkOptions {
+    size_t warmup_runs = 3;        // Прогони до вимірювань (прогрів кешів, сторінок, пулу потоків)
+    size_t trials = 25;            // Кількість вимірювань
+    double min_trial_ns = 50000;   // Коротке ядро повторюється в межах вимірювання, доки воно не триває стільки
+    double max_total_s = 2.0;      // Повільне ядро зупиняється раніше, але не менше ніж після 3 вимірювань
+    bool counters = true;          // Збирати апаратні лічильники (perf_counters.h), якщо вони доступні
+};
+
+// Результат вимірювання одного ядра на одному розмірі. Часи — на один виклик ядра.
+struct BenchmarkResult {
+    std::string kernel;
+    std::string tier;
+    size_t elements = 0;           // Елементів на виклик
+    size_t bytes = 0;              // Байтів, прочитаних і записаних за виклик
+    double flops = 0;              // Операцій з плаваючою комою за виклик (0, якщо не має сенсу)
+    size_t trials = 0;
+    size_t iterations = 0;         // Викликів у межах одного вимірювання
+    double min_ns = 0;
+    double median_ns = 0;
+    double p99_ns = 0;
+    double mean_ns = 0;
+
+    // Апаратні лічильники на один виклик, усереднені за всі вимірювання й сумарні по всіх потоках;
+    // NaN, якщо лічильник недоступний
+    double cycles = NAN;
+    double instructions = NAN;
+    double ref_cycles = NAN;
+    double l1d_misses = NAN;
+    double llc_misses = NAN;
+
+    double gb_per_s() const { return median_ns > 0 ? bytes / median_ns : 0; }
+    double elements_per_s() const { return median_ns > 0 ? elements / median_ns * 1e9 : 0; }
+    double gflop_per_s() const { return median_ns > 0 ? flops / median_ns : 0; }
+
+    // Похідні від лічильників (NaN без них)
+    double ipc() const { return instructions / cycles; }
+    double bytes_per_cycle() const { return bytes / cycles; }
+    double flops_per_cycle() const { return flops / cycles; }
+    double frequency_ratio() const { return cycles / ref_cycles; }  // < 1 — ядро працювало нижче номінальної частоти
+};
+
+// Опис вимірюваного ядра: func виконує рівно один виклик
+struct BenchmarkCase {
+    std::string kernel;
+    size_t elements = 0;
+    size_t bytes = 0;
+    double flops = 0;
+    std::function<void()> func;
+};
+
+// Прогріває ядро, підбирає кількість повторів і збирає статистику min/median/p99. Якщо options.counters
+// і лічильники доступні, усі вимірювання разом рахуються апаратними лічильниками (див. perf_counters.h).
+BenchmarkResult run_benchmark(const BenchmarkCase& bench, const BenchmarkOptions& options);
+
+// Розміри робочого набору від L1 (16 КіБ) до max_bytes, крок x4
+std::vector<size_t> sweep_working_sets(size_t max_bytes);
+
+enum class ReportFormat { Text, Csv, Json };
+
+// Розбирає "text", "csv" або "json"
+bool parse_report_format(const std::string& name, ReportFormat& format);
+
+// Друкує результати у вибраному форматі (CSV і JSON — для відстеження регресій між релізами).
+// CSV і JSON містять і лічильники: недоступні — порожнє поле в CSV, null у JSON.
+void write_report(std::ostream& out, const std::vector<BenchmarkResult>& results, ReportFormat format);
+
+// Стеля пропускної здатності для робочих наборів до max_bytes байтів
+struct BandwidthCeiling {
+    size_t max_bytes = 0;
+    double gb_per_s = 0;
+};
+
+// Стелі моделі roofline: найбільша обчислювальна швидкість і пропускна здатність для кожного
+// діапазону розмірів робочого набору (рівні ієрархії пам'яті від L1 до DRAM), за зростанням max_bytes
+struct Roofline {
+    double peak_gflop_per_s = 0;
+    std::vector<BandwidthCeiling> bandwidth;
+
+    // Стеля для робочого набору bytes: перший діапазон, що його вміщає (останній — для більших)
+    double bandwidth_for(size_t bytes) const;
+};
+
+// Емпіричні стелі: найкращі виміряні значення серед results. Обчислювальна — найбільша GFLOP/s
+// (зазвичай sgemm); пропускна здатність — найбільша GB/s серед наборів того самого розміру з точністю
+// до кроку розгортки (x4), не нижча, ніж для більших наборів. Стелі не нижчі за жоден результат, тож
+// кожне ядро опиняється під дахом; оцінювати їх варто з повної розгортки.
+Roofline estimate_roofline(const std::vector<BenchmarkResult>& results);
+
+enum class Bound { Memory, Compute };
+
+// Положення ядра відносно стель
+struct RooflinePoint {
+    double intensity = 0;  // FLOP на байт (0 для ядер без операцій з плаваючою комою)
+    double roof = 0;       // Досяжна швидкість: GFLOP/s, а для ядер без flops — GB/s
+    double efficiency = 0;  // Досягнута частка roof
+    Bound bound = Bound::Memory;
+};
+
+// Ядро з flops > 0 обмежене пам'яттю, якщо intensity менша за ridge = peak_gflop_per_s / bandwidth_for(bytes),
+// інакше — обчисленнями. Для ядер без flops інтенсивність невідома: обмеженим пам'яттю вважається ядро,
+// що досягло щонайменше половини стелі пропускної здатності, інакше — виконанням інструкцій (Compute).
+RooflinePoint classify(const BenchmarkResult& result, const Roofline& roofline);
+
+// Текстовий звіт roofline: інтенсивність, стеля, частка стелі, класифікація й метрики лічильників
+// (IPC, байти й FLOP за такт, промахи L1D і LLC на КіБ даних, відносна частота)
+void write_roofline(std::ostream& out, const std::vector<BenchmarkResult>& results, const Roofline& roofline);
+
+}  // namespace simd
@@ -0,0 +1,45 @@
+﻿#pragma once
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Переносні бітові операції для обходу масок, отриманих через movemask
+namespace simd {
+
+// Індекс наймолодшого встановленого біта (mask != 0)
+inline unsigned ctz32(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+// Індекс наймолодшого встановленого біта (mask != 0)
+inline unsigned ctz64(uint64_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+// Кількість встановлених бітів. У MSVC __popcnt64 вимагає POPCNT, тож там — порозрядне додавання.
+inline unsigned popcount64(uint64_t mask) {
+#if defined(_MSC_VER)
+    mask -= (mask >> 1) & 0x5555555555555555ull;
+    mask = (mask & 0x3333333333333333ull) + ((mask >> 2) & 0x3333333333333333ull);
+    mask = (mask + (mask >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<unsigned>((mask * 0x0101010101010101ull) >> 56);
+#else
+    return static_cast<unsigned>(__builtin_popcountll(mask));
+#endif
+}
+
+}  // namespace simd
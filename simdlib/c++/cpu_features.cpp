@@ -0,0 +1,201 @@
+﻿#include "cpu_features.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>    // Для __cpuidex і _xgetbv
+#else
+#include <cpuid.h>     // Для __cpuid_count
+#endif
+
+namespace simd {
+
+namespace {
+
+// Виконує інструкцію cpuid для заданих leaf/subleaf
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<uint32_t>(r[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Читає регістр XCR0, щоб дізнатися, які регістрові стани зберігає ОС
+uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+}
+
+bool bit(uint32_t value, int index) {
+    return (value >> index) & 1u;
+}
+
+// Найбільший кеш даних найвищого рівня з детермінованих параметрів кешу (leaf 4 або 0x8000001D).
+// Кожен subleaf описує один кеш: тип у EAX[4:0] (0 — кінець списку), рівень у EAX[7:5],
+// розмір = асоціативність * розділи * рядок * кількість наборів.
+size_t last_level_cache(uint32_t leaf) {
+    uint32_t r[4];
+    size_t bytes = 0;
+    uint32_t best_level = 0;
+    for (uint32_t subleaf = 0; subleaf < 16; ++subleaf) {
+        cpuid(leaf, subleaf, r);
+        const uint32_t type = r[0] & 0x1F;
+        if (type == 0) {
+            break;
+        }
+        if (type == 2) {
+            continue;  // Кеш інструкцій
+        }
+        const uint32_t level = (r[0] >> 5) & 0x7;
+        const size_t size = static_cast<size_t>((r[1] >> 22) + 1) * (((r[1] >> 12) & 0x3FF) + 1) *
+                            ((r[1] & 0xFFF) + 1) * (static_cast<size_t>(r[2]) + 1);
+        if (level > best_level || (level == best_level && size > bytes)) {
+            best_level = level;
+            bytes = size;
+        }
+    }
+    return bytes;
+}
+
+CpuFeatures detect() {
+    CpuFeatures f;
+    uint32_t r[4];
+
+    cpuid(0, 0, r);
+    const uint32_t max_leaf = r[0];
+    const bool amd = r[2] == 0x444D4163 || r[2] == 0x656E6975;  // "cAMD" (AuthenticAMD), "uine" (HygonGenuine)
+    if (max_leaf < 1) {
+        return f;
+    }
+
+    cpuid(1, 0, r);
+    f.pclmul = bit(r[2], 1);
+    f.sse42 = bit(r[2], 20);
+    f.popcnt = bit(r[2], 23);
+    f.fma = bit(r[2], 12);
+    const bool osxsave = bit(r[2], 27);
+    f.avx = bit(r[2], 28);
+    f.f16c = bit(r[2], 29);
+
+    // AVX-стан можна використовувати лише якщо ОС увімкнула XSAVE для XMM/YMM
+    if (osxsave) {
+        const uint64_t xcr0 = xgetbv0();
+        f.os_ymm = (xcr0 & 0x6) == 0x6;
+        f.os_zmm = (xcr0 & 0xE6) == 0xE6;  // XMM, YMM, opmask, ZMM_Hi256, Hi16_ZMM
+    }
+
+    if (max_leaf >= 7) {
+        cpuid(7, 0, r);
+        f.bmi1 = bit(r[1], 3);
+        f.avx2 = bit(r[1], 5);
+        f.bmi2 = bit(r[1], 8);
+        f.avx512f = bit(r[1], 16);
+        f.avx512dq = bit(r[1], 17);
+        f.avx512bw = bit(r[1], 30);
+        f.avx512vl = bit(r[1], 31);
+        f.avx512_vnni = bit(r[2], 11);
+        if (r[0] >= 1) {  // EAX — найбільший subleaf
+            cpuid(7, 1, r);
+            f.avx_vnni = bit(r[0], 4);
+            f.avx512_bf16 = bit(r[0], 5);
+        }
+    }
+
+    if (amd) {
+        cpuid(0x80000000, 0, r);
+        if (r[0] >= 0x8000001D) {
+            cpuid(0x80000001, 0, r);
+            if (bit(r[2], 22)) {  // TOPOEXT: є leaf 0x8000001D
+                f.llc_bytes = last_level_cache(0x8000001D);
+            }
+        }
+    }
+    else if (max_leaf >= 4) {
+        f.llc_bytes = last_level_cache(4);
+    }
+
+    return f;
+}
+
+}  // namespace
+
+const CpuFeatures& cpu_features() {
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+CpuTier max_supported_tier() {
+    const CpuFeatures& f = cpu_features();
+    if (f.os_zmm && f.avx512f && f.avx512bw && f.avx512vl && f.avx512dq &&
+        f.avx2 && f.fma && f.bmi1 && f.bmi2 && f.f16c && f.pclmul) {
+        return CpuTier::AVX512;
+    }
+    if (f.os_ymm && f.avx && f.avx2 && f.fma && f.bmi1 && f.bmi2 && f.f16c && f.pclmul) {
+        return CpuTier::AVX2;
+    }
+    if (f.sse42 && f.popcnt) {
+        return CpuTier::SSE42;
+    }
+    return CpuTier::Scalar;
+}
+
+const char* tier_name(CpuTier tier) {
+    switch (tier) {
+    case CpuTier::Scalar: return "scalar";
+    case CpuTier::SSE42: return "sse4.2";
+    case CpuTier::AVX2: return "avx2";
+    case CpuTier::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+bool parse_tier(const char* name, CpuTier& tier) {
+    if (!name) {
+        return false;
+    }
+
+    // Приводимо назву до нижнього регістру й відкидаємо крапки ("SSE4.2" == "sse42")
+    char normalized[16];
+    size_t n = 0;
+    for (const char* p = name; *p; ++p) {
+        if (*p == '.') {
+            continue;
+        }
+        if (n + 1 >= sizeof(normalized)) {
+            return false;
+        }
+        normalized[n++] = static_cast<char>(std::tolower(static_cast<unsigned char>(*p)));
+    }
+    normalized[n] = '\0';
+
+    if (std::strcmp(normalized, "scalar") == 0) {
+        tier = CpuTier::Scalar;
+    }
+    else if (std::strcmp(normalized, "sse42") == 0) {
+        tier = CpuTier::SSE42;
+    }
+    else if (std::strcmp(normalized, "avx2") == 0) {
+        tier = CpuTier::AVX2;
+    }
+    else if (std::strcmp(normalized, "avx512") == 0) {
+        tier = CpuTier::AVX512;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+}  // namespace simd
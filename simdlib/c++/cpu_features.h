@@ -0,0 +1,51 @@
+﻿#pragma once
+#include <cstddef>
+
+namespace simd {
+
+// Рівні набору інструкцій, між якими обирає диспетчер (у порядку зростання)
+enum class CpuTier {
+    Scalar = 0,  // Лише базовий x86-64 (SSE2), ручної векторизації немає
+    SSE42 = 1,   // 128-бітні регістри, SSE4.2 + POPCNT
+    AVX2 = 2,    // 256-бітні регістри, AVX2 + FMA + BMI1/BMI2 + F16C + PCLMUL
+    AVX512 = 3   // 512-бітні регістри, AVX-512 F/BW/VL/DQ
+};
+
+// Можливості процесора, визначені через cpuid/xgetbv
+struct CpuFeatures {
+    bool sse42 = false;
+    bool popcnt = false;
+    bool avx = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool bmi1 = false;
+    bool bmi2 = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512vl = false;
+    bool avx512dq = false;
+    bool f16c = false;         // Перетворення half <-> float (vcvtph2ps/vcvtps2ph)
+    bool pclmul = false;       // Множення без переносів (pclmulqdq)
+    bool avx_vnni = false;     // vpdpbusd на YMM у VEX-кодуванні
+    bool avx512_vnni = false;  // vpdpbusd на ZMM
+    bool avx512_bf16 = false;  // vdpbf16ps, vcvtne2ps2bf16
+    bool os_ymm = false;  // ОС зберігає YMM-стан при перемиканні контексту
+    bool os_zmm = false;  // ОС зберігає ZMM- та opmask-стан
+
+    // Розмір кешу останнього рівня в байтах (leaf 4 на Intel, 0x8000001D на AMD); 0 — невідомо
+    size_t llc_bytes = 0;
+};
+
+// Повертає можливості процесора (визначаються один раз при першому виклику)
+const CpuFeatures& cpu_features();
+
+// Найвищий рівень, який підтримують і процесор, і операційна система
+CpuTier max_supported_tier();
+
+// Назва рівня: "scalar", "sse4.2", "avx2", "avx512"
+const char* tier_name(CpuTier tier);
+
+// Розбирає назву рівня (без урахування регістру); повертає false для невідомої назви
+bool parse_tier(const char* name, CpuTier& tier);
+
+}  // namespace simd
@@ -0,0 +1,85 @@
+﻿#include "elementwise.h"
+
+#include "elementwise_internal.h"
+#include "kernels.h"
+
+namespace simd {
+
+namespace {
+
+const TypedKernels<int8_t>& typed(const ElementwiseTable& table, const int8_t*) { return table.i8; }
+const TypedKernels<int16_t>& typed(const ElementwiseTable& table, const int16_t*) { return table.i16; }
+const TypedKernels<int32_t>& typed(const ElementwiseTable& table, const int32_t*) { return table.i32; }
+const TypedKernels<int64_t>& typed(const ElementwiseTable& table, const int64_t*) { return table.i64; }
+const TypedKernels<float>& typed(const ElementwiseTable& table, const float*) { return table.f32; }
+const TypedKernels<double>& typed(const ElementwiseTable& table, const double*) { return table.f64; }
+
+template <typename T>
+const TypedKernels<T>& active(const T* tag) {
+    return typed(elementwise_kernels(), tag);
+}
+
+}  // namespace
+
+const ElementwiseTable& elementwise_kernels_for(CpuTier tier) {
+    switch (tier) {
+    case CpuTier::AVX512: return avx512_elementwise;
+    case CpuTier::AVX2: return avx2_elementwise;
+    case CpuTier::SSE42: return sse42_elementwise;
+    default: return scalar_elementwise;
+    }
+}
+
+// Рівень той самий, що й у kernels(): SIMDLIB_TIER і set_tier діють на обидві таблиці
+const ElementwiseTable& elementwise_kernels() {
+    return elementwise_kernels_for(active_tier());
+}
+
+template <typename T>
+void add(const T* a, const T* b, T* result, size_t size) {
+    active(a).add(a, b, result, size);
+}
+
+template <typename T>
+void sub(const T* a, const T* b, T* result, size_t size) {
+    active(a).sub(a, b, result, size);
+}
+
+template <typename T>
+void mul(const T* a, const T* b, T* result, size_t size) {
+    active(a).mul(a, b, result, size);
+}
+
+template <typename T>
+void min(const T* a, const T* b, T* result, size_t size) {
+    active(a).min(a, b, result, size);
+}
+
+template <typename T>
+void max(const T* a, const T* b, T* result, size_t size) {
+    active(a).max(a, b, result, size);
+}
+
+template <typename T>
+void fma(const T* a, const T* b, const T* c, T* result, size_t size) {
+    active(a).fma(a, b, c, result, size);
+}
+
+#define SIMDLIB_INSTANTIATE_ELEMENTWISE(T)                                  \
+    template void add<T>(const T*, const T*, T*, size_t);                   \
+    template void sub<T>(const T*, const T*, T*, size_t);                   \
+    template void mul<T>(const T*, const T*, T*, size_t);                   \
+    template void min<T>(const T*, const T*, T*, size_t);                   \
+    template void max<T>(const T*, const T*, T*, size_t);                   \
+    template void fma<T>(const T*, const T*, const T*, T*, size_t);
+
+SIMDLIB_INSTANTIATE_ELEMENTWISE(int8_t)
+SIMDLIB_INSTANTIATE_ELEMENTWISE(int16_t)
+SIMDLIB_INSTANTIATE_ELEMENTWISE(int32_t)
+SIMDLIB_INSTANTIATE_ELEMENTWISE(int64_t)
+SIMDLIB_INSTANTIATE_ELEMENTWISE(float)
+SIMDLIB_INSTANTIATE_ELEMENTWISE(double)
+
+#undef SIMDLIB_INSTANTIATE_ELEMENTWISE
+
+}  // namespace simd
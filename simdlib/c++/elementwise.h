@@ -0,0 +1,50 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu_features.h"
+
+namespace simd {
+
+// Поелементні операції над одним типом елементів. Реалізація кожного рівня — шаблон,
+// специфікований для типу під час компіляції, тож новий тип не потребує окремого ядра.
+template <typename T>
+struct TypedKernels {
+    void (*add)(const T* a, const T* b, T* result, size_t size);
+    void (*sub)(const T* a, const T* b, T* result, size_t size);
+    void (*mul)(const T* a, const T* b, T* result, size_t size);
+    void (*min)(const T* a, const T* b, T* result, size_t size);
+    void (*max)(const T* a, const T* b, T* result, size_t size);
+    void (*fma)(const T* a, const T* b, const T* c, T* result, size_t size);
+};
+
+// Таблиця поелементних ядер одного рівня для всіх підтримуваних типів
+struct ElementwiseTable {
+    CpuTier tier;
+    TypedKernels<int8_t> i8;
+    TypedKernels<int16_t> i16;
+    TypedKernels<int32_t> i32;
+    TypedKernels<int64_t> i64;
+    TypedKernels<float> f32;
+    TypedKernels<double> f64;
+};
+
+// Таблиця активного рівня (див. kernels()) і таблиця конкретного рівня
+const ElementwiseTable& elementwise_kernels();
+const ElementwiseTable& elementwise_kernels_for(CpuTier tier);
+
+// Типізовані операції для T = int8_t, int16_t, int32_t, int64_t, float, double (інші типи не інстанційовано).
+// Цілі числа переповнюються за модулем 2^n. min/max для дійсних: a < b ? a : b і a > b ? a : b
+// (з NaN повертається b, як у minps/maxps). fma на рівнях AVX2 і AVX-512 округлює дійсні один раз,
+// на scalar і SSE4.2 — двічі. Залишок, коротший за регістр, на AVX-512 обробляється маскованими
+// завантаженнями й записами, на AVX2 — vpmaskmov для 32- і 64-бітних елементів; без масок (SSE4.2,
+// 8- і 16-бітні на AVX2) — останнім повним регістром, що перекривається з попереднім. Скалярного циклу
+// залишку немає. result може збігатися з a, b чи c, але не може частково з ними перекриватися.
+template <typename T> void add(const T* a, const T* b, T* result, size_t size);
+template <typename T> void sub(const T* a, const T* b, T* result, size_t size);
+template <typename T> void mul(const T* a, const T* b, T* result, size_t size);
+template <typename T> void min(const T* a, const T* b, T* result, size_t size);
+template <typename T> void max(const T* a, const T* b, T* result, size_t size);
+template <typename T> void fma(const T* a, const T* b, const T* c, T* result, size_t size);
+
+}  // namespace simd
@@ -0,0 +1,238 @@
+﻿#include <immintrin.h>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "elementwise_internal.h"
+
+#include "target_avx2.h"
+
+// Реалізації на 256-бітних регістрах. Залишок 32- і 64-бітних елементів читається й пишеться
+// vpmaskmov/vmaskmov (масковані елементи не читаються й не викликають помилок сторінки);
+// для 8- і 16-бітних таких інструкцій немає, тож їхній залишок — перекривний повний регістр (див. binary).
+namespace simd {
+
+namespace {
+
+struct IntVec {
+    using reg = __m256i;
+    static reg load(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+    static void store(void* p, reg v) { _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+};
+
+// Залишок через буфер: tail — кількість байтів
+struct BufferTail {
+    using tail = size_t;
+    static tail tail_of(size_t bytes) { return bytes; }
+    static __m256i load_tail(const void* p, tail bytes) {
+        alignas(32) uint8_t buffer[32] = {};
+        memcpy(buffer, p, bytes);
+        return _mm256_load_si256(reinterpret_cast<const __m256i*>(buffer));
+    }
+    static void store_tail(void* p, tail bytes, __m256i v) {
+        alignas(32) uint8_t buffer[32];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(buffer), v);
+        memcpy(p, buffer, bytes);
+    }
+};
+
+// Маски залишку: старший біт елемента встановлено для перших remaining елементів
+__m256i mask_32(size_t bytes) {
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(bytes / 4)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+__m256i mask_64(size_t bytes) {
+    return _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(bytes / 8)), _mm256_setr_epi64x(0, 1, 2, 3));
+}
+
+template <typename T> struct Vec;
+
+template <>
+struct Vec<int8_t> : IntVec, BufferTail {
+    static reg add(reg a, reg b) { return _mm256_add_epi8(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_epi8(a, b); }
+    // Множення 8-бітних немає: парні й непарні байти множаться як 16-бітні, молодші байти добутків зливаються
+    static reg mul(reg a, reg b) {
+        const reg even = _mm256_mullo_epi16(a, b);
+        const reg odd = _mm256_mullo_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+        return _mm256_or_si256(_mm256_and_si256(even, _mm256_set1_epi16(0x00FF)), _mm256_slli_epi16(odd, 8));
+    }
+    static reg min(reg a, reg b) { return _mm256_min_epi8(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_epi8(a, b); }
+};
+
+template <>
+struct Vec<int16_t> : IntVec, BufferTail {
+    static reg add(reg a, reg b) { return _mm256_add_epi16(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_epi16(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mullo_epi16(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_epi16(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_epi16(a, b); }
+};
+
+template <>
+struct Vec<int32_t> : IntVec {
+    using tail = __m256i;
+    static tail tail_of(size_t bytes) { return mask_32(bytes); }
+    static reg load_tail(const int32_t* p, tail m) { return _mm256_maskload_epi32(reinterpret_cast<const int*>(p), m); }
+    static void store_tail(int32_t* p, tail m, reg v) { _mm256_maskstore_epi32(reinterpret_cast<int*>(p), m, v); }
+    static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_epi32(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mullo_epi32(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+};
+
+template <>
+struct Vec<int64_t> : IntVec {
+    using tail = __m256i;
+    static tail tail_of(size_t bytes) { return mask_64(bytes); }
+    static reg load_tail(const int64_t* p, tail m) {
+        return _mm256_maskload_epi64(reinterpret_cast<const long long*>(p), m);
+    }
+    static void store_tail(int64_t* p, tail m, reg v) { _mm256_maskstore_epi64(reinterpret_cast<long long*>(p), m, v); }
+    static reg add(reg a, reg b) { return _mm256_add_epi64(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_epi64(a, b); }
+    // Молодші 64 біти добутку з 32-бітних половин: lo * lo + ((hi * lo + lo * hi) << 32)
+    static reg mul(reg a, reg b) {
+        const reg low = _mm256_mul_epu32(a, b);
+        const reg cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                           _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+        return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+    }
+    static reg min(reg a, reg b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+    static reg max(reg a, reg b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+};
+
+template <>
+struct Vec<float> {
+    using reg = __m256;
+    using tail = __m256i;
+    static reg load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, reg v) { _mm256_storeu_ps(p, v); }
+    static tail tail_of(size_t bytes) { return mask_32(bytes); }
+    static reg load_tail(const float* p, tail m) { return _mm256_maskload_ps(p, m); }
+    static void store_tail(float* p, tail m, reg v) { _mm256_maskstore_ps(p, m, v); }
+    static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+};
+
+template <>
+struct Vec<double> {
+    using reg = __m256d;
+    using tail = __m256i;
+    static reg load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, reg v) { _mm256_storeu_pd(p, v); }
+    static tail tail_of(size_t bytes) { return mask_64(bytes); }
+    static reg load_tail(const double* p, tail m) { return _mm256_maskload_pd(p, m); }
+    static void store_tail(double* p, tail m, reg v) { _mm256_maskstore_pd(p, m, v); }
+    static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+};
+
+struct AddOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::add(a, b); }
+};
+struct SubOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::sub(a, b); }
+};
+struct MulOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::mul(a, b); }
+};
+struct MinOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::min(a, b); }
+};
+struct MaxOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::max(a, b); }
+};
+
+// Цілочисельне FMA — множення й додавання; дійсне — vfmadd з одним округленням
+template <typename V, typename = void>
+struct Fused {
+    static typename V::reg apply(typename V::reg a, typename V::reg b, typename V::reg c) {
+        return V::add(V::mul(a, b), c);
+    }
+};
+template <typename V>
+struct Fused<V, decltype(void(&V::fma))> {
+    static typename V::reg apply(typename V::reg a, typename V::reg b, typename V::reg c) { return V::fma(a, b, c); }
+};
+
+// Для 8- і 16-бітних елементів (BufferTail) масив із щонайменше одного регістра закінчується перекривним
+// повним регістром: він рахується до основного циклу й записується після нього, тож читає ще не перезаписані
+// входи навіть тоді, коли result збігається з одним із них. Через буфер іде лише масив, коротший за регістр.
+template <typename Op, typename T>
+void binary(const T* a, const T* b, T* result, size_t size) {
+    using V = Vec<T>;
+    const size_t lanes = 32 / sizeof(T);
+    if (std::is_base_of<BufferTail, V>::value && size >= lanes) {
+        const size_t last = size - lanes;
+        const typename V::reg tail = Op::template apply<V>(V::load(a + last), V::load(b + last));
+        for (size_t i = 0; i + lanes <= size; i += lanes) {
+            V::store(result + i, Op::template apply<V>(V::load(a + i), V::load(b + i)));
+        }
+        V::store(result + last, tail);
+        return;
+    }
+    size_t i = 0;
+    for (; i + lanes <= size; i += lanes) {
+        V::store(result + i, Op::template apply<V>(V::load(a + i), V::load(b + i)));
+    }
+    if (i < size) {
+        const typename V::tail t = V::tail_of((size - i) * sizeof(T));
+        V::store_tail(result + i, t, Op::template apply<V>(V::load_tail(a + i, t), V::load_tail(b + i, t)));
+    }
+}
+
+template <typename T>
+void fma_kernel(const T* a, const T* b, const T* c, T* result, size_t size) {
+    using V = Vec<T>;
+    const size_t lanes = 32 / sizeof(T);
+    if (std::is_base_of<BufferTail, V>::value && size >= lanes) {
+        const size_t last = size - lanes;
+        const typename V::reg tail = Fused<V>::apply(V::load(a + last), V::load(b + last), V::load(c + last));
+        for (size_t i = 0; i + lanes <= size; i += lanes) {
+            V::store(result + i, Fused<V>::apply(V::load(a + i), V::load(b + i), V::load(c + i)));
+        }
+        V::store(result + last, tail);
+        return;
+    }
+    size_t i = 0;
+    for (; i + lanes <= size; i += lanes) {
+        V::store(result + i, Fused<V>::apply(V::load(a + i), V::load(b + i), V::load(c + i)));
+    }
+    if (i < size) {
+        const typename V::tail t = V::tail_of((size - i) * sizeof(T));
+        V::store_tail(result + i, t, Fused<V>::apply(V::load_tail(a + i, t), V::load_tail(b + i, t), V::load_tail(c + i, t)));
+    }
+}
+
+template <typename T>
+constexpr TypedKernels<T> typed() {
+    return { binary<AddOp, T>, binary<SubOp, T>, binary<MulOp, T>,
+             binary<MinOp, T>, binary<MaxOp, T>, fma_kernel<T> };
+}
+
+}  // namespace
+
+const ElementwiseTable avx2_elementwise = {
+    CpuTier::AVX2,
+    typed<int8_t>(),
+    typed<int16_t>(),
+    typed<int32_t>(),
+    typed<int64_t>(),
+    typed<float>(),
+    typed<double>(),
+};
+
+}  // namespace simd
+
+#include "target_end.h"
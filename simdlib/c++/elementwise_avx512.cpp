@@ -0,0 +1,189 @@
+﻿#include <immintrin.h>
+#include <cstdint>
+
+#include "elementwise_internal.h"
+
+#include "target_avx512.h"
+
+// Реалізації на 512-бітних регістрах. Залишок будь-якого типу читається й пишеться з маскою
+// (AVX-512BW для 8- і 16-бітних елементів), тож короткий масив — один маскований прохід.
+namespace simd {
+
+namespace {
+
+struct IntVec {
+    using reg = __m512i;
+    static reg load(const void* p) { return _mm512_loadu_si512(p); }
+    static void store(void* p, reg v) { _mm512_storeu_si512(p, v); }
+};
+
+template <typename T> struct Vec;
+
+template <>
+struct Vec<int8_t> : IntVec {
+    using tail = __mmask64;
+    static tail tail_of(size_t remaining) { return static_cast<__mmask64>((1ull << remaining) - 1); }
+    static reg load_tail(const int8_t* p, tail m) { return _mm512_maskz_loadu_epi8(m, p); }
+    static void store_tail(int8_t* p, tail m, reg v) { _mm512_mask_storeu_epi8(p, m, v); }
+    static reg add(reg a, reg b) { return _mm512_add_epi8(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_epi8(a, b); }
+    // Множення 8-бітних немає: парні й непарні байти множаться як 16-бітні, молодші байти добутків зливаються
+    static reg mul(reg a, reg b) {
+        const reg even = _mm512_mullo_epi16(a, b);
+        const reg odd = _mm512_mullo_epi16(_mm512_srli_epi16(a, 8), _mm512_srli_epi16(b, 8));
+        return _mm512_mask_blend_epi8(0xAAAAAAAAAAAAAAAAull, even, _mm512_slli_epi16(odd, 8));
+    }
+    static reg min(reg a, reg b) { return _mm512_min_epi8(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_epi8(a, b); }
+};
+
+template <>
+struct Vec<int16_t> : IntVec {
+    using tail = __mmask32;
+    static tail tail_of(size_t remaining) { return static_cast<__mmask32>((1u << remaining) - 1); }
+    static reg load_tail(const int16_t* p, tail m) { return _mm512_maskz_loadu_epi16(m, p); }
+    static void store_tail(int16_t* p, tail m, reg v) { _mm512_mask_storeu_epi16(p, m, v); }
+    static reg add(reg a, reg b) { return _mm512_add_epi16(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_epi16(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mullo_epi16(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_epi16(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_epi16(a, b); }
+};
+
+template <>
+struct Vec<int32_t> : IntVec {
+    using tail = __mmask16;
+    static tail tail_of(size_t remaining) { return static_cast<__mmask16>((1u << remaining) - 1); }
+    static reg load_tail(const int32_t* p, tail m) { return _mm512_maskz_loadu_epi32(m, p); }
+    static void store_tail(int32_t* p, tail m, reg v) { _mm512_mask_storeu_epi32(p, m, v); }
+    static reg add(reg a, reg b) { return _mm512_add_epi32(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_epi32(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mullo_epi32(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_epi32(a, b); }
+};
+
+template <>
+struct Vec<int64_t> : IntVec {
+    using tail = __mmask8;
+    static tail tail_of(size_t remaining) { return static_cast<__mmask8>((1u << remaining) - 1); }
+    static reg load_tail(const int64_t* p, tail m) { return _mm512_maskz_loadu_epi64(m, p); }
+    static void store_tail(int64_t* p, tail m, reg v) { _mm512_mask_storeu_epi64(p, m, v); }
+    static reg add(reg a, reg b) { return _mm512_add_epi64(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_epi64(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mullo_epi64(a, b); }  // AVX-512DQ
+    static reg min(reg a, reg b) { return _mm512_min_epi64(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_epi64(a, b); }
+};
+
+template <>
+struct Vec<float> {
+    using reg = __m512;
+    using tail = __mmask16;
+    static reg load(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, reg v) { _mm512_storeu_ps(p, v); }
+    static tail tail_of(size_t remaining) { return static_cast<__mmask16>((1u << remaining) - 1); }
+    static reg load_tail(const float* p, tail m) { return _mm512_maskz_loadu_ps(m, p); }
+    static void store_tail(float* p, tail m, reg v) { _mm512_mask_storeu_ps(p, m, v); }
+    static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_ps(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+};
+
+template <>
+struct Vec<double> {
+    using reg = __m512d;
+    using tail = __mmask8;
+    static reg load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, reg v) { _mm512_storeu_pd(p, v); }
+    static tail tail_of(size_t remaining) { return static_cast<__mmask8>((1u << remaining) - 1); }
+    static reg load_tail(const double* p, tail m) { return _mm512_maskz_loadu_pd(m, p); }
+    static void store_tail(double* p, tail m, reg v) { _mm512_mask_storeu_pd(p, m, v); }
+    static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_pd(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+};
+
+struct AddOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::add(a, b); }
+};
+struct SubOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::sub(a, b); }
+};
+struct MulOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::mul(a, b); }
+};
+struct MinOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::min(a, b); }
+};
+struct MaxOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::max(a, b); }
+};
+
+// Цілочисельне FMA — множення й додавання; дійсне — vfmadd з одним округленням
+template <typename V, typename = void>
+struct Fused {
+    static typename V::reg apply(typename V::reg a, typename V::reg b, typename V::reg c) {
+        return V::add(V::mul(a, b), c);
+    }
+};
+template <typename V>
+struct Fused<V, decltype(void(&V::fma))> {
+    static typename V::reg apply(typename V::reg a, typename V::reg b, typename V::reg c) { return V::fma(a, b, c); }
+};
+
+template <typename Op, typename T>
+void binary(const T* a, const T* b, T* result, size_t size) {
+    using V = Vec<T>;
+    const size_t lanes = 64 / sizeof(T);
+    size_t i = 0;
+    for (; i + lanes <= size; i += lanes) {
+        V::store(result + i, Op::template apply<V>(V::load(a + i), V::load(b + i)));
+    }
+    if (i < size) {
+        const typename V::tail m = V::tail_of(size - i);
+        V::store_tail(result + i, m, Op::template apply<V>(V::load_tail(a + i, m), V::load_tail(b + i, m)));
+    }
+}
+
+template <typename T>
+void fma_kernel(const T* a, const T* b, const T* c, T* result, size_t size) {
+    using V = Vec<T>;
+    const size_t lanes = 64 / sizeof(T);
+    size_t i = 0;
+    for (; i + lanes <= size; i += lanes) {
+        V::store(result + i, Fused<V>::apply(V::load(a + i), V::load(b + i), V::load(c + i)));
+    }
+    if (i < size) {
+        const typename V::tail m = V::tail_of(size - i);
+        V::store_tail(result + i, m, Fused<V>::apply(V::load_tail(a + i, m), V::load_tail(b + i, m), V::load_tail(c + i, m)));
+    }
+}
+
+template <typename T>
+constexpr TypedKernels<T> typed() {
+    return { binary<AddOp, T>, binary<SubOp, T>, binary<MulOp, T>,
+             binary<MinOp, T>, binary<MaxOp, T>, fma_kernel<T> };
+}
+
+}  // namespace
+
+const ElementwiseTable avx512_elementwise = {
+    CpuTier::AVX512,
+    typed<int8_t>(),
+    typed<int16_t>(),
+    typed<int32_t>(),
+    typed<int64_t>(),
+    typed<float>(),
+    typed<double>(),
+};
+
+}  // namespace simd
+
+#include "target_end.h"
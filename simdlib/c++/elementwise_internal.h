@@ -0,0 +1,12 @@
+﻿#pragma once
+#include "elementwise.h"
+
+// Таблиці, визначені в elementwise_<рівень>.cpp. Використовуються лише диспетчером.
+namespace simd {
+
+extern const ElementwiseTable scalar_elementwise;
+extern const ElementwiseTable sse42_elementwise;
+extern const ElementwiseTable avx2_elementwise;
+extern const ElementwiseTable avx512_elementwise;
+
+}  // namespace simd
@@ -0,0 +1,78 @@
+﻿#include <cstdint>
+#include <type_traits>
+
+#include "elementwise_internal.h"
+
+// Еталонні реалізації без ручної векторизації. Цілі рахуються в беззнаковому типі щонайменше
+// розміру unsigned: переповнення за модулем 2^n без невизначеної поведінки знакового переповнення.
+namespace simd {
+
+namespace {
+
+template <typename T, bool Integral = std::is_integral<T>::value>
+struct Scalar {
+    using U = typename std::conditional<(sizeof(T) < sizeof(unsigned)), unsigned,
+                                        typename std::make_unsigned<T>::type>::type;
+    static T add(T a, T b) { return static_cast<T>(static_cast<U>(a) + static_cast<U>(b)); }
+    static T sub(T a, T b) { return static_cast<T>(static_cast<U>(a) - static_cast<U>(b)); }
+    static T mul(T a, T b) { return static_cast<T>(static_cast<U>(a) * static_cast<U>(b)); }
+    static T fma(T a, T b, T c) { return add(mul(a, b), c); }
+};
+
+template <typename T>
+struct Scalar<T, false> {
+    static T add(T a, T b) { return a + b; }
+    static T sub(T a, T b) { return a - b; }
+    static T mul(T a, T b) { return a * b; }
+    static T fma(T a, T b, T c) { return a * b + c; }  // Два округлення, як і в SSE4.2
+};
+
+struct AddOp {
+    template <typename T> static T apply(T a, T b) { return Scalar<T>::add(a, b); }
+};
+struct SubOp {
+    template <typename T> static T apply(T a, T b) { return Scalar<T>::sub(a, b); }
+};
+struct MulOp {
+    template <typename T> static T apply(T a, T b) { return Scalar<T>::mul(a, b); }
+};
+struct MinOp {
+    template <typename T> static T apply(T a, T b) { return a < b ? a : b; }
+};
+struct MaxOp {
+    template <typename T> static T apply(T a, T b) { return a > b ? a : b; }
+};
+
+template <typename Op, typename T>
+void binary(const T* a, const T* b, T* result, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = Op::apply(a[i], b[i]);
+    }
+}
+
+template <typename T>
+void fma_kernel(const T* a, const T* b, const T* c, T* result, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = Scalar<T>::fma(a[i], b[i], c[i]);
+    }
+}
+
+template <typename T>
+constexpr TypedKernels<T> typed() {
+    return { binary<AddOp, T>, binary<SubOp, T>, binary<MulOp, T>,
+             binary<MinOp, T>, binary<MaxOp, T>, fma_kernel<T> };
+}
+
+}  // namespace
+
+const ElementwiseTable scalar_elementwise = {
+    CpuTier::Scalar,
+    typed<int8_t>(),
+    typed<int16_t>(),
+    typed<int32_t>(),
+    typed<int64_t>(),
+    typed<float>(),
+    typed<double>(),
+};
+
+}  // namespace simd
@@ -0,0 +1,186 @@
+﻿#include <immintrin.h>
+#include <cstdint>
+#include <cstring>
+
+#include "elementwise_internal.h"
+
+#include "target_sse42.h"
+
+// Реалізації на 128-бітних регістрах. Маскованих завантажень у SSE немає: залишок рахується
+// перекривним повним регістром (див. binary), а масив, коротший за регістр, — через буфер на стеку.
+namespace simd {
+
+namespace {
+
+struct IntVec {
+    using reg = __m128i;
+    static reg load(const void* p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+    static void store(void* p, reg v) { _mm_storeu_si128(static_cast<__m128i*>(p), v); }
+    static reg load_tail(const void* p, size_t bytes) {
+        alignas(16) uint8_t buffer[16] = {};
+        memcpy(buffer, p, bytes);
+        return _mm_load_si128(reinterpret_cast<const __m128i*>(buffer));
+    }
+    static void store_tail(void* p, size_t bytes, reg v) {
+        alignas(16) uint8_t buffer[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(buffer), v);
+        memcpy(p, buffer, bytes);
+    }
+};
+
+template <typename T> struct Vec;
+
+template <>
+struct Vec<int8_t> : IntVec {
+    static reg add(reg a, reg b) { return _mm_add_epi8(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_epi8(a, b); }
+    // Множення 8-бітних немає: парні й непарні байти множаться як 16-бітні, молодші байти добутків зливаються
+    static reg mul(reg a, reg b) {
+        const reg even = _mm_mullo_epi16(a, b);
+        const reg odd = _mm_mullo_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+        return _mm_or_si128(_mm_and_si128(even, _mm_set1_epi16(0x00FF)), _mm_slli_epi16(odd, 8));
+    }
+    static reg min(reg a, reg b) { return _mm_min_epi8(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_epi8(a, b); }
+};
+
+template <>
+struct Vec<int16_t> : IntVec {
+    static reg add(reg a, reg b) { return _mm_add_epi16(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_epi16(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mullo_epi16(a, b); }
+    static reg min(reg a, reg b) { return _mm_min_epi16(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_epi16(a, b); }
+};
+
+template <>
+struct Vec<int32_t> : IntVec {
+    static reg add(reg a, reg b) { return _mm_add_epi32(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_epi32(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mullo_epi32(a, b); }
+    static reg min(reg a, reg b) { return _mm_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_epi32(a, b); }
+};
+
+template <>
+struct Vec<int64_t> : IntVec {
+    static reg add(reg a, reg b) { return _mm_add_epi64(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_epi64(a, b); }
+    // Молодші 64 біти добутку з 32-бітних половин: lo * lo + ((hi * lo + lo * hi) << 32)
+    static reg mul(reg a, reg b) {
+        const reg low = _mm_mul_epu32(a, b);
+        const reg cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b), _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+        return _mm_add_epi64(low, _mm_slli_epi64(cross, 32));
+    }
+    static reg min(reg a, reg b) { return _mm_blendv_epi8(a, b, _mm_cmpgt_epi64(a, b)); }
+    static reg max(reg a, reg b) { return _mm_blendv_epi8(b, a, _mm_cmpgt_epi64(a, b)); }
+};
+
+template <>
+struct Vec<float> {
+    using reg = __m128;
+    static reg load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, reg v) { _mm_storeu_ps(p, v); }
+    static reg load_tail(const float* p, size_t bytes) { return _mm_castsi128_ps(IntVec::load_tail(p, bytes)); }
+    static void store_tail(float* p, size_t bytes, reg v) { IntVec::store_tail(p, bytes, _mm_castps_si128(v)); }
+    static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+};
+
+template <>
+struct Vec<double> {
+    using reg = __m128d;
+    static reg load(const double* p) { return _mm_loadu_pd(p); }
+    static void store(double* p, reg v) { _mm_storeu_pd(p, v); }
+    static reg load_tail(const double* p, size_t bytes) { return _mm_castsi128_pd(IntVec::load_tail(p, bytes)); }
+    static void store_tail(double* p, size_t bytes, reg v) { IntVec::store_tail(p, bytes, _mm_castpd_si128(v)); }
+    static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+    static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+};
+
+struct AddOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::add(a, b); }
+};
+struct SubOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::sub(a, b); }
+};
+struct MulOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::mul(a, b); }
+};
+struct MinOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::min(a, b); }
+};
+struct MaxOp {
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::max(a, b); }
+};
+
+// Масив із щонайменше одного регістра: останній неповний регістр рахується як повний регістр, що закінчується
+// на size, до основного циклу й записується після нього — так він читає ще не перезаписані входи навіть
+// тоді, коли result збігається з одним із них. Коротший масив рахується одним регістром через буфер.
+template <typename Op, typename T>
+void binary(const T* a, const T* b, T* result, size_t size) {
+    using V = Vec<T>;
+    const size_t lanes = 16 / sizeof(T);
+    if (size < lanes) {
+        const size_t bytes = size * sizeof(T);
+        V::store_tail(result, bytes, Op::template apply<V>(V::load_tail(a, bytes), V::load_tail(b, bytes)));
+        return;
+    }
+    const size_t last = size - lanes;
+    const typename V::reg tail = Op::template apply<V>(V::load(a + last), V::load(b + last));
+    for (size_t i = 0; i + lanes <= size; i += lanes) {
+        V::store(result + i, Op::template apply<V>(V::load(a + i), V::load(b + i)));
+    }
+    V::store(result + last, tail);
+}
+
+// FMA на цьому рівні немає: множення й додавання з двома округленнями
+template <typename T>
+typename Vec<T>::reg multiply_add(typename Vec<T>::reg a, typename Vec<T>::reg b, typename Vec<T>::reg c) {
+    return Vec<T>::add(Vec<T>::mul(a, b), c);
+}
+
+template <typename T>
+void fma_kernel(const T* a, const T* b, const T* c, T* result, size_t size) {
+    using V = Vec<T>;
+    const size_t lanes = 16 / sizeof(T);
+    if (size < lanes) {
+        const size_t bytes = size * sizeof(T);
+        V::store_tail(result, bytes, multiply_add<T>(V::load_tail(a, bytes), V::load_tail(b, bytes), V::load_tail(c, bytes)));
+        return;
+    }
+    const size_t last = size - lanes;
+    const typename V::reg tail = multiply_add<T>(V::load(a + last), V::load(b + last), V::load(c + last));
+    for (size_t i = 0; i + lanes <= size; i += lanes) {
+        V::store(result + i, multiply_add<T>(V::load(a + i), V::load(b + i), V::load(c + i)));
+    }
+    V::store(result + last, tail);
+}
+
+template <typename T>
+constexpr TypedKernels<T> typed() {
+    return { binary<AddOp, T>, binary<SubOp, T>, binary<MulOp, T>,
+             binary<MinOp, T>, binary<MaxOp, T>, fma_kernel<T> };
+}
+
+}  // namespace
+
+const ElementwiseTable sse42_elementwise = {
+    CpuTier::SSE42,
+    typed<int8_t>(),
+    typed<int16_t>(),
+    typed<int32_t>(),
+    typed<int64_t>(),
+    typed<float>(),
+    typed<double>(),
+};
+
+}  // namespace simd
+
+#include "target_end.h"
@@ -0,0 +1,297 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "kernels.h"
+#include "parallel.h"
+#include "thread_pool.h"
+
+// Ліниві поелементні вирази над масивами float. Вираз на кшталт (a + b) * c + 2.0f лише будує дерево
+// вузлів; обчислення (evaluate, dot, sum) проходить масиви один раз блоками по BLOCK елементів.
+// Проміжні результати блоку лежать у буфері на стеку й не виходять з L1, тож з пам'яті читаються
+// лише входи й пишеться лише результат: для k злитих операцій трафік падає приблизно в k разів
+// порівняно з послідовними викликами add_vectors / multiply_vectors через тимчасові масиви.
+// Кожна операція блоку виконується диспетчеризованим ядром активного рівня (kernels()).
+//
+//     using namespace simd::expr;
+//     evaluate(result, (vec(a, n) + vec(b, n)) * vec(c, n));
+//     float d = dot(vec(a, n) * 0.5f, vec(b, n) + vec(c, n));
+//
+// Вузли зберігають листки за значенням, а масиви — за покажчиком: вираз можна зберегти й обчислити
+// пізніше, поки живуть масиви. Порядок і округлення операцій ті самі, що й у поелементних ядрах,
+// тож evaluate дає побітово той самий результат, що й ланцюжок окремих викликів.
+namespace simd {
+namespace expr {
+
+// Елементів у блоці: 4 КіБ на кожен проміжний результат
+const size_t BLOCK = 1024;
+
+// Блоків на одне завдання пулу (256 КіБ кожного масиву)
+const size_t BLOCKS_PER_TASK = 64;
+
+// Розмір виразу без масивів (лише скаляри) — не обмежений
+const size_t UNBOUNDED = SIZE_MAX;
+
+// Спільна довжина двох операндів. Масиви різної довжини — помилка виклику, а не обрізання до коротшого:
+// кидає std::invalid_argument у будь-якій збірці
+inline size_t merge_size(size_t a, size_t b) {
+    if (a != UNBOUNDED && b != UNBOUNDED && a != b) {
+        throw std::invalid_argument("simd::expr: operand lengths differ");
+    }
+    return a < b ? a : b;
+}
+
+// Довжина виразу, який обчислюється: вираз лише зі скалярів не має довжини
+inline size_t checked_size(size_t size) {
+    if (size == UNBOUNDED) {
+        throw std::invalid_argument("simd::expr: expression has no arrays");
+    }
+    return size;
+}
+
+// Кожен вузол має:
+//   temps  — скільки блоків проміжного буфера потрібно його піддереву;
+//   arrays — скільки масивів воно читає;
+//   prepare(scratch)                       — одноразова підготовка буфера перед серією блоків;
+//   eval(table, begin, n, scratch)         — покажчик на n значень, починаючи з елемента begin;
+//   eval_to(table, begin, n, scratch, out) — те саме, але запис у out (корінь пише одразу в результат).
+
+// Масив-листок: eval не копіює, а повертає покажчик у сам масив
+struct Vec {
+    static constexpr size_t temps = 0;
+    static constexpr size_t arrays = 1;
+
+    const float* data;
+    size_t length;
+
+    size_t size() const { return length; }
+    void prepare(float*) const {}
+    const float* eval(const KernelTable&, size_t begin, size_t, float*) const { return data + begin; }
+    void eval_to(const KernelTable&, size_t begin, size_t n, float*, float* out) const {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = data[begin + i];
+        }
+    }
+};
+
+// Скаляр, розмножений на весь блок. Блок заповнюється один раз у prepare
+struct Broadcast {
+    static constexpr size_t temps = 1;
+    static constexpr size_t arrays = 0;
+
+    float value;
+
+    size_t size() const { return UNBOUNDED; }
+    void prepare(float* scratch) const {
+        for (size_t i = 0; i < BLOCK; ++i) {
+            scratch[i] = value;
+        }
+    }
+    const float* eval(const KernelTable&, size_t, size_t, float* scratch) const { return scratch; }
+    void eval_to(const KernelTable&, size_t, size_t n, float*, float* out) const {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = value;
+        }
+    }
+};
+
+struct AddOp {
+    static void apply(const KernelTable& table, const float* a, const float* b, float* out, size_t n) {
+        table.add_f32(a, b, out, n);
+    }
+};
+
+struct MulOp {
+    static void apply(const KernelTable& table, const float* a, const float* b, float* out, size_t n) {
+        table.mul_f32(a, b, out, n);
+    }
+};
+
+// Буфер піддерева: спершу блоки лівого операнда, потім правого, останній — власний результат вузла
+template <typename Op, typename L, typename R>
+struct Binary {
+    static constexpr size_t temps = L::temps + R::temps + 1;
+    static constexpr size_t arrays = L::arrays + R::arrays;
+
+    L left;
+    R right;
+
+    size_t size() const { return merge_size(left.size(), right.size()); }
+    void prepare(float* scratch) const {
+        left.prepare(scratch);
+        right.prepare(scratch + L::temps * BLOCK);
+    }
+    const float* eval(const KernelTable& table, size_t begin, size_t n, float* scratch) const {
+        float* out = scratch + (temps - 1) * BLOCK;
+        eval_to(table, begin, n, scratch, out);
+        return out;
+    }
+    void eval_to(const KernelTable& table, size_t begin, size_t n, float* scratch, float* out) const {
+        const float* x = left.eval(table, begin, n, scratch);
+        const float* y = right.eval(table, begin, n, scratch + L::temps * BLOCK);
+        Op::apply(table, x, y, out, n);
+    }
+};
+
+// a * b + c через fma_f32 (одне округлення на рівнях з FMA)
+template <typename A, typename B, typename C>
+struct Fma {
+    static constexpr size_t temps = A::temps + B::temps + C::temps + 1;
+    static constexpr size_t arrays = A::arrays + B::arrays + C::arrays;
+
+    A a;
+    B b;
+    C c;
+
+    size_t size() const { return merge_size(merge_size(a.size(), b.size()), c.size()); }
+    void prepare(float* scratch) const {
+        a.prepare(scratch);
+        b.prepare(scratch + A::temps * BLOCK);
+        c.prepare(scratch + (A::temps + B::temps) * BLOCK);
+    }
+    const float* eval(const KernelTable& table, size_t begin, size_t n, float* scratch) const {
+        float* out = scratch + (temps - 1) * BLOCK;
+        eval_to(table, begin, n, scratch, out);
+        return out;
+    }
+    void eval_to(const KernelTable& table, size_t begin, size_t n, float* scratch, float* out) const {
+        const float* x = a.eval(table, begin, n, scratch);
+        const float* y = b.eval(table, begin, n, scratch + A::temps * BLOCK);
+        const float* z = c.eval(table, begin, n, scratch + (A::temps + B::temps) * BLOCK);
+        table.fma_f32(x, y, z, out, n);
+    }
+};
+
+template <typename T> struct is_expression : std::false_type {};
+template <> struct is_expression<Vec> : std::true_type {};
+template <> struct is_expression<Broadcast> : std::true_type {};
+template <typename Op, typename L, typename R> struct is_expression<Binary<Op, L, R>> : std::true_type {};
+template <typename A, typename B, typename C> struct is_expression<Fma<A, B, C>> : std::true_type {};
+
+// Операнд виразу: вузол як є, число — як Broadcast
+template <typename T, typename = void> struct operand;
+template <typename T>
+struct operand<T, typename std::enable_if<is_expression<T>::value>::type> {
+    using type = T;
+    static const T& wrap(const T& value) { return value; }
+};
+template <typename T>
+struct operand<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+    using type = Broadcast;
+    static Broadcast wrap(T value) { return Broadcast{static_cast<float>(value)}; }
+};
+
+template <typename L, typename R>
+using enable_binary = typename std::enable_if<
+    (is_expression<L>::value || is_expression<R>::value) &&
+    (is_expression<L>::value || std::is_arithmetic<L>::value) &&
+    (is_expression<R>::value || std::is_arithmetic<R>::value)>::type;
+
+inline Vec vec(const float* data, size_t size) { return Vec{data, size}; }
+inline Vec vec(const std::vector<float>& data) { return Vec{data.data(), data.size()}; }
+
+template <typename L, typename R, typename = enable_binary<L, R>>
+Binary<AddOp, typename operand<L>::type, typename operand<R>::type> operator+(const L& left, const R& right) {
+    return {operand<L>::wrap(left), operand<R>::wrap(right)};
+}
+
+template <typename L, typename R, typename = enable_binary<L, R>>
+Binary<MulOp, typename operand<L>::type, typename operand<R>::type> operator*(const L& left, const R& right) {
+    return {operand<L>::wrap(left), operand<R>::wrap(right)};
+}
+
+// Явне злиття: a * b + c без двох окремих округлень. Звичайне a * b + c лишається двома операціями,
+// щоб результат не залежав від того, чи записано вираз ліниво.
+template <typename A, typename B, typename C>
+Fma<typename operand<A>::type, typename operand<B>::type, typename operand<C>::type>
+fma(const A& a, const B& b, const C& c) {
+    return {operand<A>::wrap(a), operand<B>::wrap(b), operand<C>::wrap(c)};
+}
+
+namespace detail {
+
+template <size_t Temps>
+struct Scratch {
+    alignas(64) float data[(Temps > 0 ? Temps : 1) * BLOCK];
+};
+
+// Викликає fn(table, begin, end, scratch) для відрізків по BLOCKS_PER_TASK блоків; task — номер відрізка.
+// Малі вирази рахуються в потоці, що викликав, великі — в default_pool().
+template <typename E, typename Fn>
+void for_each_task(const E& e, size_t size, size_t arrays, Fn fn) {
+    const KernelTable& table = kernels();
+    const size_t task_size = BLOCK * BLOCKS_PER_TASK;
+    const size_t tasks = (size + task_size - 1) / task_size;
+    auto run = [&](size_t first, size_t last) {
+        Scratch<E::temps> scratch;
+        e.prepare(scratch.data);
+        for (size_t task = first; task < last; ++task) {
+            fn(table, task, task * task_size, size < (task + 1) * task_size ? size : (task + 1) * task_size,
+               scratch.data);
+        }
+    };
+    ThreadPool& pool = default_pool();
+    if (size * sizeof(float) * arrays < PARALLEL_MIN_BYTES || pool.size() == 1) {
+        run(0, tasks);
+        return;
+    }
+    pool.parallel_for(tasks, 1, run);
+}
+
+}  // namespace detail
+
+// result[i] = e[i] для всіх i < e.size(). result може збігатися з одним із масивів виразу
+// (кожен блок читається до того, як у нього пишеться), але не може частково з ним перекриватися.
+// Якщо довжини масивів різні або масивів немає, кидає std::invalid_argument і нічого не пише.
+template <typename E, typename = typename std::enable_if<is_expression<E>::value>::type>
+void evaluate(float* result, const E& e) {
+    const size_t size = checked_size(e.size());
+    detail::for_each_task(e, size, E::arrays + 1, [&](const KernelTable& table, size_t, size_t begin, size_t end,
+                                                        float* scratch) {
+        for (size_t i = begin; i < end; i += BLOCK) {
+            const size_t n = end - i < BLOCK ? end - i : BLOCK;
+            e.eval_to(table, i, n, scratch, result + i);
+        }
+    });
+}
+
+// sum x[i] * y[i] за один прохід без збереження x і y. Кожен блок рахується dot_f32 (як DotMode::Fast),
+// суми блоків накопичуються в double у порядку індексів, тож результат не залежить від кількості потоків.
+// Різні довжини операндів — std::invalid_argument, як і в evaluate.
+template <typename X, typename Y,
+          typename = typename std::enable_if<is_expression<X>::value && is_expression<Y>::value>::type>
+float dot(const X& x, const Y& y) {
+    const size_t size = checked_size(merge_size(x.size(), y.size()));
+    // Один буфер на обидва операнди: спершу блоки x, потім y
+    const Binary<MulOp, X, Y> both{x, y};
+    const size_t task_size = BLOCK * BLOCKS_PER_TASK;
+    std::vector<double> partial((size + task_size - 1) / task_size, 0.0);
+    detail::for_each_task(both, size, X::arrays + Y::arrays, [&](const KernelTable& table, size_t task,
+                                                                   size_t begin, size_t end, float* scratch) {
+        double acc = 0.0;
+        for (size_t i = begin; i < end; i += BLOCK) {
+            const size_t n = end - i < BLOCK ? end - i : BLOCK;
+            const float* px = x.eval(table, i, n, scratch);
+            const float* py = y.eval(table, i, n, scratch + X::temps * BLOCK);
+            acc += table.dot_f32(px, py, n);
+        }
+        partial[task] = acc;
+    });
+    double total = 0.0;
+    for (double value : partial) {
+        total += value;
+    }
+    return static_cast<float>(total);
+}
+
+// sum e[i]
+template <typename E, typename = typename std::enable_if<is_expression<E>::value>::type>
+float sum(const E& e) {
+    return dot(e, Broadcast{1.0f});
+}
+
+}  // namespace expr
+}  // namespace simd
@@ -0,0 +1,170 @@
+﻿#include "file_search.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SIMDLIB_POSIX_FILES 1
+#else
+#include <fstream>
+#endif
+
+#include "kernels.h"
+#include "thread_pool.h"
+
+namespace simd {
+
+namespace {
+
+// Розбиття файлу на шматки: шматок i відповідає початковим позиціям [i * chunk, (i + 1) * chunk),
+// а читається з перекриттям substr_len - 1 байтів, щоб захопити збіги, які перетинають межу
+struct ChunkPlan {
+    uint64_t file_size = 0;
+    uint64_t chunk = 0;
+    size_t count = 0;
+    size_t overlap = 0;
+
+    uint64_t offset(size_t i) const { return i * chunk; }
+    size_t length(size_t i) const {
+        return static_cast<size_t>(std::min<uint64_t>(chunk + overlap, file_size - offset(i)));
+    }
+};
+
+ChunkPlan plan_chunks(uint64_t file_size, size_t substr_len, size_t chunk_bytes, size_t page) {
+    ChunkPlan plan;
+    plan.file_size = file_size;
+    plan.overlap = substr_len - 1;
+    // Зміщення mmap мають бути кратні сторінці
+    plan.chunk = (std::max(chunk_bytes, page) + page - 1) / page * page;
+    const uint64_t starts = file_size - substr_len + 1;
+    plan.count = static_cast<size_t>((starts + plan.chunk - 1) / plan.chunk);
+    return plan;
+}
+
+#ifdef SIMDLIB_POSIX_FILES
+
+// pread може повернути менше байтів або перерватися сигналом
+bool read_fully(int fd, char* buffer, size_t length, uint64_t offset) {
+    while (length > 0) {
+        const ssize_t n = pread(fd, buffer, length, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        buffer += n;
+        length -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+bool count_chunk(int fd, const ChunkPlan& plan, size_t i, const FileSearchOptions& options,
+                 const char* substr, size_t substr_len, uint64_t& count) {
+    const size_t length = plan.length(i);
+    if (options.use_mmap) {
+        int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        flags |= MAP_POPULATE;  // Сторінки підтягуються одним викликом, а не по одній через page fault
+#endif
+        void* data = mmap(nullptr, length, PROT_READ, flags, fd, static_cast<off_t>(plan.offset(i)));
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        madvise(data, length, MADV_SEQUENTIAL);
+        count = count_substring(static_cast<const char*>(data), length, substr, substr_len, options.match);
+        munmap(data, length);
+        return true;
+    }
+
+    // Буфер живе в потоці й переживає виклики, тож пам'ять не виділяється на кожен шматок
+    thread_local std::vector<char> buffer;
+    buffer.resize(std::max(buffer.size(), length));
+    if (!read_fully(fd, buffer.data(), length, plan.offset(i))) {
+        return false;
+    }
+    count = count_substring(buffer.data(), length, substr, substr_len, options.match);
+    return true;
+}
+
+#endif
+
+}  // namespace
+
+bool count_substring_in_file(const std::string& path, const char* substr, size_t substr_len,
+                             uint64_t& count, const FileSearchOptions& options) {
+    count = 0;
+#ifdef SIMDLIB_POSIX_FILES
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+    const uint64_t file_size = static_cast<uint64_t>(info.st_size);
+    if (substr_len == 0 || file_size < substr_len) {
+        close(fd);
+        return true;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    const ChunkPlan plan = plan_chunks(file_size, substr_len, options.chunk_bytes,
+                                       static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+#else
+    std::ifstream probe(path, std::ios::binary | std::ios::ate);
+    if (!probe) {
+        return false;
+    }
+    const uint64_t file_size = static_cast<uint64_t>(probe.tellg());
+    if (substr_len == 0 || file_size < substr_len) {
+        return true;
+    }
+    const ChunkPlan plan = plan_chunks(file_size, substr_len, options.chunk_bytes, 4096);
+#endif
+
+    std::atomic<uint64_t> total{0};
+    std::atomic<bool> failed{false};
+    default_pool().parallel_for(plan.count, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end && !failed.load(std::memory_order_relaxed); ++i) {
+            uint64_t chunk_count = 0;
+#ifdef SIMDLIB_POSIX_FILES
+            const bool ok = count_chunk(fd, plan, i, options, substr, substr_len, chunk_count);
+#else
+            // Без POSIX кожне завдання читає свій шматок через окремий потік файлу
+            thread_local std::vector<char> buffer;
+            const size_t length = plan.length(i);
+            buffer.resize(std::max(buffer.size(), length));
+            std::ifstream in(path, std::ios::binary);
+            in.seekg(static_cast<std::streamoff>(plan.offset(i)));
+            const bool ok = static_cast<bool>(in.read(buffer.data(), static_cast<std::streamsize>(length)));
+            if (ok) {
+                chunk_count = count_substring(buffer.data(), length, substr, substr_len, options.match);
+            }
+#endif
+            if (!ok) {
+                failed.store(true, std::memory_order_relaxed);
+                return;
+            }
+            total.fetch_add(chunk_count, std::memory_order_relaxed);
+        }
+    });
+
+#ifdef SIMDLIB_POSIX_FILES
+    close(fd);
+#endif
+    count = total.load();
+    return !failed.load();
+}
+
+}  // namespace simd
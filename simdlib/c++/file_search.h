@@ -0,0 +1,29 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "kernels.h"
+
+namespace simd {
+
+struct FileSearchOptions {
+    // Скільки початкових позицій обробляє одне завдання (округлюється до розміру сторінки).
+    // Кожне завдання бачить ще substr_len - 1 байтів наступного шматка, тож збіги на межі
+    // рахуються рівно один раз. Пікова пам'ять: потоки x (chunk_bytes + substr_len - 1).
+    size_t chunk_bytes = 8u << 20;
+
+    // true — кожен шматок відображається через mmap, false — читається pread у буфер потоку
+    bool use_mmap = true;
+
+    // Режими порівняння (регістр, '?'), як у count_substring
+    MatchOptions match;
+};
+
+// Кількість (у тому числі перекривних) входжень substr у файл path. Шматки файлу
+// розподіляються між потоками default_pool(), кожен рахується через count_substring.
+// Повертає false, якщо файл не вдалося відкрити або прочитати.
+bool count_substring_in_file(const std::string& path, const char* substr, size_t substr_len,
+                             uint64_t& count, const FileSearchOptions& options = FileSearchOptions());
+
+}  // namespace simd
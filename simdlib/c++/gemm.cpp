@@ -0,0 +1,197 @@
+﻿#include "gemm.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "gemm_internal.h"
+#include "kernels.h"
+#include "memory.h"
+#include "thread_pool.h"
+
+namespace simd {
+
+namespace {
+
+// Розміри блоків: панель A (MC x KC) вміщується в L2, панель B (KC x NC) — у L3,
+// мікропанель B (KC x NR) лишається в L1 під час проходу по всіх панелях A.
+const size_t KC = 256;
+const size_t MC = 120;
+const size_t NC = 3072;
+
+const size_t GENERIC_MR = 4;
+const size_t GENERIC_NR = 8;
+
+// Мікроядро без явного SIMD для рівнів scalar і sse4.2 (компілятор векторизує його сам)
+void sgemm_kernel_generic(size_t kc, const float* a, const float* b,
+                          float* c, size_t ldc, float alpha, size_t mr, size_t nr) {
+    float acc[GENERIC_MR][GENERIC_NR] = {};
+    for (size_t k = 0; k < kc; ++k) {
+        for (size_t i = 0; i < GENERIC_MR; ++i) {
+            for (size_t j = 0; j < GENERIC_NR; ++j) {
+                acc[i][j] += a[i] * b[j];
+            }
+        }
+        a += GENERIC_MR;
+        b += GENERIC_NR;
+    }
+    for (size_t i = 0; i < mr; ++i) {
+        for (size_t j = 0; j < nr; ++j) {
+            c[i * ldc + j] += alpha * acc[i][j];
+        }
+    }
+}
+
+const GemmMicroKernel gemm_generic_kernel = { GENERIC_MR, GENERIC_NR, sgemm_kernel_generic };
+
+const GemmMicroKernel& select_kernel() {
+    switch (active_tier()) {
+    case CpuTier::AVX512: return gemm_avx512_kernel;
+    case CpuTier::AVX2: return gemm_avx2_kernel;
+    default: return gemm_generic_kernel;
+    }
+}
+
+// Буфер для упакованих панелей, вирівняний на 64 байти; пам'ять перевикористовується між викликами.
+// Старий вміст не потрібен, тож при зростанні буфер виділяється заново без копіювання.
+class PackBuffer {
+public:
+    float* get(size_t count) {
+        if (storage_.size() < count) {
+            storage_ = AlignedBuffer<float>(count);
+        }
+        return storage_.data();
+    }
+
+private:
+    AlignedBuffer<float> storage_;
+};
+
+size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// Пакує блок A (mc x kc) у панелі по mr рядків: panel[k * mr + i]; неповна панель доповнюється нулями
+void pack_a(const float* A, size_t lda, size_t mc, size_t kc, size_t mr, float* packed) {
+    for (size_t ir = 0; ir < mc; ir += mr) {
+        const size_t rows = std::min(mr, mc - ir);
+        for (size_t k = 0; k < kc; ++k) {
+            for (size_t i = 0; i < rows; ++i) {
+                packed[k * mr + i] = A[(ir + i) * lda + k];
+            }
+            for (size_t i = rows; i < mr; ++i) {
+                packed[k * mr + i] = 0.0f;
+            }
+        }
+        packed += mr * kc;
+    }
+}
+
+// Пакує панелі B [first, last) по nr стовпців: panel[k * nr + j]
+void pack_b(const float* B, size_t ldb, size_t nc, size_t kc, size_t nr,
+            size_t first, size_t last, float* packed) {
+    for (size_t panel = first; panel < last; ++panel) {
+        const size_t jr = panel * nr;
+        const size_t cols = std::min(nr, nc - jr);
+        float* dst = packed + panel * nr * kc;
+        for (size_t k = 0; k < kc; ++k) {
+            const float* src = B + k * ldb + jr;
+            for (size_t j = 0; j < cols; ++j) {
+                dst[k * nr + j] = src[j];
+            }
+            for (size_t j = cols; j < nr; ++j) {
+                dst[k * nr + j] = 0.0f;
+            }
+        }
+    }
+}
+
+void scale_c(size_t M, size_t N, float beta, float* C, size_t ldc) {
+    if (beta == 1.0f) {
+        return;
+    }
+    for (size_t i = 0; i < M; ++i) {
+        float* row = C + i * ldc;
+        for (size_t j = 0; j < N; ++j) {
+            // beta == 0 означає "перезаписати", навіть якщо в C були NaN
+            row[j] = beta == 0.0f ? 0.0f : beta * row[j];
+        }
+    }
+}
+
+}  // namespace
+
+void sgemm(size_t M, size_t N, size_t K,
+           float alpha, const float* A, size_t lda,
+           const float* B, size_t ldb,
+           float beta, float* C, size_t ldc) {
+    if (M == 0 || N == 0) {
+        return;
+    }
+    scale_c(M, N, beta, C, ldc);
+    if (K == 0 || alpha == 0.0f) {
+        return;
+    }
+
+    const GemmMicroKernel& kernel = select_kernel();
+    const size_t mr = kernel.mr;
+    const size_t nr = kernel.nr;
+    ThreadPool& pool = default_pool();
+
+    // Зменшуємо блок рядків, якщо інакше якісь потоки лишаться без роботи
+    const size_t mc = std::min(round_up(MC, mr), round_up((M + pool.size() - 1) / pool.size(), mr));
+    const size_t row_blocks = (M + mc - 1) / mc;
+
+    thread_local PackBuffer b_buffer;
+    float* packed_b = b_buffer.get(KC * round_up(std::min(N, NC), nr));
+
+    for (size_t jc = 0; jc < N; jc += NC) {
+        const size_t nc = std::min(NC, N - jc);
+        const size_t panels = (nc + nr - 1) / nr;
+
+        for (size_t pc = 0; pc < K; pc += KC) {
+            const size_t kc = std::min(KC, K - pc);
+
+            pool.parallel_for(panels, 8, [&](size_t first, size_t last) {
+                pack_b(B + pc * ldb + jc, ldb, nc, kc, nr, first, last, packed_b);
+            });
+
+            pool.parallel_for(row_blocks, 1, [&](size_t first, size_t last) {
+                thread_local PackBuffer a_buffer;
+                float* packed_a = a_buffer.get(round_up(mc, mr) * kc);
+
+                for (size_t block = first; block < last; ++block) {
+                    const size_t ic = block * mc;
+                    const size_t rows = std::min(mc, M - ic);
+                    pack_a(A + ic * lda + pc, lda, rows, kc, mr, packed_a);
+
+                    for (size_t jr = 0; jr < nc; jr += nr) {
+                        const float* panel_b = packed_b + jr * kc;
+                        for (size_t ir = 0; ir < rows; ir += mr) {
+                            kernel.fn(kc, packed_a + ir * kc, panel_b,
+                                      C + (ic + ir) * ldc + jc + jr, ldc, alpha,
+                                      std::min(mr, rows - ir), std::min(nr, nc - jr));
+                        }
+                    }
+                }
+            });
+        }
+    }
+}
+
+void sgemm_baseline(size_t n, const float* A, const float* B, float* C) {
+    if (active_tier() >= CpuTier::AVX2 && n % 8 == 0) {
+        sgemm_baseline_avx2(n, A, B, C);
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            float sum = 0.0f;
+            for (size_t k = 0; k < n; ++k) {
+                sum += A[i * n + k] * B[k * n + j];
+            }
+            C[i * n + j] = sum;
+        }
+    }
+}
+
+}  // namespace simd
@@ -0,0 +1,19 @@
+﻿#pragma once
+#include <cstddef>
+
+namespace simd {
+
+// C = alpha * A * B + beta * C для матриць у порядку рядків (row-major).
+// A має розмір M x K з кроком рядка lda, B — K x N з кроком ldb, C — M x N з кроком ldc.
+// Панелі A і B пакуються в блоки під розміри кешів, добуток рахує регістрове
+// мікроядро з багатьма FMA-акумуляторами, блоки рядків розподіляються між потоками default_pool().
+void sgemm(size_t M, size_t N, size_t K,
+           float alpha, const float* A, size_t lda,
+           const float* B, size_t ldb,
+           float beta, float* C, size_t ldc);
+
+// Порт multiply_matrices_simd із task4/nasm/task4.asm для порівняння: квадратні матриці n x n,
+// один акумулятор на 8 стовпців, B обходиться по стовпцях. На процесорах без AVX2 — скалярний цикл.
+void sgemm_baseline(size_t n, const float* A, const float* B, float* C);
+
+}  // namespace simd
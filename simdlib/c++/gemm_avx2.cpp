@@ -0,0 +1,83 @@
+﻿#include <immintrin.h>
+#include <cstddef>
+
+#include "gemm_internal.h"
+
+#include "target_avx2.h"
+
+namespace simd {
+
+namespace {
+
+const size_t MR = 6;
+const size_t NR = 16;
+
+// Регістровий блок 6 x 16: 12 акумуляторів + 2 регістри B + 1 регістр трансляції A.
+// На кожному кроці k виконується 12 незалежних FMA, тож затримка FMA повністю прихована.
+void sgemm_kernel_6x16(size_t kc, const float* a, const float* b,
+                       float* c, size_t ldc, float alpha, size_t mr, size_t nr) {
+    __m256 acc[MR][2];
+    SIMDLIB_UNROLL
+    for (size_t i = 0; i < MR; ++i) {
+        acc[i][0] = _mm256_setzero_ps();
+        acc[i][1] = _mm256_setzero_ps();
+    }
+
+    for (size_t k = 0; k < kc; ++k) {
+        const __m256 b0 = _mm256_load_ps(b);
+        const __m256 b1 = _mm256_load_ps(b + 8);
+        SIMDLIB_UNROLL
+        for (size_t i = 0; i < MR; ++i) {
+            const __m256 ai = _mm256_broadcast_ss(a + i);
+            acc[i][0] = _mm256_fmadd_ps(ai, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_ps(ai, b1, acc[i][1]);
+        }
+        a += MR;
+        b += NR;
+    }
+
+    const __m256 valpha = _mm256_set1_ps(alpha);
+    if (mr == MR && nr == NR) {
+        SIMDLIB_UNROLL
+        for (size_t i = 0; i < MR; ++i) {
+            float* row = c + i * ldc;
+            _mm256_storeu_ps(row, _mm256_fmadd_ps(valpha, acc[i][0], _mm256_loadu_ps(row)));
+            _mm256_storeu_ps(row + 8, _mm256_fmadd_ps(valpha, acc[i][1], _mm256_loadu_ps(row + 8)));
+        }
+        return;
+    }
+
+    // Крайовий блок: вивантажуємо акумулятори й додаємо лише дійсну частину
+    alignas(32) float tile[MR * NR];
+    SIMDLIB_UNROLL
+    for (size_t i = 0; i < MR; ++i) {
+        _mm256_store_ps(tile + i * NR, _mm256_mul_ps(valpha, acc[i][0]));
+        _mm256_store_ps(tile + i * NR + 8, _mm256_mul_ps(valpha, acc[i][1]));
+    }
+    for (size_t i = 0; i < mr; ++i) {
+        for (size_t j = 0; j < nr; ++j) {
+            c[i * ldc + j] += tile[i * NR + j];
+        }
+    }
+}
+
+}  // namespace
+
+const GemmMicroKernel gemm_avx2_kernel = { MR, NR, sgemm_kernel_6x16 };
+
+void sgemm_baseline_avx2(size_t n, const float* A, const float* B, float* C) {
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; j += 8) {
+            __m256 sum = _mm256_setzero_ps();
+            for (size_t k = 0; k < n; ++k) {
+                const __m256 a = _mm256_broadcast_ss(&A[i * n + k]);
+                sum = _mm256_fmadd_ps(a, _mm256_loadu_ps(&B[k * n + j]), sum);
+            }
+            _mm256_storeu_ps(&C[i * n + j], sum);
+        }
+    }
+}
+
+}  // namespace simd
+
+#include "target_end.h"
@@ -0,0 +1,69 @@
+﻿#include <immintrin.h>
+#include <cstddef>
+
+#include "gemm_internal.h"
+
+#include "target_avx512.h"
+
+namespace simd {
+
+namespace {
+
+const size_t MR = 12;
+const size_t NR = 32;
+
+// Регістровий блок 12 x 32: 24 акумулятори з 32 ZMM-регістрів, решта — під B і трансляцію A
+void sgemm_kernel_12x32(size_t kc, const float* a, const float* b,
+                        float* c, size_t ldc, float alpha, size_t mr, size_t nr) {
+    __m512 acc[MR][2];
+    SIMDLIB_UNROLL
+    for (size_t i = 0; i < MR; ++i) {
+        acc[i][0] = _mm512_setzero_ps();
+        acc[i][1] = _mm512_setzero_ps();
+    }
+
+    for (size_t k = 0; k < kc; ++k) {
+        const __m512 b0 = _mm512_load_ps(b);
+        const __m512 b1 = _mm512_load_ps(b + 16);
+        SIMDLIB_UNROLL
+        for (size_t i = 0; i < MR; ++i) {
+            const __m512 ai = _mm512_set1_ps(a[i]);
+            acc[i][0] = _mm512_fmadd_ps(ai, b0, acc[i][0]);
+            acc[i][1] = _mm512_fmadd_ps(ai, b1, acc[i][1]);
+        }
+        a += MR;
+        b += NR;
+    }
+
+    const __m512 valpha = _mm512_set1_ps(alpha);
+    if (mr == MR && nr == NR) {
+        SIMDLIB_UNROLL
+        for (size_t i = 0; i < MR; ++i) {
+            float* row = c + i * ldc;
+            _mm512_storeu_ps(row, _mm512_fmadd_ps(valpha, acc[i][0], _mm512_loadu_ps(row)));
+            _mm512_storeu_ps(row + 16, _mm512_fmadd_ps(valpha, acc[i][1], _mm512_loadu_ps(row + 16)));
+        }
+        return;
+    }
+
+    // Крайовий блок: стовпці відсікаємо масками, рядки — лічильником
+    const __mmask16 m0 = static_cast<__mmask16>(nr >= 16 ? 0xFFFF : (1u << nr) - 1);
+    const __mmask16 m1 = static_cast<__mmask16>(nr >= 32 ? 0xFFFF : nr > 16 ? (1u << (nr - 16)) - 1 : 0);
+    SIMDLIB_UNROLL
+    for (size_t i = 0; i < MR; ++i) {
+        if (i >= mr) {
+            break;
+        }
+        float* row = c + i * ldc;
+        _mm512_mask_storeu_ps(row, m0, _mm512_fmadd_ps(valpha, acc[i][0], _mm512_maskz_loadu_ps(m0, row)));
+        _mm512_mask_storeu_ps(row + 16, m1, _mm512_fmadd_ps(valpha, acc[i][1], _mm512_maskz_loadu_ps(m1, row + 16)));
+    }
+}
+
+}  // namespace
+
+const GemmMicroKernel gemm_avx512_kernel = { MR, NR, sgemm_kernel_12x32 };
+
+}  // namespace simd
+
+#include "target_end.h"
@@ -0,0 +1,31 @@
+﻿#pragma once
+#include <cstddef>
+
+// Повне розгортання циклів за регістровим блоком, щоб акумулятори жили в регістрах, а не в стеку
+#if defined(__GNUC__)
+#define SIMDLIB_UNROLL _Pragma("GCC unroll 16")
+#else
+#define SIMDLIB_UNROLL
+#endif
+
+namespace simd {
+
+// Мікроядро GEMM: рахує блок mr x nr (mr <= MR, nr <= NR) добутку упакованих панелей
+// і додає його до C: C[i][j] += alpha * sum_k a[k * MR + i] * b[k * NR + j].
+using GemmMicroKernelFn = void (*)(size_t kc, const float* a, const float* b,
+                                   float* c, size_t ldc, float alpha, size_t mr, size_t nr);
+
+// Опис мікроядра для одного рівня набору інструкцій
+struct GemmMicroKernel {
+    size_t mr;  // Рядків у регістровому блоці
+    size_t nr;  // Стовпців у регістровому блоці
+    GemmMicroKernelFn fn;
+};
+
+extern const GemmMicroKernel gemm_avx2_kernel;
+extern const GemmMicroKernel gemm_avx512_kernel;
+
+// Порт task4 (AVX2), n кратне 8
+void sgemm_baseline_avx2(size_t n, const float* A, const float* B, float* C);
+
+}  // namespace simd
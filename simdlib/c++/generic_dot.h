@@ -0,0 +1,30 @@
+﻿#pragma once
+#include <cstddef>
+
+// Скалярний добуток для ядер без явного SIMD (рівні scalar і sse4.2)
+namespace simd {
+
+const size_t GENERIC_DOT_LANES = 8;
+
+// Сума term(i) для i < size у восьми незалежних часткових сумах, які компілятор може звести
+// у векторні регістри; залишок додається в першу
+template <typename Term>
+inline float generic_dot(size_t size, Term term) {
+    float acc[GENERIC_DOT_LANES] = {};
+    size_t i = 0;
+    for (; i + GENERIC_DOT_LANES <= size; i += GENERIC_DOT_LANES) {
+        for (size_t l = 0; l < GENERIC_DOT_LANES; ++l) {
+            acc[l] += term(i + l);
+        }
+    }
+    for (; i < size; ++i) {
+        acc[0] += term(i);
+    }
+    float sum = 0.0f;
+    for (size_t l = 0; l < GENERIC_DOT_LANES; ++l) {
+        sum += acc[l];
+    }
+    return sum;
+}
+
+}  // namespace simd
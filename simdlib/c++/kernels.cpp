@@ -0,0 +1,276 @@
+﻿#include "kernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "kernels_internal.h"
+#include "thread_pool.h"
+
+namespace simd {
+
+namespace {
+
+std::atomic<const KernelTable*> g_active{nullptr};
+std::atomic<size_t> g_stream_threshold{0};  // 0 — ще не визначено
+
+// Рівень за замовчуванням: найкращий підтримуваний або нижчий, якщо його задано в SIMDLIB_TIER.
+// Вищий за підтримуваний рівень ігнорується, щоб не отримати SIGILL.
+CpuTier default_tier() {
+    CpuTier tier = max_supported_tier();
+    CpuTier requested;
+    if (parse_tier(std::getenv("SIMDLIB_TIER"), requested) && requested < tier) {
+        tier = requested;
+    }
+    return tier;
+}
+
+size_t default_streaming_threshold() {
+    if (const char* env = std::getenv("SIMDLIB_STREAM_BYTES")) {
+        const unsigned long long value = std::strtoull(env, nullptr, 10);
+        if (value > 0) {
+            return static_cast<size_t>(value);
+        }
+    }
+    // Як і в memcpy з glibc, беремо 3/4 LLC: решта кешу лишається під інші дані процесу
+    const size_t llc = cpu_features().llc_bytes;
+    return (llc ? llc : 8u << 20) / 4 * 3;
+}
+
+// Груба оцінка того, наскільки часто байт трапляється в тексті (більше — частіше):
+// пробіл і малі літери за частотою в англійській, далі розділові знаки, цифри й великі літери.
+// Нуль і 0xFF часті в двійкових даних. Решта байтів вважається рідкісною.
+unsigned byte_frequency(unsigned char c) {
+    static const char letters[] = "etaoinshrdlcumwfgypbvkjxqz";
+    if (c == ' ') {
+        return 255;
+    }
+    if (c >= 'a' && c <= 'z') {
+        return 250 - 4 * static_cast<unsigned>(strchr(letters, c) - letters);
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return 100 - 2 * static_cast<unsigned>(strchr(letters, c - 'A' + 'a') - letters);
+    }
+    if (c == 0 || c == 0xFF) {
+        return 140;
+    }
+    if (c == '\n' || c == ',' || c == '.' || c == '\t' || c == '"' || c == '\r') {
+        return 120;
+    }
+    if (c >= '0' && c <= '9') {
+        return 110;
+    }
+    return c < 128 ? 40 : 20;
+}
+
+// Блок детермінованого скалярного добутку. Межі блоків не залежать від кількості потоків,
+// а суми блоків додаються послідовно в порядку індексів.
+const size_t DOT_SEGMENT = 1 << 16;
+
+float dot_deterministic(const KernelTable& table, const float* a, const float* b, size_t size) {
+    const size_t segments = (size + DOT_SEGMENT - 1) / DOT_SEGMENT;
+    if (segments <= 1) {
+        return static_cast<float>(0.0 + table.dot_f32_lanes(a, b, size));
+    }
+    std::vector<double> partial(segments);
+    default_pool().parallel_for(segments, 1, [&](size_t begin, size_t end) {
+        for (size_t s = begin; s < end; ++s) {
+            const size_t offset = s * DOT_SEGMENT;
+            partial[s] = table.dot_f32_lanes(a + offset, b + offset, std::min(DOT_SEGMENT, size - offset));
+        }
+    });
+    double total = 0.0;
+    for (double p : partial) {
+        total += p;
+    }
+    return static_cast<float>(total);
+}
+
+}  // namespace
+
+double fold_dot_lanes(double* lanes) {
+    for (size_t width = DOT_LANES / 2; width > 0; width /= 2) {
+        for (size_t j = 0; j < width; ++j) {
+            lanes[j] += lanes[j + width];
+        }
+    }
+    return lanes[0];
+}
+
+float sum_compensated(const float* sums, const float* corrections, size_t count) {
+    float s = 0.0f;
+    float c = 0.0f;
+    for (size_t k = 0; k < count; ++k) {
+        // TwoSum: t + e == s + sums[k] точно
+        const float t = s + sums[k];
+        const float z = t - s;
+        c += (s - (t - z)) + (sums[k] - z);
+        s = t;
+    }
+    for (size_t k = 0; k < count; ++k) {
+        c += corrections[k];
+    }
+    return s + c;
+}
+
+SearchPattern::SearchPattern(const char* substr, size_t substr_len, const MatchOptions& options) : len(substr_len) {
+    const size_t padded = (substr_len + SEARCH_PATTERN_BLOCK - 1) / SEARCH_PATTERN_BLOCK * SEARCH_PATTERN_BLOCK;
+    if (padded <= SEARCH_PATTERN_BLOCK) {
+        bytes = inline_;
+    }
+    else {
+        heap_.resize(2 * padded);
+        bytes = heap_.data();
+    }
+    fold = bytes + padded;
+    memset(bytes, 0xFF, 2 * padded);
+    size_t concrete = 0;
+    for (size_t j = 0; j < substr_len; ++j) {
+        const unsigned char c = static_cast<unsigned char>(substr[j]);
+        if (options.wildcard && c == '?') {
+            continue;
+        }
+        const bool letter = options.ignore_case && ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'));
+        fold[j] = letter ? 0x20 : 0;
+        bytes[j] = static_cast<uint8_t>(c | fold[j]);
+        ++concrete;
+    }
+
+    // Опори — лише конкретні байти; для літери без урахування регістру частота — як у малої
+    const auto concrete_at = [&](size_t j) { return fold[j] != 0xFF; };
+    const auto same = [&](size_t a, size_t b) { return bytes[a] == bytes[b] && fold[a] == fold[b]; };
+    if (concrete == 0) {
+        return;  // Шаблон лише з '?': опора з fold 0xFF збігається з будь-яким байтом
+    }
+    anchors.first = substr_len;
+    for (size_t j = 0; j < substr_len; ++j) {
+        if (concrete_at(j) && (anchors.first == substr_len || byte_frequency(bytes[j]) < byte_frequency(bytes[anchors.first]))) {
+            anchors.first = j;
+        }
+    }
+
+    // Друга опора — найрідший байт, відмінний від першої; якщо всі байти однакові, беремо останній
+    anchors.second = anchors.first;
+    for (size_t j = substr_len; j-- > 0;) {
+        if (j != anchors.first && concrete_at(j)) {
+            anchors.second = j;
+            break;
+        }
+    }
+    bool distinct = false;
+    for (size_t j = 0; j < substr_len; ++j) {
+        if (j == anchors.first || !concrete_at(j) || same(j, anchors.first)) {
+            continue;
+        }
+        if (!distinct || byte_frequency(bytes[j]) < byte_frequency(bytes[anchors.second])) {
+            anchors.second = j;
+            distinct = true;
+        }
+    }
+    verify = concrete > (anchors.first == anchors.second ? 1u : 2u);
+}
+
+bool SearchPattern::matches(const char* text) const {
+    for (size_t j = 0; j < len; ++j) {
+        if (!byte_matches(text[j], j)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const KernelTable& kernels_for(CpuTier tier) {
+    switch (tier) {
+    case CpuTier::AVX512: return avx512_kernels;
+    case CpuTier::AVX2: return avx2_kernels;
+    case CpuTier::SSE42: return sse42_kernels;
+    case CpuTier::Scalar: break;
+    }
+    return scalar_kernels;
+}
+
+const KernelTable& kernels() {
+    const KernelTable* table = g_active.load(std::memory_order_acquire);
+    if (!table) {
+        // Гонка при першому виклику нешкідлива: усі потоки обчислять однаковий результат
+        table = &kernels_for(default_tier());
+        g_active.store(table, std::memory_order_release);
+    }
+    return *table;
+}
+
+CpuTier active_tier() {
+    return kernels().tier;
+}
+
+bool set_tier(CpuTier tier) {
+    if (tier > max_supported_tier()) {
+        return false;
+    }
+    g_active.store(&kernels_for(tier), std::memory_order_release);
+    return true;
+}
+
+void reset_tier() {
+    g_active.store(&kernels_for(default_tier()), std::memory_order_release);
+}
+
+size_t streaming_threshold() {
+    size_t threshold = g_stream_threshold.load(std::memory_order_relaxed);
+    if (threshold == 0) {
+        threshold = default_streaming_threshold();
+        g_stream_threshold.store(threshold, std::memory_order_relaxed);
+    }
+    return threshold;
+}
+
+void set_streaming_threshold(size_t bytes) {
+    g_stream_threshold.store(bytes, std::memory_order_relaxed);
+}
+
+void add_arrays(const int* a, const int* b, int* result, size_t size) {
+    const KernelTable& table = kernels();
+    (3 * size * sizeof(int) >= streaming_threshold() ? table.add_i32_stream : table.add_i32)(a, b, result, size);
+}
+
+void add_vectors(const float* a, const float* b, float* result, size_t size) {
+    const KernelTable& table = kernels();
+    (3 * size * sizeof(float) >= streaming_threshold() ? table.add_f32_stream : table.add_f32)(a, b, result, size);
+}
+
+void multiply_vectors(const float* a, const float* b, float* result, size_t size) {
+    const KernelTable& table = kernels();
+    (3 * size * sizeof(float) >= streaming_threshold() ? table.mul_f32_stream : table.mul_f32)(a, b, result, size);
+}
+
+void fma_vectors(const float* a, const float* b, const float* c, float* result, size_t size) {
+    kernels().fma_f32(a, b, c, result, size);
+}
+
+float dot_product(const float* a, const float* b, size_t size) {
+    return kernels().dot_f32(a, b, size);
+}
+
+float dot_product(const float* a, const float* b, size_t size, DotMode mode) {
+    const KernelTable& table = kernels();
+    switch (mode) {
+    case DotMode::Fast: return table.dot_f32(a, b, size);
+    case DotMode::Compensated: return table.dot_f32_compensated(a, b, size);
+    case DotMode::Deterministic: break;
+    }
+    return dot_deterministic(table, a, b, size);
+}
+
+size_t count_substring(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                       const MatchOptions& options) {
+    return kernels().count_substring(str, str_len, substr, substr_len, options);
+}
+
+size_t find_all(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                size_t* positions, size_t capacity, size_t& cursor, const MatchOptions& options) {
+    return kernels().find_all(str, str_len, substr, substr_len, positions, capacity, cursor, options);
+}
+
+}  // namespace simd
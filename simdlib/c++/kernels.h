@@ -0,0 +1,113 @@
+﻿#pragma once
+#include <cstddef>
+
+#include "cpu_features.h"
+
+namespace simd {
+
+// Режими порівняння шаблону в пошуку підрядка. Обидва застосовуються під час порівняння в регістрах,
+// без копії тексту, тож пошук працює майже з тією самою швидкістю, що й точний.
+struct MatchOptions {
+    bool ignore_case = false;  // Літери ASCII без урахування регістру (A–Z і a–z), решта байтів — точно
+    bool wildcard = false;     // '?' у шаблоні — будь-який один байт (знайти сам '?' у цьому режимі не можна)
+};
+
+// Таблиця реалізацій ядер для одного рівня набору інструкцій.
+// Диспетчер один раз обирає таблицю й далі викликає ядра через ці покажчики.
+struct KernelTable {
+    CpuTier tier;
+    void (*add_i32)(const int* a, const int* b, int* result, size_t size);
+    void (*add_f32)(const float* a, const float* b, float* result, size_t size);
+    void (*mul_f32)(const float* a, const float* b, float* result, size_t size);
+    void (*fma_f32)(const float* a, const float* b, const float* c, float* result, size_t size);
+
+    // Ті самі операції з потоковими (non-temporal) записами й програмною попередньою вибіркою входів
+    void (*add_i32_stream)(const int* a, const int* b, int* result, size_t size);
+    void (*add_f32_stream)(const float* a, const float* b, float* result, size_t size);
+    void (*mul_f32_stream)(const float* a, const float* b, float* result, size_t size);
+
+    float (*dot_f32)(const float* a, const float* b, size_t size);
+    float (*dot_f32_compensated)(const float* a, const float* b, size_t size);
+    double (*dot_f32_lanes)(const float* a, const float* b, size_t size);  // Див. DotMode::Deterministic
+    size_t (*count_substring)(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                              const MatchOptions& options);
+    size_t (*find_all)(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                       size_t* positions, size_t capacity, size_t& cursor, const MatchOptions& options);
+};
+
+// Активна таблиця. Під час першого виклику обирає найкращий рівень, який підтримує
+// процесор; змінна середовища SIMDLIB_TIER (scalar, sse4.2, avx2, avx512) може його знизити.
+const KernelTable& kernels();
+
+// Таблиця конкретного рівня (без перевірки підтримки процесором)
+const KernelTable& kernels_for(CpuTier tier);
+
+// Поточний рівень диспетчеризації
+CpuTier active_tier();
+
+// Примусово вмикає рівень tier. Повертає false і нічого не змінює,
+// якщо процесор цей рівень не підтримує.
+bool set_tier(CpuTier tier);
+
+// Повертає автоматичний вибір рівня (з урахуванням SIMDLIB_TIER)
+void reset_tier();
+
+// Поріг (сумарний розмір масивів одного виклику в байтах), з якого поелементні ядра пишуть результат
+// потоковими записами: рядок результату не читається перед записом (немає read-for-ownership)
+// і не витісняє з кешу інші дані. За замовчуванням поріг — 3/4 кешу останнього рівня, визначеного
+// через cpuid (LLC вважається 8 МіБ, якщо його не вдалося визначити); SIMDLIB_STREAM_BYTES задає поріг явно.
+size_t streaming_threshold();
+
+// Змінює поріг; 0 повертає автоматичне значення, SIZE_MAX вимикає потоковий режим
+void set_streaming_threshold(size_t bytes);
+
+// result[i] = a[i] + b[i] (цілі числа, аналог add_arrays_avx із task1/task2)
+void add_arrays(const int* a, const int* b, int* result, size_t size);
+
+// result[i] = a[i] + b[i] (аналог add_vectors_avx із task3)
+void add_vectors(const float* a, const float* b, float* result, size_t size);
+
+// result[i] = a[i] * b[i] (аналог multiply_vectors_avx із task4)
+void multiply_vectors(const float* a, const float* b, float* result, size_t size);
+
+// result[i] = a[i] * b[i] + c[i]. На рівнях AVX2 і AVX-512 — FMA з одним округленням,
+// на scalar і SSE4.2 — множення й додавання з двома округленнями.
+void fma_vectors(const float* a, const float* b, const float* c, float* result, size_t size);
+
+// Режими скалярного добутку. Нижче u = 2^-24 (одиниця округлення float), S = sum |a[i] * b[i]|,
+// швидкість — відносно Fast на одному ядрі для даних у кеші (у DRAM усі режими впираються в пам'ять).
+enum class DotMode {
+    // Кілька незалежних FMA-акумуляторів (L смуг: 1 для scalar, 16 для SSE4.2, 32 для AVX2, 64 для AVX-512).
+    // Похибка не більша за (size / L + log2(L) + 1) * u * S. Результат залежить від рівня.
+    Fast,
+
+    // Алгоритм Dot2 (Огіта, Румп, Оїсі): точні похибки добутків і сум накопичуються окремо,
+    // тож результат такий, ніби рахували з подвійною точністю й округлили до float:
+    // похибка не більша за u * |a·b| + (size * u)^2 * S. Приблизно в 2–4 рази повільніше за Fast.
+    Compensated,
+
+    // Добутки точні в double й додаються в 16 смуг (елемент i — у смугу i % 16) блоками по 2^16 елементів,
+    // смуги й блоки згортаються у фіксованому порядку. Результат побітово однаковий на всіх рівнях
+    // і за будь-якої кількості потоків; похибка не більша за u * |a·b| + (size / 16 + 2^-16 * size + 4) * 2^-53 * S.
+    // Великі масиви рахуються блоками в default_pool(). На одному ядрі в 1,5–2,5 раза повільніше за Fast.
+    Deterministic,
+};
+
+// Скалярний добуток (аналог dot_product_avx із task3), режим Fast
+float dot_product(const float* a, const float* b, size_t size);
+
+// Скалярний добуток у вибраному режимі
+float dot_product(const float* a, const float* b, size_t size, DotMode mode);
+
+// Кількість (у тому числі перекривних) входжень substr у str (аналог count_substring_avx2 із task5)
+size_t count_substring(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                       const MatchOptions& options = MatchOptions());
+
+// Записує в positions зміщення входжень substr, що починаються не раніше cursor, — не більше capacity.
+// Повертає кількість записаних зміщень і пересуває cursor за останнє записане входження
+// (або в str_len, якщо рядок пройдено до кінця), тож повторний виклик продовжує пошук.
+// Пошук завершено, коли функція повернула менше за capacity.
+size_t find_all(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                size_t* positions, size_t capacity, size_t& cursor, const MatchOptions& options = MatchOptions());
+
+}  // namespace simd
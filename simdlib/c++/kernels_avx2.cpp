@@ -0,0 +1,320 @@
+﻿#include <immintrin.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "bit_ops.h"
+#include "kernels_internal.h"
+
+#include "target_avx2.h"
+
+// Реалізації на 256-бітних регістрах: 8 елементів int/float або 32 байти за раз
+namespace simd {
+
+namespace {
+
+// Наскільки наперед (у байтах) підтягуються вхідні дані в потоковому режимі
+const size_t PREFETCH_DISTANCE = 1024;
+
+void add_i32_avx2(const int* a, const int* b, int* result, size_t size) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)&a[i]);
+        __m256i vb = _mm256_loadu_si256((const __m256i*)&b[i]);
+        _mm256_storeu_si256((__m256i*)&result[i], _mm256_add_epi32(va, vb));
+    }
+    for (; i < size; ++i) {
+        result[i] = a[i] + b[i];
+    }
+}
+
+void add_f32_avx2(const float* a, const float* b, float* result, size_t size) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(&result[i], _mm256_add_ps(_mm256_loadu_ps(&a[i]), _mm256_loadu_ps(&b[i])));
+    }
+    for (; i < size; ++i) {
+        result[i] = a[i] + b[i];
+    }
+}
+
+void mul_f32_avx2(const float* a, const float* b, float* result, size_t size) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(&result[i], _mm256_mul_ps(_mm256_loadu_ps(&a[i]), _mm256_loadu_ps(&b[i])));
+    }
+    for (; i < size; ++i) {
+        result[i] = a[i] * b[i];
+    }
+}
+
+void fma_f32_avx2(const float* a, const float* b, const float* c, float* result, size_t size) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(&result[i], _mm256_fmadd_ps(_mm256_loadu_ps(&a[i]), _mm256_loadu_ps(&b[i]), _mm256_loadu_ps(&c[i])));
+    }
+    // Хвіст через скалярну FMA, щоб і він мав одне округлення, як основний цикл
+    for (; i < size; ++i) {
+        result[i] = _mm_cvtss_f32(_mm_fmadd_ss(_mm_set_ss(a[i]), _mm_set_ss(b[i]), _mm_set_ss(c[i])));
+    }
+}
+
+// Потоковий варіант: результат пишеться vmovntdq (_mm256_stream_si256) в обхід кешу, входи підтягуються
+// prefetch за PREFETCH_DISTANCE байтів наперед. Такі записи вимагають вирівняної на 32 байти
+// адреси, тож голова до межі рахується звичайно. Op::vec(pa, pb) повертає __m256i для 32 / sizeof(T) елементів.
+template <typename Op, typename T>
+void stream_binary(const T* a, const T* b, T* result, size_t size) {
+    size_t i = 0;
+    for (; i < size && reinterpret_cast<uintptr_t>(result + i) % 32 != 0; ++i) {
+        result[i] = Op::scalar(a[i], b[i]);
+    }
+    const size_t lanes = 32 / sizeof(T);
+    for (; i + 64 / sizeof(T) <= size; i += 64 / sizeof(T)) {
+        _mm_prefetch(reinterpret_cast<const char*>(a + i) + PREFETCH_DISTANCE, _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(b + i) + PREFETCH_DISTANCE, _MM_HINT_T0);
+        _mm256_stream_si256((__m256i*)(result + i), Op::vec(a + i, b + i));
+        _mm256_stream_si256((__m256i*)(result + i + lanes), Op::vec(a + i + lanes, b + i + lanes));
+    }
+    for (; i < size; ++i) {
+        result[i] = Op::scalar(a[i], b[i]);
+    }
+    _mm_sfence();  // Потокові записи слабко впорядковані: робимо їх видимими до повернення
+}
+
+struct AddI32 {
+    static __m256i vec(const int* pa, const int* pb) {
+        return _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)pa),
+                                _mm256_loadu_si256((const __m256i*)pb));
+    }
+    static int scalar(int x, int y) { return x + y; }
+};
+
+struct AddF32 {
+    static __m256i vec(const float* pa, const float* pb) {
+        return _mm256_castps_si256(_mm256_add_ps(_mm256_loadu_ps(pa), _mm256_loadu_ps(pb)));
+    }
+    static float scalar(float x, float y) { return x + y; }
+};
+
+struct MulF32 {
+    static __m256i vec(const float* pa, const float* pb) {
+        return _mm256_castps_si256(_mm256_mul_ps(_mm256_loadu_ps(pa), _mm256_loadu_ps(pb)));
+    }
+    static float scalar(float x, float y) { return x * y; }
+};
+
+void add_i32_stream_avx2(const int* a, const int* b, int* result, size_t size) {
+    stream_binary<AddI32>(a, b, result, size);
+}
+
+void add_f32_stream_avx2(const float* a, const float* b, float* result, size_t size) {
+    stream_binary<AddF32>(a, b, result, size);
+}
+
+void mul_f32_stream_avx2(const float* a, const float* b, float* result, size_t size) {
+    stream_binary<MulF32>(a, b, result, size);
+}
+
+// Горизонтальна сума восьми елементів без виходу в пам'ять
+float hsum(__m256 v) {
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    __m128 shuf = _mm_movehdup_ps(lo);
+    __m128 sums = _mm_add_ps(lo, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+}
+
+// Чотири незалежні FMA-акумулятори: латентність FMA перекривається, і цикл упирається
+// в завантаження (два на такт), а не в ланцюжок залежностей одного акумулятора
+float dot_f32_avx2(const float* a, const float* b, size_t size) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps();
+    __m256 acc3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(&a[i]), _mm256_loadu_ps(&b[i]), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(&a[i + 8]), _mm256_loadu_ps(&b[i + 8]), acc1);
+        acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(&a[i + 16]), _mm256_loadu_ps(&b[i + 16]), acc2);
+        acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(&a[i + 24]), _mm256_loadu_ps(&b[i + 24]), acc3);
+    }
+    for (; i + 8 <= size; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(&a[i]), _mm256_loadu_ps(&b[i]), acc0);
+    }
+    float dot = hsum(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+    for (; i < size; ++i) {
+        dot += a[i] * b[i];
+    }
+    return dot;
+}
+
+// Крок Dot2 для восьми смуг: точна похибка добутку — fmsub(a, b, p), суми — TwoSum
+void dot2_step(__m256 va, __m256 vb, __m256& s, __m256& c) {
+    const __m256 p = _mm256_mul_ps(va, vb);
+    const __m256 ep = _mm256_fmsub_ps(va, vb, p);
+    const __m256 sum = _mm256_add_ps(s, p);
+    const __m256 z = _mm256_sub_ps(sum, s);
+    const __m256 es = _mm256_add_ps(_mm256_sub_ps(s, _mm256_sub_ps(sum, z)), _mm256_sub_ps(p, z));
+    c = _mm256_add_ps(c, _mm256_add_ps(es, ep));
+    s = sum;
+}
+
+float dot_f32_compensated_avx2(const float* a, const float* b, size_t size) {
+    __m256 s0 = _mm256_setzero_ps(), c0 = _mm256_setzero_ps();
+    __m256 s1 = _mm256_setzero_ps(), c1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        dot2_step(_mm256_loadu_ps(&a[i]), _mm256_loadu_ps(&b[i]), s0, c0);
+        dot2_step(_mm256_loadu_ps(&a[i + 8]), _mm256_loadu_ps(&b[i + 8]), s1, c1);
+    }
+    // Залишок доповнюємо нулями: нульові добутки не змінюють ні суми, ні поправки
+    for (; i < size; i += 8) {
+        float ta[8] = {}, tb[8] = {};
+        memcpy(ta, &a[i], std::min<size_t>(8, size - i) * sizeof(float));
+        memcpy(tb, &b[i], std::min<size_t>(8, size - i) * sizeof(float));
+        dot2_step(_mm256_loadu_ps(ta), _mm256_loadu_ps(tb), s0, c0);
+    }
+
+    alignas(32) float sums[16], corrections[16];
+    _mm256_store_ps(sums, s0);
+    _mm256_store_ps(sums + 8, s1);
+    _mm256_store_ps(corrections, c0);
+    _mm256_store_ps(corrections + 8, c1);
+    return sum_compensated(sums, corrections, 16);
+}
+
+// Смуги 4k..4k + 3 — у lanes[k]; добуток float у double точний, тож FMA дає те саме, що mul + add
+double dot_f32_lanes_avx2(const float* a, const float* b, size_t size) {
+    __m256d lanes[DOT_LANES / 4];
+    for (__m256d& l : lanes) {
+        l = _mm256_setzero_pd();
+    }
+    size_t i = 0;
+    for (; i + DOT_LANES <= size; i += DOT_LANES) {
+        for (size_t k = 0; k < DOT_LANES / 4; ++k) {
+            lanes[k] = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(&a[i + 4 * k])),
+                                       _mm256_cvtps_pd(_mm_loadu_ps(&b[i + 4 * k])), lanes[k]);
+        }
+    }
+    alignas(32) double sums[DOT_LANES];
+    for (size_t k = 0; k < DOT_LANES / 4; ++k) {
+        _mm256_store_pd(&sums[4 * k], lanes[k]);
+    }
+    for (; i < size; ++i) {
+        sums[i % DOT_LANES] += static_cast<double>(a[i]) * b[i];
+    }
+    return fold_dot_lanes(sums);
+}
+
+// Обходить початкові позиції від start і викликає sink(pos) для кожного входження.
+// Кандидати відбираються по 32 позицій за раз за двома опорними байтами (див. SearchPattern),
+// повне порівняння запускається лише для тих, де збіглися обидва.
+// Якщо sink повертає false, повертає позицію після цього входження, інакше str_len.
+template <typename Sink>
+size_t scan_substring(const char* str, size_t str_len, const SearchPattern& pattern, size_t start, Sink sink) {
+    if (pattern.len == 0 || str_len < pattern.len) {
+        return str_len;
+    }
+    const size_t last = str_len - pattern.len + 1;  // Кількість можливих початкових позицій
+    const SubstringAnchors anchors = pattern.anchors;
+    const char* first = str + anchors.first;
+    const char* second = str + anchors.second;
+    const __m256i c1 = _mm256_set1_epi8(static_cast<char>(pattern.bytes[anchors.first]));
+    const __m256i c2 = _mm256_set1_epi8(static_cast<char>(pattern.bytes[anchors.second]));
+    const __m256i f1 = _mm256_set1_epi8(static_cast<char>(pattern.fold[anchors.first]));
+    const __m256i f2 = _mm256_set1_epi8(static_cast<char>(pattern.fold[anchors.second]));
+    const size_t blocks = (pattern.len + 31) / 32;
+    size_t i = start;
+    size_t resume = str_len;
+
+    // Повне порівняння кандидата регістрами; у кінці тексту, де регістр вийшов би за межу, — побайтово
+    auto verify = [&](size_t pos) {
+        if (pos + 32 * blocks > str_len) {
+            return pattern.matches(str + pos);
+        }
+        for (size_t b = 0; b < blocks; ++b) {
+            const __m256i text = _mm256_loadu_si256((const __m256i*)(str + pos + 32 * b));
+            const __m256i fold = _mm256_loadu_si256((const __m256i*)(pattern.fold + 32 * b));
+            const __m256i bytes = _mm256_loadu_si256((const __m256i*)(pattern.bytes + 32 * b));
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_or_si256(text, fold), bytes)) != -1) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Обходить кандидатів у масці блоку, що починається з base; false — sink зупинив пошук
+    auto visit = [&](size_t base, uint32_t mask) {
+        while (mask) {
+            const size_t pos = base + ctz32(mask);
+            if ((!pattern.verify || verify(pos)) && !sink(pos)) {
+                resume = pos + 1;
+                return false;
+            }
+            mask &= mask - 1;
+        }
+        return true;
+    };
+
+    // Блок кандидатів обробляється, доки всі його позиції можуть вмістити шаблон
+    for (; i + 32 <= last; i += 32) {
+        const __m256i eq1 = _mm256_cmpeq_epi8(_mm256_or_si256(_mm256_loadu_si256((const __m256i*)(first + i)), f1), c1);
+        const __m256i eq2 = _mm256_cmpeq_epi8(_mm256_or_si256(_mm256_loadu_si256((const __m256i*)(second + i)), f2), c2);
+        if (!visit(i, static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(eq1, eq2))))) {
+            return resume;
+        }
+    }
+
+    for (; i < last; ++i) {
+        if (pattern.byte_matches(str[i + anchors.first], anchors.first) &&
+            pattern.byte_matches(str[i + anchors.second], anchors.second) && !visit(i, 1)) {
+            return resume;
+        }
+    }
+    return str_len;
+}
+
+size_t count_substring_avx2(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                             const MatchOptions& options) {
+    size_t count = 0;
+    scan_substring(str, str_len, SearchPattern(substr, substr_len, options), 0, [&](size_t) {
+        ++count;
+        return true;
+    });
+    return count;
+}
+
+size_t find_all_avx2(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                      size_t* positions, size_t capacity, size_t& cursor, const MatchOptions& options) {
+    if (capacity == 0) {
+        return 0;
+    }
+    size_t found = 0;
+    cursor = scan_substring(str, str_len, SearchPattern(substr, substr_len, options), cursor, [&](size_t pos) {
+        positions[found++] = pos;
+        return found < capacity;
+    });
+    return found;
+}
+
+}  // namespace
+
+const KernelTable avx2_kernels = {
+    CpuTier::AVX2,
+    add_i32_avx2,
+    add_f32_avx2,
+    mul_f32_avx2,
+    fma_f32_avx2,
+    add_i32_stream_avx2,
+    add_f32_stream_avx2,
+    mul_f32_stream_avx2,
+    dot_f32_avx2,
+    dot_f32_compensated_avx2,
+    dot_f32_lanes_avx2,
+    count_substring_avx2,
+    find_all_avx2,
+};
+
+}  // namespace simd
+
+#include "target_end.h"
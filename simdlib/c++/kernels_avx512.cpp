@@ -0,0 +1,320 @@
+﻿#include <immintrin.h>
+#include <cstdint>
+
+#include "bit_ops.h"
+#include "kernels_internal.h"
+
+#include "target_avx512.h"
+
+// Реалізації на 512-бітних регістрах: 16 елементів int/float або 64 байти за раз.
+// Залишок обробляється маскованими завантаженнями замість скалярного циклу.
+namespace simd {
+
+namespace {
+
+// Наскільки наперед (у байтах) підтягуються вхідні дані в потоковому режимі
+const size_t PREFETCH_DISTANCE = 1024;
+
+// Маска для останніх remaining (< 16) елементів
+__mmask16 tail_mask(size_t remaining) {
+    return static_cast<__mmask16>((1u << remaining) - 1);
+}
+
+void add_i32_avx512(const int* a, const int* b, int* result, size_t size) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m512i va = _mm512_loadu_si512(&a[i]);
+        __m512i vb = _mm512_loadu_si512(&b[i]);
+        _mm512_storeu_si512(&result[i], _mm512_add_epi32(va, vb));
+    }
+    if (i < size) {
+        __mmask16 m = tail_mask(size - i);
+        __m512i va = _mm512_maskz_loadu_epi32(m, &a[i]);
+        __m512i vb = _mm512_maskz_loadu_epi32(m, &b[i]);
+        _mm512_mask_storeu_epi32(&result[i], m, _mm512_add_epi32(va, vb));
+    }
+}
+
+void add_f32_avx512(const float* a, const float* b, float* result, size_t size) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        _mm512_storeu_ps(&result[i], _mm512_add_ps(_mm512_loadu_ps(&a[i]), _mm512_loadu_ps(&b[i])));
+    }
+    if (i < size) {
+        __mmask16 m = tail_mask(size - i);
+        __m512 va = _mm512_maskz_loadu_ps(m, &a[i]);
+        __m512 vb = _mm512_maskz_loadu_ps(m, &b[i]);
+        _mm512_mask_storeu_ps(&result[i], m, _mm512_add_ps(va, vb));
+    }
+}
+
+void mul_f32_avx512(const float* a, const float* b, float* result, size_t size) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        _mm512_storeu_ps(&result[i], _mm512_mul_ps(_mm512_loadu_ps(&a[i]), _mm512_loadu_ps(&b[i])));
+    }
+    if (i < size) {
+        __mmask16 m = tail_mask(size - i);
+        __m512 va = _mm512_maskz_loadu_ps(m, &a[i]);
+        __m512 vb = _mm512_maskz_loadu_ps(m, &b[i]);
+        _mm512_mask_storeu_ps(&result[i], m, _mm512_mul_ps(va, vb));
+    }
+}
+
+void fma_f32_avx512(const float* a, const float* b, const float* c, float* result, size_t size) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        _mm512_storeu_ps(&result[i], _mm512_fmadd_ps(_mm512_loadu_ps(&a[i]), _mm512_loadu_ps(&b[i]), _mm512_loadu_ps(&c[i])));
+    }
+    if (i < size) {
+        __mmask16 m = tail_mask(size - i);
+        __m512 v = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, &a[i]), _mm512_maskz_loadu_ps(m, &b[i]), _mm512_maskz_loadu_ps(m, &c[i]));
+        _mm512_mask_storeu_ps(&result[i], m, v);
+    }
+}
+
+// Потоковий варіант: результат пишеться vmovntdq (_mm512_stream_si512) в обхід кешу, входи підтягуються
+// prefetch за PREFETCH_DISTANCE байтів наперед. Такі записи вимагають вирівняної на 64 байти
+// адреси, тож голова до межі рахується звичайно. Op::vec(pa, pb) повертає __m512i для 64 / sizeof(T) елементів.
+template <typename Op, typename T>
+void stream_binary(const T* a, const T* b, T* result, size_t size) {
+    size_t i = 0;
+    for (; i < size && reinterpret_cast<uintptr_t>(result + i) % 64 != 0; ++i) {
+        result[i] = Op::scalar(a[i], b[i]);
+    }
+    for (; i + 64 / sizeof(T) <= size; i += 64 / sizeof(T)) {
+        _mm_prefetch(reinterpret_cast<const char*>(a + i) + PREFETCH_DISTANCE, _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(b + i) + PREFETCH_DISTANCE, _MM_HINT_T0);
+        _mm512_stream_si512((__m512i*)(result + i), Op::vec(a + i, b + i));
+    }
+    for (; i < size; ++i) {
+        result[i] = Op::scalar(a[i], b[i]);
+    }
+    _mm_sfence();  // Потокові записи слабко впорядковані: робимо їх видимими до повернення
+}
+
+struct AddI32 {
+    static __m512i vec(const int* pa, const int* pb) {
+        return _mm512_add_epi32(_mm512_loadu_si512(pa), _mm512_loadu_si512(pb));
+    }
+    static int scalar(int x, int y) { return x + y; }
+};
+
+struct AddF32 {
+    static __m512i vec(const float* pa, const float* pb) {
+        return _mm512_castps_si512(_mm512_add_ps(_mm512_loadu_ps(pa), _mm512_loadu_ps(pb)));
+    }
+    static float scalar(float x, float y) { return x + y; }
+};
+
+struct MulF32 {
+    static __m512i vec(const float* pa, const float* pb) {
+        return _mm512_castps_si512(_mm512_mul_ps(_mm512_loadu_ps(pa), _mm512_loadu_ps(pb)));
+    }
+    static float scalar(float x, float y) { return x * y; }
+};
+
+void add_i32_stream_avx512(const int* a, const int* b, int* result, size_t size) {
+    stream_binary<AddI32>(a, b, result, size);
+}
+
+void add_f32_stream_avx512(const float* a, const float* b, float* result, size_t size) {
+    stream_binary<AddF32>(a, b, result, size);
+}
+
+void mul_f32_stream_avx512(const float* a, const float* b, float* result, size_t size) {
+    stream_binary<MulF32>(a, b, result, size);
+}
+
+// Чотири незалежні FMA-акумулятори, щоб латентність FMA не обмежувала пропускну здатність
+float dot_f32_avx512(const float* a, const float* b, size_t size) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    __m512 acc2 = _mm512_setzero_ps();
+    __m512 acc3 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(&a[i]), _mm512_loadu_ps(&b[i]), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(&a[i + 16]), _mm512_loadu_ps(&b[i + 16]), acc1);
+        acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(&a[i + 32]), _mm512_loadu_ps(&b[i + 32]), acc2);
+        acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(&a[i + 48]), _mm512_loadu_ps(&b[i + 48]), acc3);
+    }
+    for (; i + 16 <= size; i += 16) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(&a[i]), _mm512_loadu_ps(&b[i]), acc0);
+    }
+    if (i < size) {
+        __mmask16 m = tail_mask(size - i);
+        acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, &a[i]), _mm512_maskz_loadu_ps(m, &b[i]), acc1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+}
+
+// Крок Dot2 для шістнадцяти смуг: точна похибка добутку — fmsub(a, b, p), суми — TwoSum
+void dot2_step(__m512 va, __m512 vb, __m512& s, __m512& c) {
+    const __m512 p = _mm512_mul_ps(va, vb);
+    const __m512 ep = _mm512_fmsub_ps(va, vb, p);
+    const __m512 sum = _mm512_add_ps(s, p);
+    const __m512 z = _mm512_sub_ps(sum, s);
+    const __m512 es = _mm512_add_ps(_mm512_sub_ps(s, _mm512_sub_ps(sum, z)), _mm512_sub_ps(p, z));
+    c = _mm512_add_ps(c, _mm512_add_ps(es, ep));
+    s = sum;
+}
+
+float dot_f32_compensated_avx512(const float* a, const float* b, size_t size) {
+    __m512 s0 = _mm512_setzero_ps(), c0 = _mm512_setzero_ps();
+    __m512 s1 = _mm512_setzero_ps(), c1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        dot2_step(_mm512_loadu_ps(&a[i]), _mm512_loadu_ps(&b[i]), s0, c0);
+        dot2_step(_mm512_loadu_ps(&a[i + 16]), _mm512_loadu_ps(&b[i + 16]), s1, c1);
+    }
+    // Масковані нулі в залишку не змінюють ні суми, ні поправки
+    for (; i < size; i += 16) {
+        __mmask16 m = size - i >= 16 ? static_cast<__mmask16>(0xFFFF) : tail_mask(size - i);
+        dot2_step(_mm512_maskz_loadu_ps(m, &a[i]), _mm512_maskz_loadu_ps(m, &b[i]), s0, c0);
+    }
+
+    alignas(64) float sums[32], corrections[32];
+    _mm512_store_ps(sums, s0);
+    _mm512_store_ps(sums + 16, s1);
+    _mm512_store_ps(corrections, c0);
+    _mm512_store_ps(corrections + 16, c1);
+    return sum_compensated(sums, corrections, 32);
+}
+
+// Смуги 0..7 — у lo, 8..15 — у hi; добуток float у double точний, тож FMA дає те саме, що mul + add
+double dot_f32_lanes_avx512(const float* a, const float* b, size_t size) {
+    __m512d lo = _mm512_setzero_pd();
+    __m512d hi = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + DOT_LANES <= size; i += DOT_LANES) {
+        const __m512 va = _mm512_loadu_ps(&a[i]);
+        const __m512 vb = _mm512_loadu_ps(&b[i]);
+        lo = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm512_castps512_ps256(va)),
+                             _mm512_cvtps_pd(_mm512_castps512_ps256(vb)), lo);
+        hi = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(va), 1))),
+                             _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(vb), 1))), hi);
+    }
+    alignas(64) double sums[DOT_LANES];
+    _mm512_store_pd(sums, lo);
+    _mm512_store_pd(sums + 8, hi);
+    for (; i < size; ++i) {
+        sums[i % DOT_LANES] += static_cast<double>(a[i]) * b[i];
+    }
+    return fold_dot_lanes(sums);
+}
+
+// Обходить початкові позиції від start і викликає sink(pos) для кожного входження.
+// Кандидати відбираються по 64 позицій за раз за двома опорними байтами (див. SearchPattern),
+// повне порівняння запускається лише для тих, де збіглися обидва.
+// Якщо sink повертає false, повертає позицію після цього входження, інакше str_len.
+template <typename Sink>
+size_t scan_substring(const char* str, size_t str_len, const SearchPattern& pattern, size_t start, Sink sink) {
+    if (pattern.len == 0 || str_len < pattern.len) {
+        return str_len;
+    }
+    const size_t last = str_len - pattern.len + 1;  // Кількість можливих початкових позицій
+    const SubstringAnchors anchors = pattern.anchors;
+    const char* first = str + anchors.first;
+    const char* second = str + anchors.second;
+    const __m512i c1 = _mm512_set1_epi8(static_cast<char>(pattern.bytes[anchors.first]));
+    const __m512i c2 = _mm512_set1_epi8(static_cast<char>(pattern.bytes[anchors.second]));
+    const __m512i f1 = _mm512_set1_epi8(static_cast<char>(pattern.fold[anchors.first]));
+    const __m512i f2 = _mm512_set1_epi8(static_cast<char>(pattern.fold[anchors.second]));
+    size_t i = start;
+    size_t resume = str_len;
+
+    // Повне порівняння кандидата: байти тексту за межами шаблону не читаються (маска), тож і в кінці
+    // тексту порівняння йде регістрами; доповнення шаблону (fold 0xFF) збігається з нулями маски
+    auto verify = [&](size_t pos) {
+        for (size_t b = 0; b < pattern.len; b += 64) {
+            const size_t count = pattern.len - b;
+            const __mmask64 valid = count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+            const __m512i text = _mm512_maskz_loadu_epi8(valid, str + pos + b);
+            const __m512i fold = _mm512_loadu_si512(pattern.fold + b);
+            const __m512i bytes = _mm512_loadu_si512(pattern.bytes + b);
+            if (_mm512_cmpneq_epi8_mask(_mm512_or_si512(text, fold), bytes) != 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Обходить кандидатів у масці блоку, що починається з base; false — sink зупинив пошук
+    auto visit = [&](size_t base, uint64_t mask) {
+        while (mask) {
+            const size_t pos = base + ctz64(mask);
+            if ((!pattern.verify || verify(pos)) && !sink(pos)) {
+                resume = pos + 1;
+                return false;
+            }
+            mask &= mask - 1;
+        }
+        return true;
+    };
+
+    // Блок кандидатів обробляється, доки всі його позиції можуть вмістити шаблон
+    for (; i + 64 <= last; i += 64) {
+        const __mmask64 eq1 = _mm512_cmpeq_epi8_mask(_mm512_or_si512(_mm512_loadu_si512(first + i), f1), c1);
+        if (!visit(i, _mm512_mask_cmpeq_epi8_mask(eq1, _mm512_or_si512(_mm512_loadu_si512(second + i), f2), c2))) {
+            return resume;
+        }
+    }
+
+    // Останній неповний блок: масковані завантаження не читають за межами рядка
+    if (i < last) {
+        const __mmask64 valid = (uint64_t(1) << (last - i)) - 1;
+        const __m512i text1 = _mm512_or_si512(_mm512_maskz_loadu_epi8(valid, first + i), f1);
+        const __m512i text2 = _mm512_or_si512(_mm512_maskz_loadu_epi8(valid, second + i), f2);
+        const __mmask64 eq1 = _mm512_mask_cmpeq_epi8_mask(valid, text1, c1);
+        if (!visit(i, _mm512_mask_cmpeq_epi8_mask(eq1, text2, c2))) {
+            return resume;
+        }
+    }
+    return str_len;
+}
+
+size_t count_substring_avx512(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                               const MatchOptions& options) {
+    size_t count = 0;
+    scan_substring(str, str_len, SearchPattern(substr, substr_len, options), 0, [&](size_t) {
+        ++count;
+        return true;
+    });
+    return count;
+}
+
+size_t find_all_avx512(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                        size_t* positions, size_t capacity, size_t& cursor, const MatchOptions& options) {
+    if (capacity == 0) {
+        return 0;
+    }
+    size_t found = 0;
+    cursor = scan_substring(str, str_len, SearchPattern(substr, substr_len, options), cursor, [&](size_t pos) {
+        positions[found++] = pos;
+        return found < capacity;
+    });
+    return found;
+}
+
+}  // namespace
+
+const KernelTable avx512_kernels = {
+    CpuTier::AVX512,
+    add_i32_avx512,
+    add_f32_avx512,
+    mul_f32_avx512,
+    fma_f32_avx512,
+    add_i32_stream_avx512,
+    add_f32_stream_avx512,
+    mul_f32_stream_avx512,
+    dot_f32_avx512,
+    dot_f32_compensated_avx512,
+    dot_f32_lanes_avx512,
+    count_substring_avx512,
+    find_all_avx512,
+};
+
+}  // namespace simd
+
+#include "target_end.h"
@@ -0,0 +1,67 @@
+﻿#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "kernels.h"
+
+// Таблиці, визначені в kernels_<рівень>.cpp. Використовуються лише диспетчером.
+namespace simd {
+
+extern const KernelTable scalar_kernels;
+extern const KernelTable sse42_kernels;
+extern const KernelTable avx2_kernels;
+extern const KernelTable avx512_kernels;
+
+// Кількість смуг dot_f32_lanes: елемент i завжди додається в смугу i % DOT_LANES
+const size_t DOT_LANES = 16;
+
+// Згортає смуги dot_f32_lanes у фіксованому порядку (lanes[j] += lanes[j + w] для w = 8, 4, 2, 1).
+// Усі рівні викликають саме її, тож порядок додавань не залежить від ширини регістрів.
+double fold_dot_lanes(double* lanes);
+
+// Компенсована сума count часткових сум і окремо сума їхніх поправок (завершення Dot2)
+float sum_compensated(const float* sums, const float* corrections, size_t count);
+
+// Два опорні байти шаблону для фільтра кандидатів у пошуку підрядка
+struct SubstringAnchors {
+    size_t first;
+    size_t second;  // Збігається з first лише для шаблону з одного байта
+};
+
+// До кратного цього розміру доповнюються масиви SearchPattern (найширший регістр)
+const size_t SEARCH_PATTERN_BLOCK = 64;
+
+// Шаблон пошуку підрядка, підготовлений для MatchOptions. Байт тексту t відповідає позиції j шаблону,
+// якщо (t | fold[j]) == bytes[j]: точний байт — fold 0; літера без урахування регістру — fold 0x20
+// і мала літера (t | 0x20 дає малу літеру лише для неї самої та її великої пари); '?' — fold і bytes 0xFF.
+// Тож одне порівняння в регістрі обслуговує всі режими. Масиви доповнені 0xFF до кратного
+// SEARCH_PATTERN_BLOCK, щоб повну перевірку можна було робити цілими регістрами. Шаблон до
+// SEARCH_PATTERN_BLOCK байтів зберігається в самій структурі: find_all із малим буфером
+// будує його на кожному виклику, і виділення в купі тоді коштувало б більше за сам пошук.
+struct SearchPattern {
+    size_t len;
+    uint8_t* bytes;  // Указують у inline_ або heap_
+    uint8_t* fold;
+
+    // Два найрідші (за типовою частотою байтів у тексті) різні конкретні байти шаблону.
+    // Кандидат має збігтися з обома, тож повне порівняння запускається рідко навіть тоді,
+    // коли перший символ шаблону в тексті частий.
+    SubstringAnchors anchors = { 0, 0 };
+    bool verify = false;  // Опори покривають не всі конкретні (не '?') байти
+
+    SearchPattern(const char* substr, size_t substr_len, const MatchOptions& options);
+
+    SearchPattern(const SearchPattern&) = delete;
+    SearchPattern& operator=(const SearchPattern&) = delete;
+
+    bool byte_matches(char c, size_t j) const { return (static_cast<uint8_t>(c) | fold[j]) == bytes[j]; }
+
+    // Побайтове повне порівняння з текстом, що починається з text
+    bool matches(const char* text) const;
+
+private:
+    alignas(SEARCH_PATTERN_BLOCK) uint8_t inline_[2 * SEARCH_PATTERN_BLOCK];
+    std::vector<uint8_t> heap_;  // Довші шаблони: bytes, потім fold
+};
+
+}  // namespace simd
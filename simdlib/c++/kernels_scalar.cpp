@@ -0,0 +1,127 @@
+﻿#include "kernels_internal.h"
+
+// Звичайні реалізації без явного SIMD. Використовуються на процесорах без SSE4.2
+// і як еталон для перевірки векторних версій.
+namespace simd {
+
+namespace {
+
+void add_i32_scalar(const int* a, const int* b, int* result, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = a[i] + b[i];
+    }
+}
+
+void add_f32_scalar(const float* a, const float* b, float* result, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = a[i] + b[i];
+    }
+}
+
+void mul_f32_scalar(const float* a, const float* b, float* result, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = a[i] * b[i];
+    }
+}
+
+// Без апаратного FMA: два округлення (множення й додавання)
+void fma_f32_scalar(const float* a, const float* b, const float* c, float* result, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = a[i] * b[i] + c[i];
+    }
+}
+
+float dot_f32_scalar(const float* a, const float* b, size_t size) {
+    float dot = 0.0f;
+    for (size_t i = 0; i < size; ++i) {
+        dot += a[i] * b[i];
+    }
+    return dot;
+}
+
+// Dot2: похибка кожного добутку й кожного додавання накопичується в c.
+// Без FMA точний добуток двох float береться з double (48 значущих бітів вміщуються в 53).
+float dot_f32_compensated_scalar(const float* a, const float* b, size_t size) {
+    float s = 0.0f;
+    float c = 0.0f;
+    for (size_t i = 0; i < size; ++i) {
+        const double exact = static_cast<double>(a[i]) * b[i];
+        const float p = static_cast<float>(exact);
+        const float t = s + p;
+        const float z = t - s;
+        c += ((s - (t - z)) + (p - z)) + static_cast<float>(exact - p);
+        s = t;
+    }
+    return s + c;
+}
+
+double dot_f32_lanes_scalar(const float* a, const float* b, size_t size) {
+    double lanes[DOT_LANES] = {};
+    for (size_t i = 0; i < size; ++i) {
+        lanes[i % DOT_LANES] += static_cast<double>(a[i]) * b[i];
+    }
+    return fold_dot_lanes(lanes);
+}
+
+// Обходить початкові позиції від start і викликає sink(pos) для кожного входження.
+// Повне порівняння запускається лише тоді, коли збіглися обидва опорні байти.
+// Якщо sink повертає false, повертає позицію після цього входження, інакше str_len.
+template <typename Sink>
+size_t scan_substring(const char* str, size_t str_len, const SearchPattern& pattern, size_t start, Sink sink) {
+    if (pattern.len == 0 || str_len < pattern.len) {
+        return str_len;
+    }
+    const size_t last = str_len - pattern.len + 1;  // Кількість можливих початкових позицій
+    const SubstringAnchors anchors = pattern.anchors;
+    for (size_t i = start; i < last; ++i) {
+        if (pattern.byte_matches(str[i + anchors.first], anchors.first) &&
+            pattern.byte_matches(str[i + anchors.second], anchors.second) &&
+            (!pattern.verify || pattern.matches(str + i)) && !sink(i)) {
+            return i + 1;
+        }
+    }
+    return str_len;
+}
+
+size_t count_substring_scalar(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                               const MatchOptions& options) {
+    size_t count = 0;
+    scan_substring(str, str_len, SearchPattern(substr, substr_len, options), 0, [&](size_t) {
+        ++count;
+        return true;
+    });
+    return count;
+}
+
+size_t find_all_scalar(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                        size_t* positions, size_t capacity, size_t& cursor, const MatchOptions& options) {
+    if (capacity == 0) {
+        return 0;
+    }
+    size_t found = 0;
+    cursor = scan_substring(str, str_len, SearchPattern(substr, substr_len, options), cursor, [&](size_t pos) {
+        positions[found++] = pos;
+        return found < capacity;
+    });
+    return found;
+}
+
+}  // namespace
+
+const KernelTable scalar_kernels = {
+    CpuTier::Scalar,
+    add_i32_scalar,
+    add_f32_scalar,
+    mul_f32_scalar,
+    fma_f32_scalar,
+    add_i32_scalar,  // Без SIMD потокових записів немає: звичайні версії
+    add_f32_scalar,
+    mul_f32_scalar,
+    dot_f32_scalar,
+    dot_f32_compensated_scalar,
+    dot_f32_lanes_scalar,
+    count_substring_scalar,
+    find_all_scalar,
+};
+
+}  // namespace simd
@@ -0,0 +1,338 @@
+﻿#include <immintrin.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "bit_ops.h"
+#include "kernels_internal.h"
+
+#include "target_sse42.h"
+
+// Реалізації на 128-бітних регістрах: 4 елементи int/float або 16 байтів за раз
+namespace simd {
+
+namespace {
+
+// Наскільки наперед (у байтах) підтягуються вхідні дані в потоковому режимі
+const size_t PREFETCH_DISTANCE = 1024;
+
+void add_i32_sse42(const int* a, const int* b, int* result, size_t size) {
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i*)&a[i]);
+        __m128i vb = _mm_loadu_si128((const __m128i*)&b[i]);
+        _mm_storeu_si128((__m128i*)&result[i], _mm_add_epi32(va, vb));
+    }
+    for (; i < size; ++i) {
+        result[i] = a[i] + b[i];
+    }
+}
+
+void add_f32_sse42(const float* a, const float* b, float* result, size_t size) {
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        _mm_storeu_ps(&result[i], _mm_add_ps(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i])));
+    }
+    for (; i < size; ++i) {
+        result[i] = a[i] + b[i];
+    }
+}
+
+void mul_f32_sse42(const float* a, const float* b, float* result, size_t size) {
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        _mm_storeu_ps(&result[i], _mm_mul_ps(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i])));
+    }
+    for (; i < size; ++i) {
+        result[i] = a[i] * b[i];
+    }
+}
+
+// FMA на цьому рівні немає: множення й додавання з двома округленнями
+void fma_f32_sse42(const float* a, const float* b, const float* c, float* result, size_t size) {
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128 product = _mm_mul_ps(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i]));
+        _mm_storeu_ps(&result[i], _mm_add_ps(product, _mm_loadu_ps(&c[i])));
+    }
+    for (; i < size; ++i) {
+        result[i] = a[i] * b[i] + c[i];
+    }
+}
+
+// Потоковий варіант: результат пишеться movntdq (_mm_stream_si128) в обхід кешу, входи підтягуються
+// prefetch за PREFETCH_DISTANCE байтів наперед. Такі записи вимагають вирівняної на 16 байтів
+// адреси, тож голова до межі рахується звичайно. Op::vec(pa, pb) повертає __m128i для 16 / sizeof(T) елементів.
+template <typename Op, typename T>
+void stream_binary(const T* a, const T* b, T* result, size_t size) {
+    size_t i = 0;
+    for (; i < size && reinterpret_cast<uintptr_t>(result + i) % 16 != 0; ++i) {
+        result[i] = Op::scalar(a[i], b[i]);
+    }
+    const size_t lanes = 16 / sizeof(T);
+    for (; i + 64 / sizeof(T) <= size; i += 64 / sizeof(T)) {
+        _mm_prefetch(reinterpret_cast<const char*>(a + i) + PREFETCH_DISTANCE, _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(b + i) + PREFETCH_DISTANCE, _MM_HINT_T0);
+        _mm_stream_si128((__m128i*)(result + i), Op::vec(a + i, b + i));
+        _mm_stream_si128((__m128i*)(result + i + lanes), Op::vec(a + i + lanes, b + i + lanes));
+        _mm_stream_si128((__m128i*)(result + i + 2 * lanes), Op::vec(a + i + 2 * lanes, b + i + 2 * lanes));
+        _mm_stream_si128((__m128i*)(result + i + 3 * lanes), Op::vec(a + i + 3 * lanes, b + i + 3 * lanes));
+    }
+    for (; i < size; ++i) {
+        result[i] = Op::scalar(a[i], b[i]);
+    }
+    _mm_sfence();  // Потокові записи слабко впорядковані: робимо їх видимими до повернення
+}
+
+struct AddI32 {
+    static __m128i vec(const int* pa, const int* pb) {
+        return _mm_add_epi32(_mm_loadu_si128((const __m128i*)pa),
+                             _mm_loadu_si128((const __m128i*)pb));
+    }
+    static int scalar(int x, int y) { return x + y; }
+};
+
+struct AddF32 {
+    static __m128i vec(const float* pa, const float* pb) {
+        return _mm_castps_si128(_mm_add_ps(_mm_loadu_ps(pa), _mm_loadu_ps(pb)));
+    }
+    static float scalar(float x, float y) { return x + y; }
+};
+
+struct MulF32 {
+    static __m128i vec(const float* pa, const float* pb) {
+        return _mm_castps_si128(_mm_mul_ps(_mm_loadu_ps(pa), _mm_loadu_ps(pb)));
+    }
+    static float scalar(float x, float y) { return x * y; }
+};
+
+void add_i32_stream_sse42(const int* a, const int* b, int* result, size_t size) {
+    stream_binary<AddI32>(a, b, result, size);
+}
+
+void add_f32_stream_sse42(const float* a, const float* b, float* result, size_t size) {
+    stream_binary<AddF32>(a, b, result, size);
+}
+
+void mul_f32_stream_sse42(const float* a, const float* b, float* result, size_t size) {
+    stream_binary<MulF32>(a, b, result, size);
+}
+
+// Горизонтальна сума чотирьох елементів у регістрі
+float hsum(__m128 v) {
+    __m128 shuf = _mm_movehdup_ps(v);
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+}
+
+// Чотири незалежні акумулятори, щоб додавання не чекали одне на одне
+float dot_f32_sse42(const float* a, const float* b, size_t size) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps();
+    __m128 acc3 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i])));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(&a[i + 4]), _mm_loadu_ps(&b[i + 4])));
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(&a[i + 8]), _mm_loadu_ps(&b[i + 8])));
+        acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(&a[i + 12]), _mm_loadu_ps(&b[i + 12])));
+    }
+    for (; i + 4 <= size; i += 4) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i])));
+    }
+    float dot = hsum(_mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+
+    for (; i < size; ++i) {
+        dot += a[i] * b[i];
+    }
+    return dot;
+}
+
+// Крок Dot2 для чотирьох смуг: s + c накопичують суму добутків із подвійною точністю.
+// FMA на цьому рівні немає, тому точна похибка добутку рахується розщепленням Вельткампа
+// (множники розбиваються на старші й молодші 12 бітів; |x| < 2^115, інакше множення на 4097 переповниться).
+void dot2_step(__m128 va, __m128 vb, __m128& s, __m128& c) {
+    const __m128 split = _mm_set1_ps(4097.0f);
+    const __m128 p = _mm_mul_ps(va, vb);
+    __m128 t = _mm_mul_ps(va, split);
+    const __m128 a_hi = _mm_sub_ps(t, _mm_sub_ps(t, va));
+    const __m128 a_lo = _mm_sub_ps(va, a_hi);
+    t = _mm_mul_ps(vb, split);
+    const __m128 b_hi = _mm_sub_ps(t, _mm_sub_ps(t, vb));
+    const __m128 b_lo = _mm_sub_ps(vb, b_hi);
+    __m128 ep = _mm_sub_ps(_mm_mul_ps(a_hi, b_hi), p);
+    ep = _mm_add_ps(ep, _mm_mul_ps(a_hi, b_lo));
+    ep = _mm_add_ps(ep, _mm_mul_ps(a_lo, b_hi));
+    ep = _mm_add_ps(ep, _mm_mul_ps(a_lo, b_lo));
+
+    const __m128 sum = _mm_add_ps(s, p);
+    const __m128 z = _mm_sub_ps(sum, s);
+    const __m128 es = _mm_add_ps(_mm_sub_ps(s, _mm_sub_ps(sum, z)), _mm_sub_ps(p, z));
+    c = _mm_add_ps(c, _mm_add_ps(es, ep));
+    s = sum;
+}
+
+float dot_f32_compensated_sse42(const float* a, const float* b, size_t size) {
+    __m128 s0 = _mm_setzero_ps(), c0 = _mm_setzero_ps();
+    __m128 s1 = _mm_setzero_ps(), c1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        dot2_step(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i]), s0, c0);
+        dot2_step(_mm_loadu_ps(&a[i + 4]), _mm_loadu_ps(&b[i + 4]), s1, c1);
+    }
+    // Залишок доповнюємо нулями: нульові добутки не змінюють ні суми, ні поправки
+    for (; i < size; i += 4) {
+        float ta[4] = {}, tb[4] = {};
+        memcpy(ta, &a[i], std::min<size_t>(4, size - i) * sizeof(float));
+        memcpy(tb, &b[i], std::min<size_t>(4, size - i) * sizeof(float));
+        dot2_step(_mm_loadu_ps(ta), _mm_loadu_ps(tb), s0, c0);
+    }
+
+    alignas(16) float sums[8], corrections[8];
+    _mm_store_ps(sums, s0);
+    _mm_store_ps(sums + 4, s1);
+    _mm_store_ps(corrections, c0);
+    _mm_store_ps(corrections + 4, c1);
+    return sum_compensated(sums, corrections, 8);
+}
+
+// Смуги 2k і 2k + 1 — у lanes[k]; добутки точні в double, тож mul + add не округлює добуток
+double dot_f32_lanes_sse42(const float* a, const float* b, size_t size) {
+    __m128d lanes[DOT_LANES / 2];
+    for (__m128d& l : lanes) {
+        l = _mm_setzero_pd();
+    }
+    size_t i = 0;
+    for (; i + DOT_LANES <= size; i += DOT_LANES) {
+        for (size_t k = 0; k < DOT_LANES / 4; ++k) {
+            const __m128 va = _mm_loadu_ps(&a[i + 4 * k]);
+            const __m128 vb = _mm_loadu_ps(&b[i + 4 * k]);
+            lanes[2 * k] = _mm_add_pd(lanes[2 * k], _mm_mul_pd(_mm_cvtps_pd(va), _mm_cvtps_pd(vb)));
+            lanes[2 * k + 1] = _mm_add_pd(lanes[2 * k + 1],
+                _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(va, va)), _mm_cvtps_pd(_mm_movehl_ps(vb, vb))));
+        }
+    }
+    alignas(16) double sums[DOT_LANES];
+    for (size_t k = 0; k < DOT_LANES / 2; ++k) {
+        _mm_store_pd(&sums[2 * k], lanes[k]);
+    }
+    for (; i < size; ++i) {
+        sums[i % DOT_LANES] += static_cast<double>(a[i]) * b[i];
+    }
+    return fold_dot_lanes(sums);
+}
+
+// Обходить початкові позиції від start і викликає sink(pos) для кожного входження.
+// Кандидати відбираються по 16 позицій за раз за двома опорними байтами (див. SearchPattern),
+// повне порівняння запускається лише для тих, де збіглися обидва.
+// Якщо sink повертає false, повертає позицію після цього входження, інакше str_len.
+template <typename Sink>
+size_t scan_substring(const char* str, size_t str_len, const SearchPattern& pattern, size_t start, Sink sink) {
+    if (pattern.len == 0 || str_len < pattern.len) {
+        return str_len;
+    }
+    const size_t last = str_len - pattern.len + 1;  // Кількість можливих початкових позицій
+    const SubstringAnchors anchors = pattern.anchors;
+    const char* first = str + anchors.first;
+    const char* second = str + anchors.second;
+    const __m128i c1 = _mm_set1_epi8(static_cast<char>(pattern.bytes[anchors.first]));
+    const __m128i c2 = _mm_set1_epi8(static_cast<char>(pattern.bytes[anchors.second]));
+    const __m128i f1 = _mm_set1_epi8(static_cast<char>(pattern.fold[anchors.first]));
+    const __m128i f2 = _mm_set1_epi8(static_cast<char>(pattern.fold[anchors.second]));
+    const size_t blocks = (pattern.len + 15) / 16;
+    size_t i = start;
+    size_t resume = str_len;
+
+    // Повне порівняння кандидата регістрами; у кінці тексту, де регістр вийшов би за межу, — побайтово
+    auto verify = [&](size_t pos) {
+        if (pos + 16 * blocks > str_len) {
+            return pattern.matches(str + pos);
+        }
+        for (size_t b = 0; b < blocks; ++b) {
+            const __m128i text = _mm_loadu_si128((const __m128i*)(str + pos + 16 * b));
+            const __m128i fold = _mm_loadu_si128((const __m128i*)(pattern.fold + 16 * b));
+            const __m128i bytes = _mm_loadu_si128((const __m128i*)(pattern.bytes + 16 * b));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(text, fold), bytes)) != 0xFFFF) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Обходить кандидатів у масці блоку, що починається з base; false — sink зупинив пошук
+    auto visit = [&](size_t base, uint32_t mask) {
+        while (mask) {
+            const size_t pos = base + ctz32(mask);
+            if ((!pattern.verify || verify(pos)) && !sink(pos)) {
+                resume = pos + 1;
+                return false;
+            }
+            mask &= mask - 1;
+        }
+        return true;
+    };
+
+    // Блок кандидатів обробляється, доки всі його позиції можуть вмістити шаблон
+    for (; i + 16 <= last; i += 16) {
+        const __m128i eq1 = _mm_cmpeq_epi8(_mm_or_si128(_mm_loadu_si128((const __m128i*)(first + i)), f1), c1);
+        const __m128i eq2 = _mm_cmpeq_epi8(_mm_or_si128(_mm_loadu_si128((const __m128i*)(second + i)), f2), c2);
+        if (!visit(i, static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(eq1, eq2))))) {
+            return resume;
+        }
+    }
+
+    for (; i < last; ++i) {
+        if (pattern.byte_matches(str[i + anchors.first], anchors.first) &&
+            pattern.byte_matches(str[i + anchors.second], anchors.second) && !visit(i, 1)) {
+            return resume;
+        }
+    }
+    return str_len;
+}
+
+size_t count_substring_sse42(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                              const MatchOptions& options) {
+    size_t count = 0;
+    scan_substring(str, str_len, SearchPattern(substr, substr_len, options), 0, [&](size_t) {
+        ++count;
+        return true;
+    });
+    return count;
+}
+
+size_t find_all_sse42(const char* str, size_t str_len, const char* substr, size_t substr_len,
+                       size_t* positions, size_t capacity, size_t& cursor, const MatchOptions& options) {
+    if (capacity == 0) {
+        return 0;
+    }
+    size_t found = 0;
+    cursor = scan_substring(str, str_len, SearchPattern(substr, substr_len, options), cursor, [&](size_t pos) {
+        positions[found++] = pos;
+        return found < capacity;
+    });
+    return found;
+}
+
+}  // namespace
+
+const KernelTable sse42_kernels = {
+    CpuTier::SSE42,
+    add_i32_sse42,
+    add_f32_sse42,
+    mul_f32_sse42,
+    fma_f32_sse42,
+    add_i32_stream_sse42,
+    add_f32_stream_sse42,
+    mul_f32_stream_sse42,
+    dot_f32_sse42,
+    dot_f32_compensated_sse42,
+    dot_f32_lanes_sse42,
+    count_substring_sse42,
+    find_all_sse42,
+};
+
+}  // namespace simd
+
+#include "target_end.h"
@@ -0,0 +1,248 @@
+﻿#include "low_precision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "generic_dot.h"
+#include "kernels.h"
+#include "low_precision_internal.h"
+
+namespace simd {
+
+namespace {
+
+uint32_t float_bits(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+float bits_float(uint32_t bits) {
+    float x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// Блок int8-добутків, що накопичується в int32: 2^16 * 127 * 127 < 2^31
+const size_t GENERIC_I8_BLOCK = size_t(1) << 16;
+
+// Ядра без явного SIMD для рівнів scalar і sse4.2
+
+int64_t dot_i8_generic(const int8_t* a, const int8_t* b, size_t size) {
+    int64_t sum = 0;
+    for (size_t begin = 0; begin < size; begin += GENERIC_I8_BLOCK) {
+        const size_t end = std::min(size, begin + GENERIC_I8_BLOCK);
+        int32_t block = 0;
+        for (size_t i = begin; i < end; ++i) {
+            block += int32_t(a[i]) * int32_t(b[i]);
+        }
+        sum += block;
+    }
+    return sum;
+}
+
+template <float (*Convert)(uint16_t)>
+float dot_generic(const uint16_t* a, const uint16_t* b, size_t size) {
+    return generic_dot(size, [&](size_t i) { return Convert(a[i]) * Convert(b[i]); });
+}
+
+template <float (*ToFloat)(uint16_t), uint16_t (*FromFloat)(float)>
+void multiply_generic(const uint16_t* a, const uint16_t* b, uint16_t* result, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = FromFloat(ToFloat(a[i]) * ToFloat(b[i]));
+    }
+}
+
+template <uint16_t (*FromFloat)(float)>
+void narrow_generic(const float* x, uint16_t* result, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = FromFloat(x[i]);
+    }
+}
+
+template <float (*ToFloat)(uint16_t)>
+void widen_generic(const uint16_t* x, float* result, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = ToFloat(x[i]);
+    }
+}
+
+float max_abs_generic(const float* x, size_t size) {
+    float result = 0.0f;
+    for (size_t i = 0; i < size; ++i) {
+        result = std::max(result, std::abs(x[i]));
+    }
+    return result;
+}
+
+// Обмеження до того самого порядку операндів, що й у vmaxps/vminps: NaN стає -127, як і у векторних ядрах
+void quantize_i8_generic(const float* x, int8_t* q, size_t size, float multiplier) {
+    for (size_t i = 0; i < size; ++i) {
+        const float clamped = std::min(127.0f, std::max(-127.0f, x[i] * multiplier));
+        q[i] = static_cast<int8_t>(std::nearbyint(clamped));
+    }
+}
+
+void dequantize_i8_generic(const int8_t* q, float* x, size_t size, float scale) {
+    for (size_t i = 0; i < size; ++i) {
+        x[i] = float(q[i]) * scale;
+    }
+}
+
+const LowPrecisionTable generic_low_precision = {
+    CpuTier::Scalar,
+    dot_i8_generic,
+    dot_generic<f16_to_f32>,
+    dot_generic<bf16_to_f32>,
+    multiply_generic<f16_to_f32, f32_to_f16>,
+    multiply_generic<bf16_to_f32, f32_to_bf16>,
+    narrow_generic<f32_to_f16>,
+    widen_generic<f16_to_f32>,
+    narrow_generic<f32_to_bf16>,
+    widen_generic<bf16_to_f32>,
+    max_abs_generic,
+    quantize_i8_generic,
+    dequantize_i8_generic,
+};
+
+LowPrecisionTable with_extensions(LowPrecisionTable table) {
+    const CpuFeatures& f = cpu_features();
+    if (table.tier == CpuTier::AVX512) {
+        if (f.avx512_vnni) {
+            table.dot_i8 = dot_i8_avx512_vnni;
+        }
+        if (f.avx512_bf16) {
+            table.dot_bf16 = dot_bf16_avx512_bf16;
+        }
+    }
+    else if (table.tier == CpuTier::AVX2 && f.avx_vnni) {
+        table.dot_i8 = dot_i8_avx_vnni;
+    }
+    return table;
+}
+
+}  // namespace
+
+uint16_t f32_to_f16(float x) {
+    const uint32_t bits = float_bits(x);
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    const uint32_t magnitude = bits & 0x7FFFFFFF;
+    if (magnitude > 0x7F800000) {
+        return static_cast<uint16_t>(sign | 0x7E00 | ((magnitude >> 13) & 0x3FF));  // NaN стає тихим
+    }
+    if (magnitude >= 0x477FF000) {
+        return static_cast<uint16_t>(sign | 0x7C00);  // Від 65520 (середина між 65504 і 2^16) — нескінченність
+    }
+    if (magnitude >= 0x38800000) {
+        // Нормальне число: зміщення порядку 127 -> 15; перенос з мантиси в порядок дає правильний результат
+        uint32_t h = (magnitude - 0x38000000) >> 13;
+        const uint32_t rest = magnitude & 0x1FFF;
+        h += rest > 0x1000 || (rest == 0x1000 && (h & 1));
+        return static_cast<uint16_t>(sign | h);
+    }
+    if (magnitude <= 0x33000000) {
+        return static_cast<uint16_t>(sign);  // Не більше за 2^-25: половина найменшого субнормального округлюється до нуля
+    }
+    // Субнормальне fp16: мантиса float у одиницях 2^-24
+    const uint32_t shift = 126 - (magnitude >> 23);
+    const uint32_t mantissa = (magnitude & 0x7FFFFF) | 0x800000;
+    uint32_t h = mantissa >> shift;
+    const uint32_t rest = mantissa & ((1u << shift) - 1);
+    const uint32_t half = 1u << (shift - 1);
+    h += rest > half || (rest == half && (h & 1));
+    return static_cast<uint16_t>(sign | h);
+}
+
+float f16_to_f32(uint16_t x) {
+    const uint32_t sign = uint32_t(x & 0x8000) << 16;
+    const uint32_t exponent = (x >> 10) & 0x1F;
+    const uint32_t mantissa = x & 0x3FF;
+    if (exponent == 0x1F) {
+        return bits_float(sign | 0x7F800000 | (mantissa << 13) | (mantissa ? 0x400000 : 0));  // NaN стає тихим
+    }
+    if (exponent == 0) {
+        const float magnitude = float(mantissa) * 0x1p-24f;  // Субнормальне або нуль, точно
+        return sign ? -magnitude : magnitude;
+    }
+    return bits_float(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+uint16_t f32_to_bf16(float x) {
+    const uint32_t bits = float_bits(x);
+    if ((bits & 0x7FFFFFFF) > 0x7F800000) {
+        return static_cast<uint16_t>((bits >> 16) | 0x40);  // NaN стає тихим
+    }
+    return static_cast<uint16_t>((bits + 0x7FFF + ((bits >> 16) & 1)) >> 16);
+}
+
+float bf16_to_f32(uint16_t x) {
+    return bits_float(uint32_t(x) << 16);
+}
+
+const LowPrecisionTable& low_precision_kernels_for(CpuTier tier, bool extensions) {
+    static const LowPrecisionTable avx2 = with_extensions(avx2_low_precision);
+    static const LowPrecisionTable avx512 = with_extensions(avx512_low_precision);
+    switch (tier) {
+    case CpuTier::AVX512: return extensions ? avx512 : avx512_low_precision;
+    case CpuTier::AVX2: return extensions ? avx2 : avx2_low_precision;
+    default: return generic_low_precision;
+    }
+}
+
+const LowPrecisionTable& low_precision_kernels() {
+    return low_precision_kernels_for(active_tier());
+}
+
+void convert_f32_to_f16(const float* x, uint16_t* result, size_t size) {
+    low_precision_kernels().f32_to_f16(x, result, size);
+}
+
+void convert_f16_to_f32(const uint16_t* x, float* result, size_t size) {
+    low_precision_kernels().f16_to_f32(x, result, size);
+}
+
+void convert_f32_to_bf16(const float* x, uint16_t* result, size_t size) {
+    low_precision_kernels().f32_to_bf16(x, result, size);
+}
+
+void convert_bf16_to_f32(const uint16_t* x, float* result, size_t size) {
+    low_precision_kernels().bf16_to_f32(x, result, size);
+}
+
+float quantize_i8(const float* x, int8_t* q, size_t size) {
+    const LowPrecisionTable& k = low_precision_kernels();
+    const float max_abs = k.max_abs(x, size);
+    k.quantize_i8(x, q, size, max_abs > 0.0f ? 127.0f / max_abs : 0.0f);
+    return max_abs / 127.0f;
+}
+
+void quantize_i8(const float* x, int8_t* q, size_t size, float scale) {
+    low_precision_kernels().quantize_i8(x, q, size, scale != 0.0f ? 1.0f / scale : 0.0f);
+}
+
+void dequantize_i8(const int8_t* q, float* x, size_t size, float scale) {
+    low_precision_kernels().dequantize_i8(q, x, size, scale);
+}
+
+int64_t dot_i8(const int8_t* a, const int8_t* b, size_t size) {
+    return low_precision_kernels().dot_i8(a, b, size);
+}
+
+float dot_f16(const uint16_t* a, const uint16_t* b, size_t size) {
+    return low_precision_kernels().dot_f16(a, b, size);
+}
+
+float dot_bf16(const uint16_t* a, const uint16_t* b, size_t size) {
+    return low_precision_kernels().dot_bf16(a, b, size);
+}
+
+void multiply_f16(const uint16_t* a, const uint16_t* b, uint16_t* result, size_t size) {
+    low_precision_kernels().multiply_f16(a, b, result, size);
+}
+
+void multiply_bf16(const uint16_t* a, const uint16_t* b, uint16_t* result, size_t size) {
+    low_precision_kernels().multiply_bf16(a, b, result, size);
+}
+
+}  // namespace simd
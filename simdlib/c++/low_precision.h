@@ -0,0 +1,87 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu_features.h"
+
+namespace simd {
+
+// Вектори зі зниженою точністю: int8 (симетричне квантування з масштабом), IEEE half (fp16) і bfloat16 (bf16).
+// Значення fp16 і bf16 зберігаються як uint16_t з бітовим образом числа. Добутки й суми рахуються
+// в широкому типі (int32/int64 для int8, float для fp16 і bf16), тож у 2–4 рази менший обсяг даних
+// дає відповідний виграш там, де скалярний добуток упирається в пам'ять.
+
+// Ядра одного рівня
+struct LowPrecisionTable {
+    CpuTier tier;
+
+    // Точний скалярний добуток int8-векторів зі значеннями з [-127, 127] (-128 не допускається)
+    int64_t (*dot_i8)(const int8_t* a, const int8_t* b, size_t size);
+
+    // Скалярні добутки з перетворенням у float і накопиченням у float кількома акумуляторами
+    float (*dot_f16)(const uint16_t* a, const uint16_t* b, size_t size);
+    float (*dot_bf16)(const uint16_t* a, const uint16_t* b, size_t size);
+
+    // result[i] = a[i] * b[i]: добуток у float, округлений до fp16 (bf16) до найближчого парного
+    void (*multiply_f16)(const uint16_t* a, const uint16_t* b, uint16_t* result, size_t size);
+    void (*multiply_bf16)(const uint16_t* a, const uint16_t* b, uint16_t* result, size_t size);
+
+    void (*f32_to_f16)(const float* x, uint16_t* result, size_t size);
+    void (*f16_to_f32)(const uint16_t* x, float* result, size_t size);
+    void (*f32_to_bf16)(const float* x, uint16_t* result, size_t size);
+    void (*bf16_to_f32)(const uint16_t* x, float* result, size_t size);
+
+    // max |x[i]| (0 для порожнього масиву)
+    float (*max_abs)(const float* x, size_t size);
+    // q[i] = round(x[i] * multiplier), обмежене до [-127, 127]
+    void (*quantize_i8)(const float* x, int8_t* q, size_t size, float multiplier);
+    // x[i] = q[i] * scale
+    void (*dequantize_i8)(const int8_t* q, float* x, size_t size, float scale);
+};
+
+// Таблиця активного рівня (той самий рівень, що й у kernels()) і таблиця конкретного рівня.
+// Якщо extensions == true, ядра рівня, для яких процесор має окреме розширення, замінюються
+// відповідними версіями: dot_i8 — через vpdpbusd (AVX-VNNI на рівні AVX2, AVX512_VNNI на AVX-512),
+// dot_bf16 — через vdpbf16ps (AVX512_BF16). Без розширень dot_i8 рахується через vpmaddubsw.
+const LowPrecisionTable& low_precision_kernels();
+const LowPrecisionTable& low_precision_kernels_for(CpuTier tier, bool extensions = true);
+
+// Одне значення: перетворення з округленням до найближчого парного, як у vcvtps2ph. NaN лишається
+// тихим NaN зі старшими бітами мантиси; fp16 має субнормальні числа, тож нулем стає лише |x| <= 2^-25.
+uint16_t f32_to_f16(float x);
+float f16_to_f32(uint16_t x);
+uint16_t f32_to_bf16(float x);
+float bf16_to_f32(uint16_t x);
+
+// Перетворення масивів. Результат однаковий на всіх рівнях.
+void convert_f32_to_f16(const float* x, uint16_t* result, size_t size);
+void convert_f16_to_f32(const uint16_t* x, float* result, size_t size);
+void convert_f32_to_bf16(const float* x, uint16_t* result, size_t size);
+void convert_bf16_to_f32(const uint16_t* x, float* result, size_t size);
+
+// Симетричне квантування: scale = max |x[i]| / 127, q[i] = round(x[i] * 127 / max |x[i]|) (до найближчого
+// парного), тож q[i] лежить у [-127, 127]. Повертає scale (0, якщо всі x[i] нулі). Для масивів з NaN або
+// нескінченностями результат не визначений. Скалярний добуток квантованих векторів:
+// dot_i8(qa, qb, size) * scale_a * scale_b.
+float quantize_i8(const float* x, int8_t* q, size_t size);
+
+// Квантування із заданим масштабом (наприклад, спільним для кількох векторів): q[i] = round(x[i] * (1 / scale));
+// значення, що виходять за [-127, 127], обмежуються
+void quantize_i8(const float* x, int8_t* q, size_t size, float scale);
+
+// x[i] = q[i] * scale
+void dequantize_i8(const int8_t* q, float* x, size_t size, float scale);
+
+// Скалярний добуток int8-векторів зі значеннями з [-127, 127], точний (у int64_t)
+int64_t dot_i8(const int8_t* a, const int8_t* b, size_t size);
+
+// Скалярні добутки fp16 і bf16 з накопиченням у float, як DotMode::Fast. Порядок додавань залежить
+// від рівня; vdpbf16ps (AVX512_BF16) ще й вважає субнормальні bf16 нулями.
+float dot_f16(const uint16_t* a, const uint16_t* b, size_t size);
+float dot_bf16(const uint16_t* a, const uint16_t* b, size_t size);
+
+// result[i] = a[i] * b[i] для fp16 і bf16 (результат однаковий на всіх рівнях)
+void multiply_f16(const uint16_t* a, const uint16_t* b, uint16_t* result, size_t size);
+void multiply_bf16(const uint16_t* a, const uint16_t* b, uint16_t* result, size_t size);
+
+}  // namespace simd
@@ -0,0 +1,295 @@
+﻿#include <immintrin.h>
+#include <cstdint>
+#include <cstring>
+
+#include "low_precision_internal.h"
+
+#include "target_avx2.h"
+
+// Ядра зниженої точності на 256-бітних регістрах. 16-бітних і 8-бітних маскованих завантажень в AVX2
+// немає, тож залишок, коротший за крок, копіюється в буфер на стеку, доповнений нулями, і проходить
+// той самий векторний крок; результат копіюється назад лише для дійсних елементів.
+namespace simd {
+
+namespace {
+
+float hsum(__m256 x) {
+    __m128 y = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+    y = _mm_add_ps(y, _mm_movehl_ps(y, y));
+    return _mm_cvtss_f32(_mm_add_ss(y, _mm_movehdup_ps(y)));
+}
+
+// Сума восьми смуг int32 у int64_t
+int64_t widen_sum(__m256i x) {
+    const __m256i wide = _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)),
+                                          _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+    const __m128i half = _mm_add_epi64(_mm256_castsi256_si128(wide), _mm256_extracti128_si256(wide, 1));
+    return _mm_cvtsi128_si64(_mm_add_epi64(half, _mm_unpackhi_epi64(half, half)));
+}
+
+__m128i load128(const void* p) {
+    return _mm_loadu_si128(static_cast<const __m128i*>(p));
+}
+
+void store128(void* p, __m128i v) {
+    _mm_storeu_si128(static_cast<__m128i*>(p), v);
+}
+
+// Вісім 16-бітних значень <-> вісім float
+struct F16 {
+    static __m256 load(const uint16_t* p) { return _mm256_cvtph_ps(load128(p)); }
+    static __m128i narrow(__m256 x) { return _mm256_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+};
+
+struct BF16 {
+    static __m256 load(const uint16_t* p) { return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(load128(p)), 16)); }
+    // Округлення до найближчого парного додаванням 0x7FFF + молодший біт результату; NaN лише стає тихим
+    static __m128i narrow(__m256 x) {
+        const __m256i bits = _mm256_castps_si256(x);
+        const __m256i odd = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+        const __m256i rounded = _mm256_add_epi32(bits, _mm256_add_epi32(odd, _mm256_set1_epi32(0x7FFF)));
+        const __m256i nan = _mm256_cmpgt_epi32(_mm256_and_si256(bits, _mm256_set1_epi32(0x7FFFFFFF)), _mm256_set1_epi32(0x7F800000));
+        const __m256i quiet = _mm256_or_si256(bits, _mm256_set1_epi32(0x400000));
+        const __m256i result = _mm256_srli_epi32(_mm256_blendv_epi8(rounded, quiet, nan), 16);
+        return _mm_packus_epi32(_mm256_castsi256_si128(result), _mm256_extracti128_si256(result, 1));
+    }
+};
+
+// Чотири акумулятори по вісім смуг
+template <typename Format>
+float dot(const uint16_t* a, const uint16_t* b, size_t size) {
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        acc0 = _mm256_fmadd_ps(Format::load(a + i), Format::load(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(Format::load(a + i + 8), Format::load(b + i + 8), acc1);
+        acc2 = _mm256_fmadd_ps(Format::load(a + i + 16), Format::load(b + i + 16), acc2);
+        acc3 = _mm256_fmadd_ps(Format::load(a + i + 24), Format::load(b + i + 24), acc3);
+    }
+    for (; i + 8 <= size; i += 8) {
+        acc0 = _mm256_fmadd_ps(Format::load(a + i), Format::load(b + i), acc0);
+    }
+    if (i < size) {
+        uint16_t ta[8] = {}, tb[8] = {};
+        std::memcpy(ta, a + i, (size - i) * sizeof(uint16_t));
+        std::memcpy(tb, b + i, (size - i) * sizeof(uint16_t));
+        acc1 = _mm256_fmadd_ps(Format::load(ta), Format::load(tb), acc1);
+    }
+    return hsum(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+}
+
+template <typename Format>
+void multiply(const uint16_t* a, const uint16_t* b, uint16_t* result, size_t size) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        store128(result + i, Format::narrow(_mm256_mul_ps(Format::load(a + i), Format::load(b + i))));
+    }
+    if (i < size) {
+        uint16_t ta[8] = {}, tb[8] = {}, tr[8];
+        std::memcpy(ta, a + i, (size - i) * sizeof(uint16_t));
+        std::memcpy(tb, b + i, (size - i) * sizeof(uint16_t));
+        store128(tr, Format::narrow(_mm256_mul_ps(Format::load(ta), Format::load(tb))));
+        std::memcpy(result + i, tr, (size - i) * sizeof(uint16_t));
+    }
+}
+
+template <typename Format>
+void narrow(const float* x, uint16_t* result, size_t size) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        store128(result + i, Format::narrow(_mm256_loadu_ps(x + i)));
+    }
+    if (i < size) {
+        float tx[8] = {};
+        uint16_t tr[8];
+        std::memcpy(tx, x + i, (size - i) * sizeof(float));
+        store128(tr, Format::narrow(_mm256_loadu_ps(tx)));
+        std::memcpy(result + i, tr, (size - i) * sizeof(uint16_t));
+    }
+}
+
+template <typename Format>
+void widen(const uint16_t* x, float* result, size_t size) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(result + i, Format::load(x + i));
+    }
+    if (i < size) {
+        uint16_t tx[8] = {};
+        float tr[8];
+        std::memcpy(tx, x + i, (size - i) * sizeof(uint16_t));
+        _mm256_storeu_ps(tr, Format::load(tx));
+        std::memcpy(result + i, tr, (size - i) * sizeof(float));
+    }
+}
+
+// |a| і b зі знаком a: добуток той самий, але перший множник тепер беззнаковий, як вимагає vpmaddubsw.
+// Для значень з [-127, 127] пара добутків не перевищує 2 * 127 * 127 і не насичує int16.
+void sign_split(__m256i a, __m256i b, __m256i& magnitude, __m256i& signed_b) {
+    magnitude = _mm256_sign_epi8(a, a);
+    signed_b = _mm256_sign_epi8(b, a);
+}
+
+__m256i dot_i8_step(__m256i acc, const int8_t* a, const int8_t* b) {
+    __m256i magnitude, signed_b;
+    sign_split(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)),
+               magnitude, signed_b);
+    const __m256i pairs = _mm256_maddubs_epi16(magnitude, signed_b);
+    return _mm256_add_epi32(acc, _mm256_madd_epi16(pairs, _mm256_set1_epi16(1)));
+}
+
+int64_t dot_i8_avx2(const int8_t* a, const int8_t* b, size_t size) {
+    const size_t full = size - size % 32;
+    int64_t sum = 0;
+    for (size_t begin = 0; begin < full; begin += DOT_I8_BLOCK * 32) {
+        const size_t end = full - begin < DOT_I8_BLOCK * 32 ? full : begin + DOT_I8_BLOCK * 32;
+        __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+        size_t i = begin;
+        for (; i + 64 <= end; i += 64) {
+            acc0 = dot_i8_step(acc0, a + i, b + i);
+            acc1 = dot_i8_step(acc1, a + i + 32, b + i + 32);
+        }
+        if (i < end) {
+            acc0 = dot_i8_step(acc0, a + i, b + i);
+        }
+        sum += widen_sum(_mm256_add_epi32(acc0, acc1));
+    }
+    if (full < size) {
+        int8_t ta[32] = {}, tb[32] = {};
+        std::memcpy(ta, a + full, size - full);
+        std::memcpy(tb, b + full, size - full);
+        sum += widen_sum(dot_i8_step(_mm256_setzero_si256(), ta, tb));
+    }
+    return sum;
+}
+
+float max_abs_avx2(const float* x, size_t size) {
+    const __m256 magnitude = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        acc0 = _mm256_max_ps(acc0, _mm256_and_ps(_mm256_loadu_ps(x + i), magnitude));
+        acc1 = _mm256_max_ps(acc1, _mm256_and_ps(_mm256_loadu_ps(x + i + 8), magnitude));
+    }
+    for (; i < size; i += 8) {
+        // Масковані смуги читаються як нулі й не змінюють максимуму модулів
+        const __m256i m = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(size - i)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        acc0 = _mm256_max_ps(acc0, _mm256_and_ps(_mm256_maskload_ps(x + i, m), magnitude));
+    }
+    const __m256 acc = _mm256_max_ps(acc0, acc1);
+    __m128 y = _mm_max_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    y = _mm_max_ps(y, _mm_movehl_ps(y, y));
+    return _mm_cvtss_f32(_mm_max_ss(y, _mm_movehdup_ps(y)));
+}
+
+// Вісім float -> вісім int32, обмежених до [-127, 127] (порядок операндів vmaxps робить NaN рівним -127)
+__m256i quantize8(const float* x, __m256 multiplier) {
+    const __m256 scaled = _mm256_mul_ps(_mm256_loadu_ps(x), multiplier);
+    return _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(scaled, _mm256_set1_ps(-127.0f)), _mm256_set1_ps(127.0f)));
+}
+
+// 32 float -> 32 int8. Пакування працює в межах 128-бітних половин, тож восьмірки переставляються на місця.
+__m256i quantize32(const float* x, __m256 multiplier) {
+    const __m256i ab = _mm256_packs_epi32(quantize8(x, multiplier), quantize8(x + 8, multiplier));
+    const __m256i cd = _mm256_packs_epi32(quantize8(x + 16, multiplier), quantize8(x + 24, multiplier));
+    return _mm256_permutevar8x32_epi32(_mm256_packs_epi16(ab, cd), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+void quantize_i8_avx2(const float* x, int8_t* q, size_t size, float multiplier) {
+    const __m256 m = _mm256_set1_ps(multiplier);
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(q + i), quantize32(x + i, m));
+    }
+    if (i < size) {
+        float tx[32] = {};
+        int8_t tq[32];
+        std::memcpy(tx, x + i, (size - i) * sizeof(float));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(tq), quantize32(tx, m));
+        std::memcpy(q + i, tq, size - i);
+    }
+}
+
+void dequantize_i8_avx2(const int8_t* q, float* x, size_t size, float scale) {
+    const __m256 s = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        const __m256i wide = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(q + i)));
+        _mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_cvtepi32_ps(wide), s));
+    }
+    if (i < size) {
+        int8_t tq[8] = {};
+        float tx[8];
+        std::memcpy(tq, q + i, size - i);
+        const __m256i wide = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(tq)));
+        _mm256_storeu_ps(tx, _mm256_mul_ps(_mm256_cvtepi32_ps(wide), s));
+        std::memcpy(x + i, tx, (size - i) * sizeof(float));
+    }
+}
+
+}  // namespace
+
+const LowPrecisionTable avx2_low_precision = {
+    CpuTier::AVX2,
+    dot_i8_avx2,
+    dot<F16>,
+    dot<BF16>,
+    multiply<F16>,
+    multiply<BF16>,
+    narrow<F16>,
+    widen<F16>,
+    narrow<BF16>,
+    widen<BF16>,
+    max_abs_avx2,
+    quantize_i8_avx2,
+    dequantize_i8_avx2,
+};
+
+}  // namespace simd
+
+#include "target_end.h"
+
+// dot_i8 через vpdpbusd (AVX-VNNI): множення пар u8 x s8 і додавання четвірок в int32 однією інструкцією
+#include "target_avx_vnni.h"
+
+namespace simd {
+
+namespace {
+
+__m256i dot_i8_vnni_step(__m256i acc, const int8_t* a, const int8_t* b) {
+    __m256i magnitude, signed_b;
+    sign_split(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)),
+               magnitude, signed_b);
+    return _mm256_dpbusd_avx_epi32(acc, magnitude, signed_b);
+}
+
+}  // namespace
+
+int64_t dot_i8_avx_vnni(const int8_t* a, const int8_t* b, size_t size) {
+    const size_t full = size - size % 32;
+    int64_t sum = 0;
+    for (size_t begin = 0; begin < full; begin += DOT_I8_BLOCK * 32) {
+        const size_t end = full - begin < DOT_I8_BLOCK * 32 ? full : begin + DOT_I8_BLOCK * 32;
+        __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+        size_t i = begin;
+        for (; i + 64 <= end; i += 64) {
+            acc0 = dot_i8_vnni_step(acc0, a + i, b + i);
+            acc1 = dot_i8_vnni_step(acc1, a + i + 32, b + i + 32);
+        }
+        if (i < end) {
+            acc0 = dot_i8_vnni_step(acc0, a + i, b + i);
+        }
+        sum += widen_sum(_mm256_add_epi32(acc0, acc1));
+    }
+    if (full < size) {
+        int8_t ta[32] = {}, tb[32] = {};
+        std::memcpy(ta, a + full, size - full);
+        std::memcpy(tb, b + full, size - full);
+        sum += widen_sum(dot_i8_vnni_step(_mm256_setzero_si256(), ta, tb));
+    }
+    return sum;
+}
+
+}  // namespace simd
+
+#include "target_end.h"
@@ -0,0 +1,246 @@
+﻿#include <immintrin.h>
+#include <cstdint>
+
+#include "low_precision_internal.h"
+
+#include "target_avx512.h"
+
+// Ядра зниженої точності на 512-бітних регістрах. Залишок читається й пишеться масками AVX-512BW,
+// тож окремого скалярного циклу немає.
+namespace simd {
+
+namespace {
+
+__mmask16 first16(size_t n) {
+    return n >= 16 ? static_cast<__mmask16>(0xFFFF) : static_cast<__mmask16>((1u << n) - 1);
+}
+
+int64_t widen_sum(__m512i x) {
+    return _mm512_reduce_add_epi64(_mm512_add_epi64(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(x)),
+                                                    _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(x, 1))));
+}
+
+// Шістнадцять 16-бітних значень <-> шістнадцять float; m — маска дійсних смуг (решта читається як нуль)
+struct F16 {
+    static __m512 load(const uint16_t* p, __mmask16 m) { return _mm512_cvtph_ps(_mm256_maskz_loadu_epi16(m, p)); }
+    static __m256i narrow(__m512 x) { return _mm512_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+};
+
+struct BF16 {
+    static __m512 load(const uint16_t* p, __mmask16 m) {
+        return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(_mm256_maskz_loadu_epi16(m, p)), 16));
+    }
+    // Округлення до найближчого парного, як f32_to_bf16; NaN лише стає тихим
+    static __m256i narrow(__m512 x) {
+        const __m512i bits = _mm512_castps_si512(x);
+        const __m512i odd = _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+        const __m512i rounded = _mm512_add_epi32(bits, _mm512_add_epi32(odd, _mm512_set1_epi32(0x7FFF)));
+        const __mmask16 nan = _mm512_cmpgt_epi32_mask(_mm512_and_si512(bits, _mm512_set1_epi32(0x7FFFFFFF)), _mm512_set1_epi32(0x7F800000));
+        const __m512i result = _mm512_mask_or_epi32(rounded, nan, bits, _mm512_set1_epi32(0x400000));
+        return _mm512_cvtepi32_epi16(_mm512_srli_epi32(result, 16));
+    }
+};
+
+// Чотири акумулятори по шістнадцять смуг; останній неповний крок читає маскою
+template <typename Format>
+float dot(const uint16_t* a, const uint16_t* b, size_t size) {
+    const __mmask16 all = 0xFFFF;
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps(), acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        acc0 = _mm512_fmadd_ps(Format::load(a + i, all), Format::load(b + i, all), acc0);
+        acc1 = _mm512_fmadd_ps(Format::load(a + i + 16, all), Format::load(b + i + 16, all), acc1);
+        acc2 = _mm512_fmadd_ps(Format::load(a + i + 32, all), Format::load(b + i + 32, all), acc2);
+        acc3 = _mm512_fmadd_ps(Format::load(a + i + 48, all), Format::load(b + i + 48, all), acc3);
+    }
+    for (; i < size; i += 16) {
+        const __mmask16 m = first16(size - i);
+        acc0 = _mm512_fmadd_ps(Format::load(a + i, m), Format::load(b + i, m), acc0);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+}
+
+template <typename Format>
+void multiply(const uint16_t* a, const uint16_t* b, uint16_t* result, size_t size) {
+    for (size_t i = 0; i < size; i += 16) {
+        const __mmask16 m = first16(size - i);
+        _mm256_mask_storeu_epi16(result + i, m, Format::narrow(_mm512_mul_ps(Format::load(a + i, m), Format::load(b + i, m))));
+    }
+}
+
+template <typename Format>
+void narrow(const float* x, uint16_t* result, size_t size) {
+    for (size_t i = 0; i < size; i += 16) {
+        const __mmask16 m = first16(size - i);
+        _mm256_mask_storeu_epi16(result + i, m, Format::narrow(_mm512_maskz_loadu_ps(m, x + i)));
+    }
+}
+
+template <typename Format>
+void widen(const uint16_t* x, float* result, size_t size) {
+    for (size_t i = 0; i < size; i += 16) {
+        const __mmask16 m = first16(size - i);
+        _mm512_mask_storeu_ps(result + i, m, Format::load(x + i, m));
+    }
+}
+
+// |a| і b зі знаком a (див. sign_split у low_precision_avx2.cpp); vpsignb для ZMM немає, тож знак — маскою
+void sign_split(__m512i a, __m512i b, __m512i& magnitude, __m512i& signed_b) {
+    magnitude = _mm512_abs_epi8(a);
+    signed_b = _mm512_mask_sub_epi8(b, _mm512_movepi8_mask(a), _mm512_setzero_si512(), b);
+}
+
+__m512i dot_i8_step(__m512i acc, const int8_t* a, const int8_t* b, __mmask64 m) {
+    __m512i magnitude, signed_b;
+    sign_split(_mm512_maskz_loadu_epi8(m, a), _mm512_maskz_loadu_epi8(m, b), magnitude, signed_b);
+    const __m512i pairs = _mm512_maddubs_epi16(magnitude, signed_b);
+    return _mm512_add_epi32(acc, _mm512_madd_epi16(pairs, _mm512_set1_epi16(1)));
+}
+
+int64_t dot_i8_avx512(const int8_t* a, const int8_t* b, size_t size) {
+    const __mmask64 all = ~__mmask64(0);
+    int64_t sum = 0;
+    for (size_t begin = 0; begin < size; begin += DOT_I8_BLOCK * 64) {
+        const size_t end = size - begin < DOT_I8_BLOCK * 64 ? size : begin + DOT_I8_BLOCK * 64;
+        __m512i acc0 = _mm512_setzero_si512(), acc1 = _mm512_setzero_si512();
+        size_t i = begin;
+        for (; i + 128 <= end; i += 128) {
+            acc0 = dot_i8_step(acc0, a + i, b + i, all);
+            acc1 = dot_i8_step(acc1, a + i + 64, b + i + 64, all);
+        }
+        for (; i < end; i += 64) {
+            acc0 = dot_i8_step(acc0, a + i, b + i, end - i >= 64 ? all : _bzhi_u64(all, static_cast<unsigned>(end - i)));
+        }
+        sum += widen_sum(_mm512_add_epi32(acc0, acc1));
+    }
+    return sum;
+}
+
+float max_abs_avx512(const float* x, size_t size) {
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        acc0 = _mm512_max_ps(acc0, _mm512_abs_ps(_mm512_loadu_ps(x + i)));
+        acc1 = _mm512_max_ps(acc1, _mm512_abs_ps(_mm512_loadu_ps(x + i + 16)));
+    }
+    for (; i < size; i += 16) {
+        acc0 = _mm512_max_ps(acc0, _mm512_abs_ps(_mm512_maskz_loadu_ps(first16(size - i), x + i)));
+    }
+    return _mm512_reduce_max_ps(_mm512_max_ps(acc0, acc1));
+}
+
+void quantize_i8_avx512(const float* x, int8_t* q, size_t size, float multiplier) {
+    const __m512 mul = _mm512_set1_ps(multiplier);
+    for (size_t i = 0; i < size; i += 16) {
+        const __mmask16 m = first16(size - i);
+        const __m512 scaled = _mm512_mul_ps(_mm512_maskz_loadu_ps(m, x + i), mul);
+        // Порядок операндів vmaxps робить NaN рівним -127, як і на інших рівнях
+        const __m512 clamped = _mm512_min_ps(_mm512_max_ps(scaled, _mm512_set1_ps(-127.0f)), _mm512_set1_ps(127.0f));
+        _mm_mask_storeu_epi8(q + i, m, _mm512_cvtepi32_epi8(_mm512_cvtps_epi32(clamped)));
+    }
+}
+
+void dequantize_i8_avx512(const int8_t* q, float* x, size_t size, float scale) {
+    const __m512 s = _mm512_set1_ps(scale);
+    for (size_t i = 0; i < size; i += 16) {
+        const __mmask16 m = first16(size - i);
+        const __m512i wide = _mm512_cvtepi8_epi32(_mm_maskz_loadu_epi8(m, q + i));
+        _mm512_mask_storeu_ps(x + i, m, _mm512_mul_ps(_mm512_cvtepi32_ps(wide), s));
+    }
+}
+
+}  // namespace
+
+const LowPrecisionTable avx512_low_precision = {
+    CpuTier::AVX512,
+    dot_i8_avx512,
+    dot<F16>,
+    dot<BF16>,
+    multiply<F16>,
+    multiply<BF16>,
+    narrow<F16>,
+    widen<F16>,
+    narrow<BF16>,
+    widen<BF16>,
+    max_abs_avx512,
+    quantize_i8_avx512,
+    dequantize_i8_avx512,
+};
+
+}  // namespace simd
+
+#include "target_end.h"
+
+// dot_i8 через vpdpbusd (AVX512_VNNI)
+#include "target_avx512_vnni.h"
+
+namespace simd {
+
+namespace {
+
+__m512i dot_i8_vnni_step(__m512i acc, const int8_t* a, const int8_t* b, __mmask64 m) {
+    __m512i magnitude, signed_b;
+    sign_split(_mm512_maskz_loadu_epi8(m, a), _mm512_maskz_loadu_epi8(m, b), magnitude, signed_b);
+    return _mm512_dpbusd_epi32(acc, magnitude, signed_b);
+}
+
+}  // namespace
+
+int64_t dot_i8_avx512_vnni(const int8_t* a, const int8_t* b, size_t size) {
+    const __mmask64 all = ~__mmask64(0);
+    int64_t sum = 0;
+    for (size_t begin = 0; begin < size; begin += DOT_I8_BLOCK * 64) {
+        const size_t end = size - begin < DOT_I8_BLOCK * 64 ? size : begin + DOT_I8_BLOCK * 64;
+        __m512i acc0 = _mm512_setzero_si512(), acc1 = _mm512_setzero_si512();
+        size_t i = begin;
+        for (; i + 128 <= end; i += 128) {
+            acc0 = dot_i8_vnni_step(acc0, a + i, b + i, all);
+            acc1 = dot_i8_vnni_step(acc1, a + i + 64, b + i + 64, all);
+        }
+        for (; i < end; i += 64) {
+            acc0 = dot_i8_vnni_step(acc0, a + i, b + i, end - i >= 64 ? all : _bzhi_u64(all, static_cast<unsigned>(end - i)));
+        }
+        sum += widen_sum(_mm512_add_epi32(acc0, acc1));
+    }
+    return sum;
+}
+
+}  // namespace simd
+
+#include "target_end.h"
+
+// dot_bf16 через vdpbf16ps (AVX512_BF16): пари bf16-добутків додаються до float-смуг однією інструкцією.
+// Інструкція вважає субнормальні входи нулями й не зважає на MXCSR.
+#include "target_avx512_bf16.h"
+
+namespace simd {
+
+namespace {
+
+__m512 dot_bf16_step(__m512 acc, const uint16_t* a, const uint16_t* b, __mmask32 m) {
+    const __m512i x = _mm512_maskz_loadu_epi16(m, a);
+    const __m512i y = _mm512_maskz_loadu_epi16(m, b);
+    return _mm512_dpbf16_ps(acc, (__m512bh)x, (__m512bh)y);
+}
+
+}  // namespace
+
+float dot_bf16_avx512_bf16(const uint16_t* a, const uint16_t* b, size_t size) {
+    const __mmask32 all = ~__mmask32(0);
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps(), acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 128 <= size; i += 128) {
+        acc0 = dot_bf16_step(acc0, a + i, b + i, all);
+        acc1 = dot_bf16_step(acc1, a + i + 32, b + i + 32, all);
+        acc2 = dot_bf16_step(acc2, a + i + 64, b + i + 64, all);
+        acc3 = dot_bf16_step(acc3, a + i + 96, b + i + 96, all);
+    }
+    for (; i < size; i += 32) {
+        acc0 = dot_bf16_step(acc0, a + i, b + i, size - i >= 32 ? all : _bzhi_u32(all, static_cast<unsigned>(size - i)));
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+}
+
+}  // namespace simd
+
+#include "target_end.h"
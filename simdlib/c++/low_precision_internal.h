@@ -0,0 +1,19 @@
+﻿#pragma once
+#include "low_precision.h"
+
+// Таблиці й ядра розширень, визначені в low_precision_<рівень>.cpp. Використовуються лише диспетчером.
+namespace simd {
+
+extern const LowPrecisionTable avx2_low_precision;
+extern const LowPrecisionTable avx512_low_precision;
+
+// Ядра розширень, що замінюють відповідні ядра таблиць рівнів
+int64_t dot_i8_avx_vnni(const int8_t* a, const int8_t* b, size_t size);
+int64_t dot_i8_avx512_vnni(const int8_t* a, const int8_t* b, size_t size);
+float dot_bf16_avx512_bf16(const uint16_t* a, const uint16_t* b, size_t size);
+
+// Скільки векторних кроків dot_i8 накопичує в 32-бітних смугах, перш ніж додати їх до int64_t.
+// За крок смуга отримує не більше 4 * 127 * 127 = 64516, тож блок не переповнює int32.
+const size_t DOT_I8_BLOCK = size_t(1) << 14;
+
+}  // namespace simd
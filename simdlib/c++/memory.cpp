@@ -0,0 +1,226 @@
+﻿#include "memory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define SIMDLIB_POSIX_MEMORY 1
+#elif defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace simd {
+
+namespace {
+
+size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+bool huge_pages_enabled() {
+    static const bool enabled = [] {
+        const char* env = std::getenv("SIMDLIB_HUGE_PAGES");
+        return !env || strcmp(env, "0") != 0;
+    }();
+    return enabled;
+}
+
+#ifdef SIMDLIB_POSIX_MEMORY
+
+// Після першої невдачі MAP_HUGETLB (великих сторінок не зарезервовано) більше не пробуємо
+std::atomic<bool> g_hugetlb_failed{false};
+
+void* map_huge(size_t bytes) {
+#ifdef MAP_HUGETLB
+    if (!g_hugetlb_failed.load(std::memory_order_relaxed)) {
+        void* data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data != MAP_FAILED) {
+            return data;
+        }
+        g_hugetlb_failed.store(true, std::memory_order_relaxed);
+    }
+#endif
+    // Прозорі великі сторінки покривають лише вирівняні на 2 МіБ ділянки: відображаємо із запасом
+    // і відрізаємо невирівняні краї
+    const size_t padded = bytes + HUGE_PAGE_BYTES;
+    void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    const uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = round_up(start, HUGE_PAGE_BYTES);
+    if (aligned > start) {
+        munmap(raw, aligned - start);
+    }
+    const size_t tail = start + padded - (aligned + bytes);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    }
+    void* data = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    madvise(data, bytes, MADV_HUGEPAGE);
+#endif
+    return data;
+}
+
+#endif
+
+}  // namespace
+
+MemoryBlock allocate_block(size_t bytes, HugePages huge) {
+    MemoryBlock block;
+    block.huge = huge;
+    bytes = round_up(std::max<size_t>(bytes, 1), SIMD_ALIGNMENT);
+#ifdef SIMDLIB_POSIX_MEMORY
+    if (huge == HugePages::Auto && bytes >= HUGE_PAGE_BYTES && huge_pages_enabled()) {
+        const size_t rounded = round_up(bytes, HUGE_PAGE_BYTES);
+        if (void* data = map_huge(rounded)) {
+            block.data = data;
+            block.bytes = rounded;
+            block.mapped = true;
+            return block;
+        }
+    }
+    void* data = nullptr;
+    if (posix_memalign(&data, SIMD_ALIGNMENT, bytes) != 0) {
+        return block;
+    }
+    block.data = data;
+#elif defined(_WIN32)
+    // Великі сторінки у Windows потребують привілею SeLockMemoryPrivilege, тож лише вирівняна купа
+    (void)huge;
+    block.data = _aligned_malloc(bytes, SIMD_ALIGNMENT);
+#else
+    (void)huge;
+    block.data = std::aligned_alloc(SIMD_ALIGNMENT, bytes);
+#endif
+    if (block.data) {
+        block.bytes = bytes;
+    }
+    return block;
+}
+
+void free_block(const MemoryBlock& block) {
+    if (!block.data) {
+        return;
+    }
+#ifdef SIMDLIB_POSIX_MEMORY
+    if (block.mapped) {
+        munmap(block.data, block.bytes);
+        return;
+    }
+    free(block.data);
+#elif defined(_WIN32)
+    _aligned_free(block.data);
+#else
+    std::free(block.data);
+#endif
+}
+
+MemoryPool::MemoryPool(size_t max_cached_bytes) : max_cached_bytes_(max_cached_bytes) {}
+
+MemoryPool::~MemoryPool() {
+    trim();
+}
+
+MemoryBlock MemoryPool::acquire(size_t bytes, HugePages huge) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Найменший закешований блок із тією ж політикою, що вміщає запит і не перевищує його
+        // більше ніж на чверть
+        size_t best = cached_.size();
+        for (size_t i = 0; i < cached_.size(); ++i) {
+            const size_t size = cached_[i].bytes;
+            if (cached_[i].huge == huge && size >= bytes && size - bytes <= bytes / 4 &&
+                (best == cached_.size() || size < cached_[best].bytes)) {
+                best = i;
+            }
+        }
+        if (best != cached_.size()) {
+            const MemoryBlock block = cached_[best];
+            cached_[best] = cached_.back();
+            cached_.pop_back();
+            cached_bytes_ -= block.bytes;
+            return block;
+        }
+    }
+    const MemoryBlock block = allocate_block(bytes, huge);
+    if (!block.data) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void MemoryPool::release(const MemoryBlock& block) {
+    if (!block.data) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cached_bytes_ + block.bytes <= max_cached_bytes_) {
+            cached_.push_back(block);
+            cached_bytes_ += block.bytes;
+            return;
+        }
+    }
+    free_block(block);
+}
+
+void MemoryPool::trim() {
+    std::vector<MemoryBlock> blocks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        blocks.swap(cached_);
+        cached_bytes_ = 0;
+    }
+    for (const MemoryBlock& block : blocks) {
+        free_block(block);
+    }
+}
+
+size_t MemoryPool::cached_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cached_bytes_;
+}
+
+MemoryPool& default_memory_pool() {
+    // Навмисно не знищується: буфери в статичних і thread_local об'єктах можуть повертати
+    // пам'ять у пул уже після деструкторів інших статичних об'єктів
+    static MemoryPool* pool = new MemoryPool();
+    return *pool;
+}
+
+Arena::Arena(size_t chunk_bytes, MemoryPool& pool)
+    : pool_(pool), chunk_bytes_(round_up(std::max(chunk_bytes, SIMD_ALIGNMENT), SIMD_ALIGNMENT)) {}
+
+Arena::~Arena() {
+    for (const MemoryBlock& chunk : chunks_) {
+        pool_.release(chunk);
+    }
+}
+
+void* Arena::allocate(size_t bytes, size_t alignment) {
+    for (; current_ < chunks_.size(); ++current_, offset_ = 0) {
+        const size_t start = round_up(offset_, alignment);
+        if (start + bytes <= chunks_[current_].bytes) {
+            offset_ = start + bytes;
+            return static_cast<char*>(chunks_[current_].data) + start;
+        }
+    }
+    // Жоден шматок не вмістив: новий звичайного розміру або окремий під великий запит
+    chunks_.push_back(pool_.acquire(std::max(bytes, chunk_bytes_)));
+    current_ = chunks_.size() - 1;
+    offset_ = bytes;
+    return chunks_.back().data;
+}
+
+void Arena::reset() {
+    current_ = 0;
+    offset_ = 0;
+}
+
+}  // namespace simd
@@ -0,0 +1,221 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace simd {
+
+// Вирівнювання всіх блоків бібліотеки: рядок кешу й ширина регістра AVX-512
+const size_t SIMD_ALIGNMENT = 64;
+
+// Розмір великої сторінки x86-64 і межа, з якої блоки виділяються великими сторінками
+const size_t HUGE_PAGE_BYTES = 2u << 20;
+
+enum class HugePages {
+    // Блоки від HUGE_PAGE_BYTES: спершу явні великі сторінки (MAP_HUGETLB), якщо їх зарезервовано,
+    // інакше відображення, вирівняне на 2 МіБ, з порадою MADV_HUGEPAGE (прозорі великі сторінки).
+    // SIMDLIB_HUGE_PAGES=0 вимикає обидва способи.
+    Auto,
+    Never
+};
+
+// Ділянка пам'яті, вирівняна на SIMD_ALIGNMENT. bytes — фактичний розмір (не менший за запитаний)
+struct MemoryBlock {
+    void* data = nullptr;
+    size_t bytes = 0;
+    bool mapped = false;  // Виділено через mmap (звільняється munmap), інакше — з купи
+    HugePages huge = HugePages::Auto;  // Політика, з якою блок виділено (MemoryPool видає його лише під неї)
+};
+
+// Виділяє блок напряму в ОС або в купі; data == nullptr, якщо пам'яті немає
+MemoryBlock allocate_block(size_t bytes, HugePages huge = HugePages::Auto);
+void free_block(const MemoryBlock& block);
+
+// Кеш звільнених блоків. Повторне виділення того самого розміру (наприклад, у кожній ітерації
+// вимірювання) отримує вже відображені сторінки: без malloc/mmap і без page fault на першому записі.
+// Блок підходить, якщо він виділений з тією ж політикою HugePages і більший за запит не більше
+// ніж на чверть. Потокобезпечний.
+class MemoryPool {
+public:
+    // Блоки, які не вміщаються в max_cached_bytes, повертаються ОС одразу
+    explicit MemoryPool(size_t max_cached_bytes = size_t(1) << 30);
+    ~MemoryPool();
+
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    // Кинуте std::bad_alloc, якщо пам'яті немає
+    MemoryBlock acquire(size_t bytes, HugePages huge = HugePages::Auto);
+    void release(const MemoryBlock& block);
+
+    // Повертає ОС усі закешовані блоки
+    void trim();
+
+    size_t cached_bytes() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<MemoryBlock> cached_;
+    size_t cached_bytes_ = 0;
+    size_t max_cached_bytes_;
+};
+
+// Спільний пул бібліотеки (не знищується до завершення процесу)
+MemoryPool& default_memory_pool();
+
+// Арена для тимчасових масивів з однаковим часом життя (наприклад, одна ітерація алгоритму):
+// виділення — зсув покажчика в поточному шматку, reset() робить усі виділення недійсними,
+// але залишає шматки, тож наступна ітерація вже не звертається до пулу.
+class Arena {
+public:
+    explicit Arena(size_t chunk_bytes = 1u << 20, MemoryPool& pool = default_memory_pool());
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // alignment — степінь двійки, не більша за SIMD_ALIGNMENT
+    void* allocate(size_t bytes, size_t alignment = SIMD_ALIGNMENT);
+
+    // count елементів із початком на SIMD_ALIGNMENT; розмір доповнюється до цілого числа рядків кешу
+    template <typename T>
+    T* allocate_array(size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Arena stores only trivially copyable types");
+        const size_t bytes = (count * sizeof(T) + SIMD_ALIGNMENT - 1) / SIMD_ALIGNMENT * SIMD_ALIGNMENT;
+        return static_cast<T*>(allocate(bytes));
+    }
+
+    void reset();
+
+private:
+    MemoryPool& pool_;
+    size_t chunk_bytes_;
+    std::vector<MemoryBlock> chunks_;
+    size_t current_ = 0;  // Індекс шматка, з якого зараз виділяємо
+    size_t offset_ = 0;
+};
+
+// Масив тривіально копійовних елементів для SIMD-ядер: початок вирівняний на 64 байти, а після size()
+// елементів до кінця 64-байтового блоку лежать нулі, тож ядро може прочитати останній вектор повністю,
+// без маскування хвоста. Пам'ять береться з MemoryPool (pool == nullptr — напряму з ОС) і повертається
+// туди ж у деструкторі. Вміст нового буфера не ініціалізується: перший запис розміщує сторінки
+// на NUMA-вузлі потоку, що пише (див. first_touch).
+template <typename T>
+class AlignedBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "AlignedBuffer stores only trivially copyable types");
+
+public:
+    AlignedBuffer() = default;
+
+    explicit AlignedBuffer(size_t size, HugePages huge = HugePages::Auto, MemoryPool* pool = &default_memory_pool())
+        : pool_(pool), huge_(huge) {
+        allocate(size);
+    }
+
+    AlignedBuffer(AlignedBuffer&& other) noexcept { swap(other); }
+    AlignedBuffer& operator=(AlignedBuffer&& other) noexcept {
+        AlignedBuffer(std::move(other)).swap(*this);
+        return *this;
+    }
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    ~AlignedBuffer() { release(); }
+
+    T* data() { return static_cast<T*>(block_.data); }
+    const T* data() const { return static_cast<const T*>(block_.data); }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Кількість елементів разом із нульовим доповненням (кратна 64 байтам)
+    size_t padded_size() const { return padded_size_for(size_); }
+
+    T& operator[](size_t i) { return data()[i]; }
+    const T& operator[](size_t i) const { return data()[i]; }
+    T* begin() { return data(); }
+    T* end() { return data() + size_; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size_; }
+
+    // Змінює розмір, зберігаючи перші min(size, size()) елементів; нові елементи не ініціалізуються.
+    // Якщо вистачає вже виділеного блоку, пам'ять не перевиділяється.
+    void resize(size_t size) {
+        if (padded_size_for(size) * sizeof(T) <= block_.bytes) {
+            size_ = size;
+            zero_padding();
+            return;
+        }
+        AlignedBuffer grown(size, huge_, pool_);
+        if (size_ > 0) {
+            memcpy(grown.data(), data(), size_ * sizeof(T));
+        }
+        swap(grown);
+    }
+
+    void fill(const T& value) {
+        for (size_t i = 0; i < size_; ++i) {
+            data()[i] = value;
+        }
+    }
+
+    void swap(AlignedBuffer& other) noexcept {
+        std::swap(block_, other.block_);
+        std::swap(size_, other.size_);
+        std::swap(pool_, other.pool_);
+        std::swap(huge_, other.huge_);
+    }
+
+private:
+    static size_t padded_size_for(size_t size) {
+        const size_t per_block = SIMD_ALIGNMENT / sizeof(T) > 0 ? SIMD_ALIGNMENT / sizeof(T) : 1;
+        return (size + per_block - 1) / per_block * per_block;
+    }
+
+    void allocate(size_t size) {
+        size_ = size;
+        if (size == 0) {
+            return;
+        }
+        const size_t bytes = padded_size_for(size) * sizeof(T);
+        if (pool_) {
+            block_ = pool_->acquire(bytes, huge_);
+        }
+        else {
+            block_ = allocate_block(bytes, huge_);
+            if (!block_.data) {
+                throw std::bad_alloc();
+            }
+        }
+        zero_padding();
+    }
+
+    void zero_padding() {
+        if (block_.data) {
+            memset(static_cast<void*>(data() + size_), 0, (padded_size() - size_) * sizeof(T));
+        }
+    }
+
+    void release() {
+        if (!block_.data) {
+            return;
+        }
+        if (pool_) {
+            pool_->release(block_);
+        }
+        else {
+            free_block(block_);
+        }
+        block_ = MemoryBlock();
+    }
+
+    MemoryBlock block_;
+    size_t size_ = 0;
+    MemoryPool* pool_ = &default_memory_pool();
+    HugePages huge_ = HugePages::Auto;
+};
+
+}  // namespace simd
@@ -0,0 +1,181 @@
+﻿#include "multi_pattern.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "kernels.h"
+#include "multi_pattern_internal.h"
+
+namespace simd {
+
+namespace {
+
+const size_t BUCKETS = 8;
+const size_t MAX_PREFIX = 4;
+
+// Скільки унікальних префіксів ще ефективно розрізняють 8 груп півбайтових таблиць
+const size_t MAX_BUCKET_PREFIXES = 32;
+
+void compile(MultiPatternTables& t) {
+    size_t min_len = 0;
+    for (const std::string& p : t.patterns) {
+        if (!p.empty()) {
+            min_len = min_len ? std::min(min_len, p.size()) : p.size();
+        }
+    }
+    t.prefix_len = std::min(min_len, MAX_PREFIX);
+    if (t.prefix_len == 0) {
+        return;
+    }
+    const size_t L = t.prefix_len;
+
+    // Непорожні шаблони, відсортовані за префіксом: шаблони зі схожими префіксами
+    // потрапляють в одну групу, і таблиці півбайтів дають менше хибних кандидатів
+    std::vector<uint32_t> order;
+    for (uint32_t id = 0; id < t.patterns.size(); ++id) {
+        if (!t.patterns[id].empty()) {
+            order.push_back(id);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t x, uint32_t y) {
+        return t.patterns[x].compare(0, L, t.patterns[y], 0, L) < 0;
+    });
+
+    std::vector<uint32_t> key_of(t.patterns.size());
+    size_t distinct = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        key_of[order[i]] = load_prefix(t.patterns[order[i]].data(), L);
+        if (i == 0 || key_of[order[i]] != key_of[order[i - 1]]) {
+            ++distinct;
+        }
+    }
+
+    // Розкладаємо унікальні префікси рівномірно по групах і заповнюємо таблиці півбайтів
+    size_t rank = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (i > 0 && key_of[order[i]] != key_of[order[i - 1]]) {
+            ++rank;
+        }
+        const uint8_t bucket_bit = static_cast<uint8_t>(1u << (rank * BUCKETS / distinct));
+        const std::string& p = t.patterns[order[i]];
+        for (size_t j = 0; j < L; ++j) {
+            const uint8_t c = static_cast<uint8_t>(p[j]);
+            t.lo[j][c & 0x0F] |= bucket_bit;
+            t.hi[j][c >> 4] |= bucket_bit;
+        }
+    }
+
+    t.use_buckets = distinct <= MAX_BUCKET_PREFIXES;
+    t.window_mask = L == 4 ? 0xFFFFFFFFu : (1u << (8 * L)) - 1;
+    for (uint32_t id : order) {
+        const uint32_t h = filter_hash(key_of[id]);
+        t.filter[h >> 5] |= 1u << (h & 31);
+    }
+
+    // Хеш-таблиця на щонайменше вдвічі більше слотів, ніж унікальних префіксів
+    size_t slots = 16;
+    unsigned bits = 4;
+    while (slots < 2 * distinct) {
+        slots *= 2;
+        ++bits;
+    }
+    t.slot_mask = static_cast<uint32_t>(slots - 1);
+    t.hash_shift = 32 - bits;
+    t.slot_key.assign(slots, 0);
+    t.slot_first.assign(slots, 0);
+    t.slot_count.assign(slots, 0);
+    t.ids = order;
+    for (size_t i = 0; i < order.size();) {
+        const uint32_t key = key_of[order[i]];
+        size_t end = i;
+        while (end < order.size() && key_of[order[end]] == key) {
+            ++end;
+        }
+        uint32_t slot = t.slot_of(key);
+        while (t.slot_count[slot]) {
+            slot = (slot + 1) & t.slot_mask;
+        }
+        t.slot_key[slot] = key;
+        t.slot_first[slot] = static_cast<uint32_t>(i);
+        t.slot_count[slot] = static_cast<uint32_t>(end - i);
+        i = end;
+    }
+
+    t.tail_offset.resize(t.patterns.size());
+    t.length.resize(t.patterns.size());
+    for (size_t id = 0; id < t.patterns.size(); ++id) {
+        const std::string& p = t.patterns[id];
+        t.length[id] = static_cast<uint32_t>(p.size());
+        t.tail_offset[id] = static_cast<uint32_t>(t.tails.size());
+        if (p.size() > L) {
+            t.tails.append(p, L, std::string::npos);
+        }
+    }
+}
+
+}  // namespace
+
+PatternSet::PatternSet(const std::vector<std::string>& patterns)
+    : tables_(new MultiPatternTables) {
+    tables_->patterns = patterns;
+    compile(*tables_);
+}
+
+PatternSet::~PatternSet() = default;
+PatternSet::PatternSet(PatternSet&&) noexcept = default;
+PatternSet& PatternSet::operator=(PatternSet&&) noexcept = default;
+
+size_t PatternSet::size() const {
+    return tables_ ? tables_->patterns.size() : 0;
+}
+
+const std::string& PatternSet::pattern(size_t index) const {
+    return tables_->patterns[index];
+}
+
+void PatternSet::count(const char* text, size_t len, uint64_t* counts) const {
+    if (!tables_) {
+        return;  // Набір, з якого перемістили
+    }
+    const MultiPatternTables& t = *tables_;
+    if (t.prefix_len == 0 || len < t.prefix_len) {
+        return;
+    }
+
+    size_t pos = 0;
+    const CpuTier tier = active_tier();
+    if (t.use_buckets) {
+        switch (tier) {
+        case CpuTier::AVX512: pos = multi_pattern_scan_avx512(t, text, len, counts); break;
+        case CpuTier::AVX2: pos = multi_pattern_scan_avx2(t, text, len, counts); break;
+        case CpuTier::SSE42: pos = multi_pattern_scan_sse42(t, text, len, counts); break;
+        case CpuTier::Scalar: break;
+        }
+    }
+    else if (tier == CpuTier::AVX512) {
+        pos = multi_pattern_hash_scan_avx512(t, text, len, counts);
+    }
+    else if (tier == CpuTier::AVX2) {
+        pos = multi_pattern_hash_scan_avx2(t, text, len, counts);
+    }
+
+    // Хвіст (і весь текст на нижчих рівнях): позиція перевіряється, якщо її префікс є в бітовій карті
+    for (; pos + 4 <= len; ++pos) {
+        uint32_t window;
+        memcpy(&window, text + pos, 4);
+        if (filter_hit(t, window & t.window_mask)) {
+            verify_candidate(t, text, len, pos, counts);
+        }
+    }
+    for (; pos + t.prefix_len <= len; ++pos) {
+        verify_candidate(t, text, len, pos, counts);
+    }
+}
+
+std::vector<uint64_t> PatternSet::count(const char* text, size_t len) const {
+    std::vector<uint64_t> counts(size(), 0);
+    count(text, len, counts.data());
+    return counts;
+}
+
+}  // namespace simd
@@ -0,0 +1,40 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace simd {
+
+struct MultiPatternTables;
+
+// Набір шаблонів для підрахунку входжень за один прохід по тексту.
+// Шаблони компілюються один раз за першими 1–4 байтами (префіксом). Для невеликих наборів
+// (до 32 різних префіксів) кандидати відсіюються таблицями півбайтів для 8 груп через pshufb,
+// для більших — бітовою картою хешів префіксів через gather. Повна перевірка кандидата
+// йде через хеш-таблицю за префіксом, тож її вартість майже не залежить від кількості шаблонів.
+class PatternSet {
+public:
+    explicit PatternSet(const std::vector<std::string>& patterns);
+    ~PatternSet();
+
+    // Набір, з якого перемістили, поводиться як порожній: size() == 0, count нічого не рахує
+    PatternSet(PatternSet&&) noexcept;
+    PatternSet& operator=(PatternSet&&) noexcept;
+
+    size_t size() const;
+    const std::string& pattern(size_t index) const;
+
+    // Додає до counts[i] кількість (у тому числі перекривних) входжень шаблону i в text.
+    // Порожні шаблони не рахуються.
+    void count(const char* text, size_t len, uint64_t* counts) const;
+
+    // Те саме, але повертає новий масив лічильників
+    std::vector<uint64_t> count(const char* text, size_t len) const;
+
+private:
+    std::unique_ptr<MultiPatternTables> tables_;
+};
+
+}  // namespace simd
@@ -0,0 +1,85 @@
+﻿#include <immintrin.h>
+
+#include "bit_ops.h"
+#include "multi_pattern_internal.h"
+
+#include "target_avx2.h"
+
+namespace simd {
+
+namespace {
+
+// Прохід блоками по 32 позиції. Для кожного байта префікса j шукаємо групи, у яких
+// обидва півбайти тексту в позиції i + j присутні (два pshufb), і перетинаємо результати.
+template<size_t L>
+size_t scan(const MultiPatternTables& t, const char* text, size_t len, uint64_t* counts) {
+    __m256i lo[L], hi[L];
+    for (size_t j = 0; j < L; ++j) {
+        lo[j] = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)t.lo[j]));
+        hi[j] = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)t.hi[j]));
+    }
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 32 + L - 1 <= len; i += 32) {
+        __m256i buckets = _mm256_set1_epi8(-1);
+        for (size_t j = 0; j < L; ++j) {
+            const __m256i chunk = _mm256_loadu_si256((const __m256i*)(text + i + j));
+            const __m256i lo_nibbles = _mm256_and_si256(chunk, nibble);
+            const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble);
+            buckets = _mm256_and_si256(buckets, _mm256_and_si256(_mm256_shuffle_epi8(lo[j], lo_nibbles),
+                                                                 _mm256_shuffle_epi8(hi[j], hi_nibbles)));
+        }
+        uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(buckets, zero)));
+        while (mask) {
+            verify_candidate(t, text, len, i + ctz32(mask), counts);
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+}  // namespace
+
+// Прохід із бітовою картою: 4 завантаження зі зсувом 0..3 дають 4-байтові вікна для всіх
+// 32 позицій блоку (по 8 у регістрі), хеш кожного вікна перевіряється через gather із карти
+size_t multi_pattern_hash_scan_avx2(const MultiPatternTables& t, const char* text, size_t len, uint64_t* counts) {
+    const __m256i window_mask = _mm256_set1_epi32(static_cast<int>(t.window_mask));
+    const __m256i multiplier = _mm256_set1_epi32(static_cast<int>(0x9E3779B1u));
+    const __m256i low5 = _mm256_set1_epi32(31);
+    const int* filter = reinterpret_cast<const int*>(t.filter);
+
+    size_t i = 0;
+    for (; i + 32 + 3 <= len; i += 32) {
+        uint32_t mask = 0;
+        for (unsigned offset = 0; offset < 4; ++offset) {
+            // Елемент k містить вікно позиції i + offset + 4k
+            const __m256i window = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(text + i + offset)), window_mask);
+            const __m256i h = _mm256_srli_epi32(_mm256_mullo_epi32(window, multiplier), 16);
+            const __m256i word = _mm256_i32gather_epi32(filter, _mm256_srli_epi32(h, 5), 4);
+            // Переносимо потрібний біт у знаковий розряд і збираємо маску
+            const __m256i bit = _mm256_sllv_epi32(word, _mm256_sub_epi32(low5, _mm256_and_si256(h, low5)));
+            const uint32_t hits = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(bit)));
+            mask |= _pdep_u32(hits, 0x11111111u << offset);
+        }
+        while (mask) {
+            verify_candidate(t, text, len, i + ctz32(mask), counts);
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+size_t multi_pattern_scan_avx2(const MultiPatternTables& t, const char* text, size_t len, uint64_t* counts) {
+    switch (t.prefix_len) {
+    case 1: return scan<1>(t, text, len, counts);
+    case 2: return scan<2>(t, text, len, counts);
+    case 3: return scan<3>(t, text, len, counts);
+    default: return scan<4>(t, text, len, counts);
+    }
+}
+
+}  // namespace simd
+
+#include "target_end.h"
@@ -0,0 +1,80 @@
+﻿#include <immintrin.h>
+
+#include "bit_ops.h"
+#include "multi_pattern_internal.h"
+
+#include "target_avx512.h"
+
+namespace simd {
+
+namespace {
+
+// Той самий фільтр, що й у multi_pattern_avx2.cpp, блоками по 64 позиції;
+// ненульові байти одразу перетворюються на маску через vptestmb
+template<size_t L>
+size_t scan(const MultiPatternTables& t, const char* text, size_t len, uint64_t* counts) {
+    __m512i lo[L], hi[L];
+    for (size_t j = 0; j < L; ++j) {
+        lo[j] = _mm512_broadcast_i32x4(_mm_load_si128((const __m128i*)t.lo[j]));
+        hi[j] = _mm512_broadcast_i32x4(_mm_load_si128((const __m128i*)t.hi[j]));
+    }
+    const __m512i nibble = _mm512_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 64 + L - 1 <= len; i += 64) {
+        __m512i buckets = _mm512_set1_epi8(-1);
+        for (size_t j = 0; j < L; ++j) {
+            const __m512i chunk = _mm512_loadu_si512(text + i + j);
+            const __m512i lo_nibbles = _mm512_and_si512(chunk, nibble);
+            const __m512i hi_nibbles = _mm512_and_si512(_mm512_srli_epi16(chunk, 4), nibble);
+            buckets = _mm512_and_si512(buckets, _mm512_and_si512(_mm512_shuffle_epi8(lo[j], lo_nibbles),
+                                                                 _mm512_shuffle_epi8(hi[j], hi_nibbles)));
+        }
+        uint64_t mask = _mm512_test_epi8_mask(buckets, buckets);
+        while (mask) {
+            verify_candidate(t, text, len, i + ctz64(mask), counts);
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+}  // namespace
+
+// Прохід із бітовою картою (див. multi_pattern_avx2.cpp), 16 вікон на регістр, 64 позиції на блок
+size_t multi_pattern_hash_scan_avx512(const MultiPatternTables& t, const char* text, size_t len, uint64_t* counts) {
+    const __m512i window_mask = _mm512_set1_epi32(static_cast<int>(t.window_mask));
+    const __m512i multiplier = _mm512_set1_epi32(static_cast<int>(0x9E3779B1u));
+    const __m512i low5 = _mm512_set1_epi32(31);
+    const __m512i one = _mm512_set1_epi32(1);
+
+    size_t i = 0;
+    for (; i + 64 + 3 <= len; i += 64) {
+        uint64_t mask = 0;
+        for (unsigned offset = 0; offset < 4; ++offset) {
+            const __m512i window = _mm512_and_si512(_mm512_loadu_si512(text + i + offset), window_mask);
+            const __m512i h = _mm512_srli_epi32(_mm512_mullo_epi32(window, multiplier), 16);
+            const __m512i word = _mm512_i32gather_epi32(_mm512_srli_epi32(h, 5), t.filter, 4);
+            const __mmask16 hits = _mm512_test_epi32_mask(word, _mm512_sllv_epi32(one, _mm512_and_si512(h, low5)));
+            mask |= _pdep_u64(hits, 0x1111111111111111ull << offset);
+        }
+        while (mask) {
+            verify_candidate(t, text, len, i + ctz64(mask), counts);
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+size_t multi_pattern_scan_avx512(const MultiPatternTables& t, const char* text, size_t len, uint64_t* counts) {
+    switch (t.prefix_len) {
+    case 1: return scan<1>(t, text, len, counts);
+    case 2: return scan<2>(t, text, len, counts);
+    case 3: return scan<3>(t, text, len, counts);
+    default: return scan<4>(t, text, len, counts);
+    }
+}
+
+}  // namespace simd
+
+#include "target_end.h"
@@ -0,0 +1,93 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace simd {
+
+// Скомпільований набір шаблонів (див. PatternSet)
+struct MultiPatternTables {
+    std::vector<std::string> patterns;
+
+    // Довжина префікса L (1..4), за яким фільтруються кандидати; 0 — немає непорожніх шаблонів
+    size_t prefix_len = 0;
+
+    // Біт b у lo[j][n] (hi[j][n]) означає, що в групі b є шаблон, у якого байт j
+    // має молодший (старший) півбайт n. Кандидат — позиція, де для всіх j < L збігся хоч один біт.
+    alignas(16) uint8_t lo[4][16] = {};
+    alignas(16) uint8_t hi[4][16] = {};
+
+    // Хеш-таблиця з відкритою адресацією: префікс -> діапазон у ids шаблонів із цим префіксом
+    std::vector<uint32_t> slot_key;
+    std::vector<uint32_t> slot_first;
+    std::vector<uint32_t> slot_count;   // 0 — порожній слот
+    uint32_t slot_mask = 0;
+    unsigned hash_shift = 32;
+    std::vector<uint32_t> ids;
+
+    // Для великих наборів групи півбайтів майже нічого не відсіюють, тому замість них
+    // використовується бітова карта на 2^16 біт, індексована хешем префікса (див. filter_hash)
+    bool use_buckets = true;
+    uint32_t window_mask = 0;           // Залишає у 4-байтовому вікні лише перші L байтів
+    uint32_t filter[1 << 11] = {};
+
+    // Хвости шаблонів після префікса, складені в один буфер
+    std::string tails;
+    std::vector<uint32_t> tail_offset;
+    std::vector<uint32_t> length;
+
+    uint32_t slot_of(uint32_t key) const {
+        return static_cast<uint32_t>((key * 0x9E3779B1u) >> hash_shift) & slot_mask;
+    }
+};
+
+// 16-бітний хеш префікса для бітової карти
+inline uint32_t filter_hash(uint32_t key) {
+    return (key * 0x9E3779B1u) >> 16;
+}
+
+inline bool filter_hit(const MultiPatternTables& t, uint32_t key) {
+    const uint32_t h = filter_hash(key);
+    return (t.filter[h >> 5] >> (h & 31)) & 1u;
+}
+
+// Перші prefix_len байтів тексту як ключ (pos + prefix_len <= len)
+inline uint32_t load_prefix(const char* p, size_t prefix_len) {
+    uint32_t key = 0;
+    memcpy(&key, p, prefix_len);
+    return key;
+}
+
+// Повна перевірка кандидата в позиції pos: збільшує лічильники всіх шаблонів, що там починаються
+inline void verify_candidate(const MultiPatternTables& t, const char* text, size_t len, size_t pos, uint64_t* counts) {
+    const uint32_t key = load_prefix(text + pos, t.prefix_len);
+    for (uint32_t slot = t.slot_of(key); t.slot_count[slot]; slot = (slot + 1) & t.slot_mask) {
+        if (t.slot_key[slot] != key) {
+            continue;
+        }
+        const size_t rest = len - pos - t.prefix_len;
+        const char* tail = text + pos + t.prefix_len;
+        for (uint32_t i = 0; i < t.slot_count[slot]; ++i) {
+            const uint32_t id = t.ids[t.slot_first[slot] + i];
+            const size_t tail_len = t.length[id] - t.prefix_len;
+            if (tail_len <= rest && memcmp(tail, t.tails.data() + t.tail_offset[id], tail_len) == 0) {
+                ++counts[id];
+            }
+        }
+        return;
+    }
+}
+
+// Векторні проходи: обробляють текст повними блоками й повертають позицію,
+// з якої решту має доперевірити скалярний цикл
+size_t multi_pattern_scan_sse42(const MultiPatternTables& t, const char* text, size_t len, uint64_t* counts);
+size_t multi_pattern_scan_avx2(const MultiPatternTables& t, const char* text, size_t len, uint64_t* counts);
+size_t multi_pattern_scan_avx512(const MultiPatternTables& t, const char* text, size_t len, uint64_t* counts);
+
+// Те саме з фільтром через бітову карту (gather по 8 або 16 позиціях)
+size_t multi_pattern_hash_scan_avx2(const MultiPatternTables& t, const char* text, size_t len, uint64_t* counts);
+size_t multi_pattern_hash_scan_avx512(const MultiPatternTables& t, const char* text, size_t len, uint64_t* counts);
+
+}  // namespace simd
@@ -0,0 +1,55 @@
+﻿#include <immintrin.h>
+
+#include "bit_ops.h"
+#include "multi_pattern_internal.h"
+
+#include "target_sse42.h"
+
+namespace simd {
+
+namespace {
+
+// Той самий фільтр, що й у multi_pattern_avx2.cpp, блоками по 16 позицій
+template<size_t L>
+size_t scan(const MultiPatternTables& t, const char* text, size_t len, uint64_t* counts) {
+    __m128i lo[L], hi[L];
+    for (size_t j = 0; j < L; ++j) {
+        lo[j] = _mm_load_si128((const __m128i*)t.lo[j]);
+        hi[j] = _mm_load_si128((const __m128i*)t.hi[j]);
+    }
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 16 + L - 1 <= len; i += 16) {
+        __m128i buckets = _mm_set1_epi8(-1);
+        for (size_t j = 0; j < L; ++j) {
+            const __m128i chunk = _mm_loadu_si128((const __m128i*)(text + i + j));
+            const __m128i lo_nibbles = _mm_and_si128(chunk, nibble);
+            const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi16(chunk, 4), nibble);
+            buckets = _mm_and_si128(buckets, _mm_and_si128(_mm_shuffle_epi8(lo[j], lo_nibbles),
+                                                           _mm_shuffle_epi8(hi[j], hi_nibbles)));
+        }
+        uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(buckets, zero))) & 0xFFFF;
+        while (mask) {
+            verify_candidate(t, text, len, i + ctz32(mask), counts);
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+}  // namespace
+
+size_t multi_pattern_scan_sse42(const MultiPatternTables& t, const char* text, size_t len, uint64_t* counts) {
+    switch (t.prefix_len) {
+    case 1: return scan<1>(t, text, len, counts);
+    case 2: return scan<2>(t, text, len, counts);
+    case 3: return scan<3>(t, text, len, counts);
+    default: return scan<4>(t, text, len, counts);
+    }
+}
+
+}  // namespace simd
+
+#include "target_end.h"
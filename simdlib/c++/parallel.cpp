@@ -0,0 +1,97 @@
+﻿#include "parallel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "kernels.h"
+
+namespace simd {
+
+namespace {
+
+const size_t CACHE_LINE = 64;
+
+// Статичний розподіл size елементів розміру element між count частинами. Перша межа
+// після початку масиву — перший вирівняний на 64 байти елемент, далі межі йдуть цілими рядками кешу.
+struct StaticPartition {
+    size_t size;
+    size_t head;      // Елементи до першого вирівняного рядка
+    size_t per_line;  // Елементів у рядку кешу
+    size_t count;
+
+    StaticPartition(const void* base, size_t element, size_t size, size_t count)
+        : size(size), head(0), per_line(CACHE_LINE / element), count(count) {
+        const size_t misalignment = reinterpret_cast<uintptr_t>(base) % CACHE_LINE;
+        if (misalignment % element == 0) {
+            head = std::min(size, (CACHE_LINE - misalignment) % CACHE_LINE / element);
+        }
+    }
+
+    size_t boundary(size_t index) const {
+        if (index == 0) {
+            return 0;
+        }
+        if (index >= count) {
+            return size;
+        }
+        const size_t lines = (size - head) / per_line;
+        return head + lines * index / count * per_line;
+    }
+};
+
+// Виконує fn(begin, end) для частин масиву result: в одному потоці для малих обсягів, інакше на pool
+template <typename T, typename Fn>
+void run_partitioned(const T* result, size_t size, size_t arrays, ThreadPool& pool, Fn fn) {
+    if (size * sizeof(T) * arrays < PARALLEL_MIN_BYTES || pool.size() == 1) {
+        fn(0, size);
+        return;
+    }
+    const StaticPartition partition(result, sizeof(T), size, pool.size());
+    pool.run_on_all([&](size_t index, size_t) {
+        const size_t begin = partition.boundary(index);
+        const size_t end = partition.boundary(index + 1);
+        if (begin < end) {
+            fn(begin, end);
+        }
+    });
+}
+
+}  // namespace
+
+void parallel_add_arrays(const int* a, const int* b, int* result, size_t size, ThreadPool& pool) {
+    const KernelTable& table = kernels();
+    const auto kernel = 3 * size * sizeof(int) >= streaming_threshold() ? table.add_i32_stream : table.add_i32;
+    run_partitioned(result, size, 3, pool, [&](size_t begin, size_t end) {
+        kernel(a + begin, b + begin, result + begin, end - begin);
+    });
+}
+
+void parallel_add_vectors(const float* a, const float* b, float* result, size_t size, ThreadPool& pool) {
+    const KernelTable& table = kernels();
+    const auto kernel = 3 * size * sizeof(float) >= streaming_threshold() ? table.add_f32_stream : table.add_f32;
+    run_partitioned(result, size, 3, pool, [&](size_t begin, size_t end) {
+        kernel(a + begin, b + begin, result + begin, end - begin);
+    });
+}
+
+void parallel_multiply_vectors(const float* a, const float* b, float* result, size_t size, ThreadPool& pool) {
+    const KernelTable& table = kernels();
+    const auto kernel = 3 * size * sizeof(float) >= streaming_threshold() ? table.mul_f32_stream : table.mul_f32;
+    run_partitioned(result, size, 3, pool, [&](size_t begin, size_t end) {
+        kernel(a + begin, b + begin, result + begin, end - begin);
+    });
+}
+
+void first_touch(void* data, size_t bytes, ThreadPool& pool, size_t arrays) {
+    // Ділимо в 4-байтових елементах, щоб межі збіглися з межами паралельних ядер на тому ж масиві;
+    // останні bytes % 4 байтів дописуються окремо
+    char* bytes_ptr = static_cast<char*>(data);
+    const size_t words = bytes / 4;
+    run_partitioned(reinterpret_cast<const float*>(data), words, arrays, pool, [&](size_t begin, size_t end) {
+        memset(bytes_ptr + begin * 4, 0, (end - begin) * 4);
+    });
+    memset(bytes_ptr + words * 4, 0, bytes % 4);
+}
+
+}  // namespace simd
@@ -0,0 +1,29 @@
+﻿#pragma once
+#include <cstddef>
+
+#include "thread_pool.h"
+
+namespace simd {
+
+// Якщо всі масиви виклику разом менші за цей розмір, паралельні версії працюють в одному потоці:
+// пробудження пулу коштує кілька мікросекунд, а такий обсяг одне ядро обробляє не довше.
+const size_t PARALLEL_MIN_BYTES = 1u << 20;
+
+// Паралельні версії поелементних ядер. Масив ділиться статично на pool.size() частин із межами,
+// вирівняними на 64 байти відносно адреси result (сусідні потоки не пишуть в один рядок кешу).
+// Частина index завжди дістається тому самому потоку, тож після first_touch із тим самим пулом
+// кожен потік працює з пам'яттю свого NUMA-вузла. Кожна частина рахується диспетчеризованим ядром
+// (потоковим, якщо весь виклик перевищує streaming_threshold()).
+void parallel_add_arrays(const int* a, const int* b, int* result, size_t size, ThreadPool& pool = default_pool());
+void parallel_add_vectors(const float* a, const float* b, float* result, size_t size, ThreadPool& pool = default_pool());
+void parallel_multiply_vectors(const float* a, const float* b, float* result, size_t size,
+                               ThreadPool& pool = default_pool());
+
+// Заповнює bytes байтів нулями з тим самим розподілом між потоками, що й паралельні ядра
+// (для масивів із 4-байтовими елементами). Викликається одразу після виділення пам'яті:
+// ОС розміщує сторінку на вузлі потоку, який першим у неї записав. arrays — кількість масивів
+// виклику ядра, для якого готується пам'ять: від неї залежить, чи піде ядро в один потік
+// (поріг PARALLEL_MIN_BYTES рахується за всіма масивами разом), і first_touch вирішує так само.
+void first_touch(void* data, size_t bytes, ThreadPool& pool = default_pool(), size_t arrays = 3);
+
+}  // namespace simd
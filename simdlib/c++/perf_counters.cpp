@@ -0,0 +1,180 @@
+﻿#include "perf_counters.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define SIMDLIB_PERF_EVENTS 1
+#endif
+
+namespace simd {
+
+namespace {
+
+#ifdef SIMDLIB_PERF_EVENTS
+
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+// У порядку Counter
+const EventConfig EVENTS[COUNTER_COUNT] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_REF_CPU_CYCLES },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+};
+
+int open_event(const EventConfig& event, pid_t tid) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+}
+
+// Ідентифікатори потоків процесу з /proc/self/task
+std::vector<pid_t> process_threads() {
+    std::vector<pid_t> threads;
+    if (DIR* dir = opendir("/proc/self/task")) {
+        while (const dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                threads.push_back(static_cast<pid_t>(std::atol(entry->d_name)));
+            }
+        }
+        closedir(dir);
+    }
+    if (threads.empty()) {
+        threads.push_back(0);  // 0 — потік, що викликав
+    }
+    return threads;
+}
+
+std::string open_error(int error) {
+    switch (error) {
+    case ENOENT:
+    case EOPNOTSUPP: return "the CPU or hypervisor exposes no hardware performance counters";
+    case EACCES:
+    case EPERM: return "access denied (see /proc/sys/kernel/perf_event_paranoid)";
+    case ENOSYS: return "perf_event_open is not supported by the kernel";
+    default: return std::string("perf_event_open failed: ") + std::strerror(error);
+    }
+}
+
+#endif  // SIMDLIB_PERF_EVENTS
+
+}  // namespace
+
+const char* counter_name(Counter counter) {
+    switch (counter) {
+    case Counter::Cycles: return "cycles";
+    case Counter::Instructions: return "instructions";
+    case Counter::RefCycles: return "ref_cycles";
+    case Counter::L1dMisses: return "l1d_misses";
+    case Counter::LlcMisses: return "llc_misses";
+    }
+    return "unknown";
+}
+
+CounterValues::CounterValues() {
+    for (double& v : value) {
+        v = NAN;
+    }
+}
+
+bool CounterValues::has(Counter counter) const {
+    return !std::isnan((*this)[counter]);
+}
+
+PerfCounters::PerfCounters() {
+#ifdef SIMDLIB_PERF_EVENTS
+    for (pid_t tid : process_threads()) {
+        for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+            const int fd = open_event(EVENTS[c], tid);
+            if (fd < 0 && c == 0 && error_.empty()) {
+                error_ = open_error(errno);
+            }
+            fds_.push_back(fd);
+            available_ |= c == 0 && fd >= 0;
+        }
+    }
+    if (available_) {
+        error_.clear();  // Потік міг завершитися між читанням /proc і відкриттям лічильника
+    }
+    else if (error_.empty()) {
+        error_ = "no threads to count";
+    }
+#else
+    error_ = "hardware performance counters are only supported on Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef SIMDLIB_PERF_EVENTS
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+void PerfCounters::start() {
+#ifdef SIMDLIB_PERF_EVENTS
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+CounterValues PerfCounters::stop() {
+    CounterValues result;
+#ifdef SIMDLIB_PERF_EVENTS
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (size_t i = 0; i < fds_.size(); ++i) {
+        uint64_t data[3];  // Значення, time_enabled, time_running
+        if (fds_[i] < 0 || read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+            continue;
+        }
+        double& total = result.value[i % COUNTER_COUNT];
+        const double scaled = static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        total = std::isnan(total) ? scaled : total + scaled;
+    }
+#endif
+    return result;
+}
+
+bool perf_counters_supported(std::string* reason) {
+    static const std::string error = [] {
+        PerfCounters probe;
+        return probe.available() ? std::string() : probe.error();
+    }();
+    if (reason) {
+        *reason = error;
+    }
+    return error.empty();
+}
+
+}  // namespace simd
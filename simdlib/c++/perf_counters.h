@@ -0,0 +1,63 @@
+﻿#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace simd {
+
+// Апаратні лічильники, які збирає PerfCounters
+enum class Counter {
+    Cycles,        // Такти ядра (на реальній частоті, тож падіння частоти під AVX-512 їх не зменшує)
+    Instructions,  // Виконані інструкції
+    RefCycles,     // Такти на номінальній частоті; cycles / ref_cycles — відносна частота ядра
+    L1dMisses,     // Промахи читання L1D
+    LlcMisses,     // Промахи кешу останнього рівня (звернення до пам'яті)
+};
+
+const size_t COUNTER_COUNT = 5;
+
+// Назва лічильника: "cycles", "instructions", "ref_cycles", "l1d_misses", "llc_misses"
+const char* counter_name(Counter counter);
+
+// Значення лічильників за інтервал, сумарно по всіх потоках. Лічильник, який не вдалося відкрити або
+// який жодного разу не потрапив на апаратний лічильник, — NaN. Якщо ядро ділило лічильники з іншими
+// подіями (мультиплексування), значення масштабуються на частку часу, коли подію рахували.
+struct CounterValues {
+    double value[COUNTER_COUNT];
+
+    CounterValues();
+    double operator[](Counter counter) const { return value[static_cast<size_t>(counter)]; }
+    bool has(Counter counter) const;
+};
+
+// Лічильники perf_event_open (Linux) для всіх потоків процесу, що існують на момент створення:
+// потоки пулу створюються заздалегідь, тож паралельні ядра враховуються повністю. Рахується лише
+// код користувача (exclude_kernel), що дозволено за perf_event_paranoid <= 2.
+// Якщо лічильники недоступні (не Linux, віртуальна машина без PMU, заборона в контейнері),
+// available() повертає false, error() пояснює причину, а stop() повертає NaN для всіх лічильників.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Чи вдалося відкрити хоча б лічильник тактів
+    bool available() const { return available_; }
+    const std::string& error() const { return error_; }
+
+    // Обнуляє й вмикає лічильники; stop() вимикає їх і повертає значення з моменту start()
+    void start();
+    CounterValues stop();
+
+private:
+    std::vector<int> fds_;  // COUNTER_COUNT дескрипторів на потік, -1 — не відкрито
+    bool available_ = false;
+    std::string error_;
+};
+
+// Чи можна взагалі відкрити лічильники (перевіряється один раз); reason — причина, якщо ні
+bool perf_counters_supported(std::string* reason = nullptr);
+
+}  // namespace simd
@@ -0,0 +1,138 @@
+﻿#include "reduce.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "kernels.h"
+#include "parallel.h"
+#include "reduce_internal.h"
+#include "thread_pool.h"
+
+namespace simd {
+
+namespace {
+
+// Блок двопрохідної префіксної суми. Розмір фіксований, тож межі блоків (а з ними й порядок
+// додавань для float) не залежать від кількості потоків.
+const size_t SCAN_BLOCK = size_t(1) << 16;
+
+// Сума блоку в типі елементів: для int32_t — за модулем 2^32, як і сама префіксна сума
+int32_t block_total(const ReduceKernels<int32_t, int64_t>& k, const int32_t* data, size_t size) {
+    return static_cast<int32_t>(static_cast<uint32_t>(k.sum(data, size)));
+}
+
+float block_total(const ReduceKernels<float, float>& k, const float* data, size_t size) {
+    return k.sum(data, size);
+}
+
+template <typename T, typename Sum>
+void scan(const ReduceKernels<T, Sum>& k, bool inclusive, const T* data, T* result, size_t size, T offset) {
+    const auto kernel = inclusive ? k.inclusive_scan : k.exclusive_scan;
+    ThreadPool& pool = default_pool();
+    // Шлях обирається лише за розміром: з одним потоком обидва проходи йдуть у потоці, що викликав
+    // (parallel_for тоді виконує шматки на місці), і float-результат не залежить від кількості потоків
+    if (size * sizeof(T) * 2 < PARALLEL_MIN_BYTES) {
+        kernel(data, result, size, offset);
+        return;
+    }
+
+    // Перший прохід: суми блоків; між проходами — їхня послідовна префіксна сума (блоків мало)
+    const size_t blocks = (size + SCAN_BLOCK - 1) / SCAN_BLOCK;
+    std::vector<T> offsets(blocks);
+    pool.parallel_for(blocks, 4, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; ++b) {
+            const size_t begin = b * SCAN_BLOCK;
+            offsets[b] = block_total(k, data + begin, std::min(SCAN_BLOCK, size - begin));
+        }
+    });
+    k.exclusive_scan(offsets.data(), offsets.data(), blocks, offset);
+
+    // Другий прохід: кожен блок зі своїм зсувом
+    pool.parallel_for(blocks, 4, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; ++b) {
+            const size_t begin = b * SCAN_BLOCK;
+            kernel(data + begin, result + begin, std::min(SCAN_BLOCK, size - begin), offsets[b]);
+        }
+    });
+}
+
+}  // namespace
+
+const ReduceTable& reduce_kernels_for(CpuTier tier) {
+    switch (tier) {
+    case CpuTier::AVX512: return avx512_reduce;
+    case CpuTier::AVX2: return avx2_reduce;
+    case CpuTier::SSE42: return sse42_reduce;
+    default: return scalar_reduce;
+    }
+}
+
+const ReduceTable& reduce_kernels() {
+    return reduce_kernels_for(active_tier());
+}
+
+int64_t reduce_sum(const int32_t* data, size_t size) {
+    return reduce_kernels().i32.sum(data, size);
+}
+
+float reduce_sum(const float* data, size_t size) {
+    return reduce_kernels().f32.sum(data, size);
+}
+
+int32_t reduce_min(const int32_t* data, size_t size) {
+    return reduce_kernels().i32.min(data, size);
+}
+
+float reduce_min(const float* data, size_t size) {
+    return reduce_kernels().f32.min(data, size);
+}
+
+int32_t reduce_max(const int32_t* data, size_t size) {
+    return reduce_kernels().i32.max(data, size);
+}
+
+float reduce_max(const float* data, size_t size) {
+    return reduce_kernels().f32.max(data, size);
+}
+
+size_t argmin(const int32_t* data, size_t size) {
+    return reduce_kernels().i32.argmin(data, size);
+}
+
+size_t argmin(const float* data, size_t size) {
+    return reduce_kernels().f32.argmin(data, size);
+}
+
+size_t argmax(const int32_t* data, size_t size) {
+    return reduce_kernels().i32.argmax(data, size);
+}
+
+size_t argmax(const float* data, size_t size) {
+    return reduce_kernels().f32.argmax(data, size);
+}
+
+size_t count_if(const int32_t* data, size_t size, Compare compare, int32_t value) {
+    return reduce_kernels().i32.count_if(data, size, compare, value);
+}
+
+size_t count_if(const float* data, size_t size, Compare compare, float value) {
+    return reduce_kernels().f32.count_if(data, size, compare, value);
+}
+
+void inclusive_scan(const int32_t* data, int32_t* result, size_t size, int32_t offset) {
+    scan(reduce_kernels().i32, true, data, result, size, offset);
+}
+
+void inclusive_scan(const float* data, float* result, size_t size, float offset) {
+    scan(reduce_kernels().f32, true, data, result, size, offset);
+}
+
+void exclusive_scan(const int32_t* data, int32_t* result, size_t size, int32_t offset) {
+    scan(reduce_kernels().i32, false, data, result, size, offset);
+}
+
+void exclusive_scan(const float* data, float* result, size_t size, float offset) {
+    scan(reduce_kernels().f32, false, data, result, size, offset);
+}
+
+}  // namespace simd
@@ -0,0 +1,70 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu_features.h"
+
+namespace simd {
+
+// Умова для count_if: елемент x порівнюється зі значенням value (x < value тощо).
+// Для float порівняння з NaN хибні, крім NotEqual, — як у C++.
+enum class Compare { Less, LessEqual, Equal, NotEqual, Greater, GreaterEqual };
+
+// Згортки й префіксні суми одного типу. Sum — тип суми (для int32_t — int64_t, без переповнення)
+template <typename T, typename Sum>
+struct ReduceKernels {
+    Sum (*sum)(const T* data, size_t size);
+    T (*min)(const T* data, size_t size);
+    T (*max)(const T* data, size_t size);
+    size_t (*argmin)(const T* data, size_t size);
+    size_t (*argmax)(const T* data, size_t size);
+    size_t (*count_if)(const T* data, size_t size, Compare compare, T value);
+
+    // result[i] = offset + data[0] + ... + data[i] (inclusive) або offset + data[0] + ... + data[i - 1] (exclusive)
+    void (*inclusive_scan)(const T* data, T* result, size_t size, T offset);
+    void (*exclusive_scan)(const T* data, T* result, size_t size, T offset);
+};
+
+// Таблиця згорток одного рівня
+struct ReduceTable {
+    CpuTier tier;
+    ReduceKernels<int32_t, int64_t> i32;
+    ReduceKernels<float, float> f32;
+};
+
+// Таблиця активного рівня (той самий рівень, що й у kernels()) і таблиця конкретного рівня
+const ReduceTable& reduce_kernels();
+const ReduceTable& reduce_kernels_for(CpuTier tier);
+
+// Сума всіх елементів. Для int32_t — точна в int64_t. Для float — кількома акумуляторами
+// на всю ширину регістра, як DotMode::Fast: похибка не більша за (size / L + log2(L) + 1) * 2^-24 * sum |x|.
+int64_t reduce_sum(const int32_t* data, size_t size);
+float reduce_sum(const float* data, size_t size);
+
+// Найменший і найбільший елементи; для порожнього масиву — INT32_MAX/INT32_MIN або +inf/-inf.
+// Результат для масивів із NaN не визначений.
+int32_t reduce_min(const int32_t* data, size_t size);
+float reduce_min(const float* data, size_t size);
+int32_t reduce_max(const int32_t* data, size_t size);
+float reduce_max(const float* data, size_t size);
+
+// Індекс першого найменшого (найбільшого) елемента; size, якщо масив порожній
+size_t argmin(const int32_t* data, size_t size);
+size_t argmin(const float* data, size_t size);
+size_t argmax(const int32_t* data, size_t size);
+size_t argmax(const float* data, size_t size);
+
+// Кількість елементів x, для яких виконується "x compare value". Рахується маскою порівняння й popcount.
+size_t count_if(const int32_t* data, size_t size, Compare compare, int32_t value);
+size_t count_if(const float* data, size_t size, Compare compare, float value);
+
+// Префіксні суми; result може збігатися з data. Цілі додаються за модулем 2^32.
+// Масиви від 1 МіБ рахуються в два проходи в default_pool(): суми блоків фіксованого розміру,
+// їхня послідовна префіксна сума, потім префіксні суми блоків зі своїм зсувом. Для float порядок
+// додавань залежить від рівня й від того, чи пішов масив двопрохідним шляхом, але не від кількості потоків.
+void inclusive_scan(const int32_t* data, int32_t* result, size_t size, int32_t offset = 0);
+void inclusive_scan(const float* data, float* result, size_t size, float offset = 0.0f);
+void exclusive_scan(const int32_t* data, int32_t* result, size_t size, int32_t offset = 0);
+void exclusive_scan(const float* data, float* result, size_t size, float offset = 0.0f);
+
+}  // namespace simd
@@ -0,0 +1,397 @@
+﻿#include <immintrin.h>
+#include <cstdint>
+#include <limits>
+
+#include "reduce_internal.h"
+
+#include "target_avx2.h"
+
+// Згортки на 256-бітних регістрах. Залишок читається vpmaskmov і доповнюється заповнювачем
+// (нейтральним елементом згортки), тож окремого скалярного циклу немає; горизонтальні згортки —
+// перестановками в регістрах, без вивантаження в пам'ять.
+namespace simd {
+
+namespace {
+
+// Маска перших n смуг: старший біт елемента встановлено
+__m256i first_lanes(size_t n) {
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(n)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+template <typename T> struct Vec;
+
+template <>
+struct Vec<int32_t> {
+    using reg = __m256i;
+    using mask = __m256i;
+    static const size_t lanes = 8;
+    static reg load(const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(int32_t* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static reg load_fill(const int32_t* p, size_t n, int32_t fill) {
+        const __m256i m = first_lanes(n);
+        return _mm256_blendv_epi8(_mm256_set1_epi32(fill), _mm256_maskload_epi32(reinterpret_cast<const int*>(p), m), m);
+    }
+    static void store_first(int32_t* p, size_t n, reg v) { _mm256_maskstore_epi32(reinterpret_cast<int*>(p), first_lanes(n), v); }
+    static reg set1(int32_t x) { return _mm256_set1_epi32(x); }
+    static reg zero() { return _mm256_setzero_si256(); }
+    static reg lane_indices() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+    static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+    // Беззнакових і нестрогих порівнянь немає: le, ge і ne — інверсії gt, lt і eq
+    static mask lt(reg a, reg b) { return _mm256_cmpgt_epi32(b, a); }
+    static mask le(reg a, reg b) { return invert(gt(a, b)); }
+    static mask eq(reg a, reg b) { return _mm256_cmpeq_epi32(a, b); }
+    static mask ne(reg a, reg b) { return invert(eq(a, b)); }
+    static mask gt(reg a, reg b) { return _mm256_cmpgt_epi32(a, b); }
+    static mask ge(reg a, reg b) { return invert(lt(a, b)); }
+    static mask invert(mask m) { return _mm256_xor_si256(m, _mm256_set1_epi32(-1)); }
+    // Елементи a там, де маску встановлено, інакше b
+    static reg select(mask m, reg a, reg b) { return _mm256_blendv_epi8(b, a, m); }
+    static __m256i select_index(mask m, __m256i a, __m256i b) { return _mm256_blendv_epi8(b, a, m); }
+    static size_t count(mask m) { return _mm_popcnt_u32(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m)))); }
+    static size_t count_first(mask m, size_t n) {
+        return _mm_popcnt_u32(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m))) & ((1u << n) - 1));
+    }
+    static int32_t hmin(reg x) {
+        __m128i y = _mm_min_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+        y = _mm_min_epi32(y, _mm_shuffle_epi32(y, 0x4E));
+        return _mm_cvtsi128_si32(_mm_min_epi32(y, _mm_shuffle_epi32(y, 0xB1)));
+    }
+    static int32_t hmax(reg x) {
+        __m128i y = _mm_max_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+        y = _mm_max_epi32(y, _mm_shuffle_epi32(y, 0x4E));
+        return _mm_cvtsi128_si32(_mm_max_epi32(y, _mm_shuffle_epi32(y, 0xB1)));
+    }
+    // Частини для суми без переповнення (див. sum_i32_avx2) і сума смуг у int64_t
+    static reg low16(reg x) { return _mm256_and_si256(x, _mm256_set1_epi32(0xFFFF)); }
+    static reg high16(reg x) { return _mm256_srai_epi32(x, 16); }
+    static int64_t widen_sum(reg x) {
+        const __m256i wide = _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)),
+                                              _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+        const __m128i half = _mm_add_epi64(_mm256_castsi256_si128(wide), _mm256_extracti128_si256(wide, 1));
+        return _mm_cvtsi128_si64(_mm_add_epi64(half, _mm_unpackhi_epi64(half, half)));
+    }
+    // Префіксна сума в регістрі: зсуви в межах 128-бітних половин, потім остання сума нижньої
+    // половини додається до всієї верхньої
+    static reg prefix(reg x) {
+        x = add(x, _mm256_slli_si256(x, 4));
+        x = add(x, _mm256_slli_si256(x, 8));
+        const __m256i low_total = _mm256_shuffle_epi32(x, 0xFF);
+        return add(x, _mm256_permute2x128_si256(low_total, low_total, 0x08));
+    }
+    static reg shift_up(reg x) {
+        return _mm256_blend_epi32(_mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6)), zero(), 0x01);
+    }
+    static reg broadcast_last(reg x) { return _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7)); }
+};
+
+template <>
+struct Vec<float> {
+    using reg = __m256;
+    using mask = __m256;
+    static const size_t lanes = 8;
+    static reg load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, reg v) { _mm256_storeu_ps(p, v); }
+    static reg load_fill(const float* p, size_t n, float fill) {
+        const __m256i m = first_lanes(n);
+        return _mm256_blendv_ps(_mm256_set1_ps(fill), _mm256_maskload_ps(p, m), _mm256_castsi256_ps(m));
+    }
+    static void store_first(float* p, size_t n, reg v) { _mm256_maskstore_ps(p, first_lanes(n), v); }
+    static reg set1(float x) { return _mm256_set1_ps(x); }
+    static reg zero() { return _mm256_setzero_ps(); }
+    static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+    static mask lt(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static mask le(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static mask eq(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static mask ne(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+    static mask gt(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static mask ge(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static reg select(mask m, reg a, reg b) { return _mm256_blendv_ps(b, a, m); }
+    static __m256i select_index(mask m, __m256i a, __m256i b) { return _mm256_blendv_epi8(b, a, _mm256_castps_si256(m)); }
+    static size_t count(mask m) { return _mm_popcnt_u32(static_cast<unsigned>(_mm256_movemask_ps(m))); }
+    static size_t count_first(mask m, size_t n) { return _mm_popcnt_u32(static_cast<unsigned>(_mm256_movemask_ps(m)) & ((1u << n) - 1)); }
+    static float hsum(reg x) {
+        __m128 y = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+        y = _mm_add_ps(y, _mm_movehl_ps(y, y));
+        return _mm_cvtss_f32(_mm_add_ss(y, _mm_movehdup_ps(y)));
+    }
+    static float hmin(reg x) {
+        __m128 y = _mm_min_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+        y = _mm_min_ps(y, _mm_movehl_ps(y, y));
+        return _mm_cvtss_f32(_mm_min_ss(y, _mm_movehdup_ps(y)));
+    }
+    static float hmax(reg x) {
+        __m128 y = _mm_max_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+        y = _mm_max_ps(y, _mm_movehl_ps(y, y));
+        return _mm_cvtss_f32(_mm_max_ss(y, _mm_movehdup_ps(y)));
+    }
+    static reg prefix(reg x) {
+        x = add(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+        x = add(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+        const __m256 low_total = _mm256_shuffle_ps(x, x, 0xFF);
+        return add(x, _mm256_permute2f128_ps(low_total, low_total, 0x08));
+    }
+    static reg shift_up(reg x) {
+        return _mm256_blend_ps(_mm256_permutevar8x32_ps(x, _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6)), zero(), 0x01);
+    }
+    static reg broadcast_last(reg x) { return _mm256_permutevar8x32_ps(x, _mm256_set1_epi32(7)); }
+};
+
+using Index = Vec<int32_t>;
+
+// Сума int32_t без розширення кожного регістра: молодші 16 біт (без знака) і старші (зі знаком)
+// накопичуються окремо в 32-бітних смугах. За SUM_BLOCK регістрів смуга не переповнюється
+// (2^15 доданків, менших за 2^16), тож лише суми блоку розширюються до int64_t.
+const size_t SUM_BLOCK = 32768;
+
+int64_t sum_i32_avx2(const int32_t* data, size_t size) {
+    using V = Index;
+    int64_t total = 0;
+    size_t i = 0;
+    while (i < size) {
+        const size_t end = size - i < SUM_BLOCK * V::lanes ? size : i + SUM_BLOCK * V::lanes;
+        V::reg low = V::zero(), high = V::zero();
+        for (; i + V::lanes <= end; i += V::lanes) {
+            const V::reg x = V::load(data + i);
+            low = V::add(low, V::low16(x));
+            high = V::add(high, V::high16(x));
+        }
+        if (i < end) {
+            const V::reg x = V::load_fill(data + i, end - i, 0);
+            low = V::add(low, V::low16(x));
+            high = V::add(high, V::high16(x));
+            i = end;
+        }
+        total += V::widen_sum(high) * 65536 + V::widen_sum(low);
+    }
+    return total;
+}
+
+// Чотири незалежні акумулятори ховають затримку додавання
+float sum_f32_avx2(const float* data, size_t size) {
+    using V = Vec<float>;
+    V::reg acc0 = V::zero(), acc1 = V::zero(), acc2 = V::zero(), acc3 = V::zero();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        acc0 = V::add(acc0, V::load(data + i));
+        acc1 = V::add(acc1, V::load(data + i + 8));
+        acc2 = V::add(acc2, V::load(data + i + 16));
+        acc3 = V::add(acc3, V::load(data + i + 24));
+    }
+    for (; i + 8 <= size; i += 8) {
+        acc0 = V::add(acc0, V::load(data + i));
+    }
+    if (i < size) {
+        acc1 = V::add(acc1, V::load_fill(data + i, size - i, 0.0f));
+    }
+    return V::hsum(V::add(V::add(acc0, acc1), V::add(acc2, acc3)));
+}
+
+template <typename T>
+T lowest() {
+    return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::min();
+}
+
+template <typename T>
+T highest() {
+    return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+}
+
+struct MinOp {
+    template <typename T> static T identity() { return highest<T>(); }
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::min(a, b); }
+    template <typename V> static typename V::mask better(typename V::reg a, typename V::reg b) { return V::lt(a, b); }
+    template <typename T> static bool wins(T a, T b) { return a < b; }
+    template <typename V, typename T> static T horizontal(typename V::reg x) { return V::hmin(x); }
+};
+
+struct MaxOp {
+    template <typename T> static T identity() { return lowest<T>(); }
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::max(a, b); }
+    template <typename V> static typename V::mask better(typename V::reg a, typename V::reg b) { return V::gt(a, b); }
+    template <typename T> static bool wins(T a, T b) { return a > b; }
+    template <typename V, typename T> static T horizontal(typename V::reg x) { return V::hmax(x); }
+};
+
+template <typename T, typename Op>
+T extremum(const T* data, size_t size) {
+    using V = Vec<T>;
+    using reg = typename V::reg;
+    reg acc0 = V::set1(Op::template identity<T>());
+    reg acc1 = acc0;
+    size_t i = 0;
+    for (; i + 2 * V::lanes <= size; i += 2 * V::lanes) {
+        acc0 = Op::template apply<V>(acc0, V::load(data + i));
+        acc1 = Op::template apply<V>(acc1, V::load(data + i + V::lanes));
+    }
+    for (; i + V::lanes <= size; i += V::lanes) {
+        acc0 = Op::template apply<V>(acc0, V::load(data + i));
+    }
+    if (i < size) {
+        acc1 = Op::template apply<V>(acc1, V::load_fill(data + i, size - i, Op::template identity<T>()));
+    }
+    return Op::template horizontal<V, T>(Op::template apply<V>(acc0, acc1));
+}
+
+template <typename T> T min_avx2(const T* data, size_t size) { return extremum<T, MinOp>(data, size); }
+template <typename T> T max_avx2(const T* data, size_t size) { return extremum<T, MaxOp>(data, size); }
+
+// Кожна смуга пам'ятає найкраще значення й індекс його першої появи (строге порівняння).
+// Потім із смуг, де значення дорівнює найкращому, береться найменший індекс. Індекси 32-бітні,
+// тож довгі масиви обробляються відрізками по ARG_SEGMENT елементів.
+template <typename T, typename Op>
+size_t arg_segment(const T* data, size_t size, T& best_value) {
+    using V = Vec<T>;
+    using reg = typename V::reg;
+    const T identity = Op::template identity<T>();
+    // Два незалежні набори (парні й непарні регістри), щоб розірвати ланцюжок порівняння й вибору
+    reg best0 = V::set1(identity), best1 = best0;
+    Index::reg best_index0 = Index::set1(INT32_MAX), best_index1 = best_index0;
+    Index::reg index = Index::lane_indices();
+    const Index::reg step = Index::set1(static_cast<int32_t>(V::lanes));
+    size_t i = 0;
+    for (; i + 2 * V::lanes <= size; i += 2 * V::lanes) {
+        const reg x0 = V::load(data + i);
+        const reg x1 = V::load(data + i + V::lanes);
+        const typename V::mask m0 = Op::template better<V>(x0, best0);
+        const typename V::mask m1 = Op::template better<V>(x1, best1);
+        best0 = V::select(m0, x0, best0);
+        best1 = V::select(m1, x1, best1);
+        best_index0 = V::select_index(m0, index, best_index0);
+        best_index1 = V::select_index(m1, Index::add(index, step), best_index1);
+        index = Index::add(index, Index::add(step, step));
+    }
+    for (; i < size; i += V::lanes) {
+        // Заповнювач — нейтральний елемент: він ніколи не строго кращий
+        const reg x = i + V::lanes <= size ? V::load(data + i) : V::load_fill(data + i, size - i, identity);
+        const typename V::mask m = Op::template better<V>(x, best0);
+        best0 = V::select(m, x, best0);
+        best_index0 = V::select_index(m, index, best_index0);
+        index = Index::add(index, step);
+    }
+    // У кожній смузі кожного набору — перша поява її найкращого значення, тож перша поява загального
+    // найкращого — найменший індекс серед смуг, де воно досягається
+    best_value = Op::template horizontal<V, T>(Op::template apply<V>(best0, best1));
+    const reg target = V::set1(best_value);
+    const Index::reg none = Index::set1(INT32_MAX);
+    const int32_t found = Index::hmin(Index::min(V::select_index(V::eq(best0, target), best_index0, none),
+                                                 V::select_index(V::eq(best1, target), best_index1, none)));
+    // Жодна смуга не оновилася: усі елементи дорівнюють нейтральному, перший із них — індекс 0
+    return found == INT32_MAX ? 0 : static_cast<size_t>(found);
+}
+
+template <typename T, typename Op>
+size_t arg_extremum(const T* data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    T best_value;
+    size_t best = arg_segment<T, Op>(data, size < ARG_SEGMENT ? size : ARG_SEGMENT, best_value);
+    for (size_t begin = ARG_SEGMENT; begin < size; begin += ARG_SEGMENT) {
+        const size_t length = size - begin < ARG_SEGMENT ? size - begin : ARG_SEGMENT;
+        T value;
+        const size_t index = arg_segment<T, Op>(data + begin, length, value);
+        if (Op::wins(value, best_value)) {
+            best_value = value;
+            best = begin + index;
+        }
+    }
+    return best;
+}
+
+template <typename T> size_t argmin_avx2(const T* data, size_t size) { return arg_extremum<T, MinOp>(data, size); }
+template <typename T> size_t argmax_avx2(const T* data, size_t size) { return arg_extremum<T, MaxOp>(data, size); }
+
+struct LessOp { template <typename V> static typename V::mask apply(typename V::reg x, typename V::reg v) { return V::lt(x, v); } };
+struct LessEqualOp { template <typename V> static typename V::mask apply(typename V::reg x, typename V::reg v) { return V::le(x, v); } };
+struct EqualOp { template <typename V> static typename V::mask apply(typename V::reg x, typename V::reg v) { return V::eq(x, v); } };
+struct NotEqualOp { template <typename V> static typename V::mask apply(typename V::reg x, typename V::reg v) { return V::ne(x, v); } };
+struct GreaterOp { template <typename V> static typename V::mask apply(typename V::reg x, typename V::reg v) { return V::gt(x, v); } };
+struct GreaterEqualOp { template <typename V> static typename V::mask apply(typename V::reg x, typename V::reg v) { return V::ge(x, v); } };
+
+template <typename T, typename Pred>
+size_t count_with(const T* data, size_t size, T value) {
+    using V = Vec<T>;
+    const typename V::reg v = V::set1(value);
+    size_t count0 = 0, count1 = 0;
+    size_t i = 0;
+    for (; i + 2 * V::lanes <= size; i += 2 * V::lanes) {
+        count0 += V::count(Pred::template apply<V>(V::load(data + i), v));
+        count1 += V::count(Pred::template apply<V>(V::load(data + i + V::lanes), v));
+    }
+    for (; i + V::lanes <= size; i += V::lanes) {
+        count0 += V::count(Pred::template apply<V>(V::load(data + i), v));
+    }
+    if (i < size) {
+        count1 += V::count_first(Pred::template apply<V>(V::load_fill(data + i, size - i, T()), v), size - i);
+    }
+    return count0 + count1;
+}
+
+template <typename T>
+size_t count_if_avx2(const T* data, size_t size, Compare compare, T value) {
+    switch (compare) {
+    case Compare::Less: return count_with<T, LessOp>(data, size, value);
+    case Compare::LessEqual: return count_with<T, LessEqualOp>(data, size, value);
+    case Compare::Equal: return count_with<T, EqualOp>(data, size, value);
+    case Compare::NotEqual: return count_with<T, NotEqualOp>(data, size, value);
+    case Compare::Greater: return count_with<T, GreaterOp>(data, size, value);
+    case Compare::GreaterEqual: return count_with<T, GreaterEqualOp>(data, size, value);
+    }
+    return 0;
+}
+
+// Префіксна сума регістра плюс перенесення з попередніх; перенесення — останній елемент,
+// розмножений на всі смуги. Регістр читається до запису, тож result може збігатися з data.
+template <typename T, bool Inclusive>
+void scan_avx2(const T* data, T* result, size_t size, T offset) {
+    using V = Vec<T>;
+    using reg = typename V::reg;
+    reg carry = V::set1(offset);
+    size_t i = 0;
+    for (; i + V::lanes <= size; i += V::lanes) {
+        const reg local = V::prefix(V::load(data + i));
+        V::store(result + i, V::add(carry, Inclusive ? local : V::shift_up(local)));
+        carry = V::add(carry, V::broadcast_last(local));
+    }
+    if (i < size) {
+        const reg local = V::prefix(V::load_fill(data + i, size - i, T()));
+        V::store_first(result + i, size - i, V::add(carry, Inclusive ? local : V::shift_up(local)));
+    }
+}
+
+template <typename T> void inclusive_scan_avx2(const T* data, T* result, size_t size, T offset) { scan_avx2<T, true>(data, result, size, offset); }
+template <typename T> void exclusive_scan_avx2(const T* data, T* result, size_t size, T offset) { scan_avx2<T, false>(data, result, size, offset); }
+
+}  // namespace
+
+const ReduceTable avx2_reduce = {
+    CpuTier::AVX2,
+    {
+        sum_i32_avx2,
+        min_avx2<int32_t>,
+        max_avx2<int32_t>,
+        argmin_avx2<int32_t>,
+        argmax_avx2<int32_t>,
+        count_if_avx2<int32_t>,
+        inclusive_scan_avx2<int32_t>,
+        exclusive_scan_avx2<int32_t>,
+    },
+    {
+        sum_f32_avx2,
+        min_avx2<float>,
+        max_avx2<float>,
+        argmin_avx2<float>,
+        argmax_avx2<float>,
+        count_if_avx2<float>,
+        inclusive_scan_avx2<float>,
+        exclusive_scan_avx2<float>,
+    },
+};
+
+}  // namespace simd
+
+#include "target_end.h"
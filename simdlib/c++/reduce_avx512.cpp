@@ -0,0 +1,360 @@
+﻿#include <immintrin.h>
+#include <cstdint>
+#include <limits>
+
+#include "reduce_internal.h"
+
+#include "target_avx512.h"
+
+// Згортки на 512-бітних регістрах. Залишок читається маскою із заповнювачем (нейтральним елементом
+// згортки), тож окремого скалярного циклу немає; горизонтальні згортки — перестановками в регістрах.
+namespace simd {
+
+namespace {
+
+template <typename T> struct Vec;
+
+template <>
+struct Vec<int32_t> {
+    using reg = __m512i;
+    using mask = __mmask16;
+    static const size_t lanes = 16;
+    static mask first(size_t n) { return static_cast<__mmask16>((1u << n) - 1); }
+    static reg load(const int32_t* p) { return _mm512_loadu_si512(p); }
+    static void store(int32_t* p, reg v) { _mm512_storeu_si512(p, v); }
+    static reg load_fill(const int32_t* p, size_t n, int32_t fill) { return _mm512_mask_loadu_epi32(_mm512_set1_epi32(fill), first(n), p); }
+    static void store_first(int32_t* p, size_t n, reg v) { _mm512_mask_storeu_epi32(p, first(n), v); }
+    static reg set1(int32_t x) { return _mm512_set1_epi32(x); }
+    static reg zero() { return _mm512_setzero_si512(); }
+    static reg lane_indices() { return _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); }
+    static reg add(reg a, reg b) { return _mm512_add_epi32(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_epi32(a, b); }
+    static mask lt(reg a, reg b) { return _mm512_cmp_epi32_mask(a, b, _MM_CMPINT_LT); }
+    static mask le(reg a, reg b) { return _mm512_cmp_epi32_mask(a, b, _MM_CMPINT_LE); }
+    static mask eq(reg a, reg b) { return _mm512_cmp_epi32_mask(a, b, _MM_CMPINT_EQ); }
+    static mask ne(reg a, reg b) { return _mm512_cmp_epi32_mask(a, b, _MM_CMPINT_NE); }
+    static mask gt(reg a, reg b) { return _mm512_cmp_epi32_mask(a, b, _MM_CMPINT_NLE); }
+    static mask ge(reg a, reg b) { return _mm512_cmp_epi32_mask(a, b, _MM_CMPINT_NLT); }
+    // Елементи a там, де маску встановлено, інакше b
+    static reg select(mask m, reg a, reg b) { return _mm512_mask_blend_epi32(m, b, a); }
+    static __m512i select_index(mask m, __m512i a, __m512i b) { return _mm512_mask_blend_epi32(m, b, a); }
+    static size_t count(mask m) { return _mm_popcnt_u32(_cvtmask16_u32(m)); }
+    static size_t count_first(mask m, size_t n) { return count(m & first(n)); }
+    static int32_t hmin(reg x) { return _mm512_reduce_min_epi32(x); }
+    static int32_t hmax(reg x) { return _mm512_reduce_max_epi32(x); }
+    // Частини для суми без переповнення (див. sum_i32_avx512) і сума смуг у int64_t
+    static reg low16(reg x) { return _mm512_and_si512(x, _mm512_set1_epi32(0xFFFF)); }
+    static reg high16(reg x) { return _mm512_srai_epi32(x, 16); }
+    static int64_t widen_sum(reg x) {
+        return _mm512_reduce_add_epi64(_mm512_add_epi64(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(x)),
+                                                        _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(x, 1))));
+    }
+    // Префіксна сума в регістрі: зсуви на 1, 2, 4, 8 смуг угору з нулями знизу
+    static reg prefix(reg x) {
+        const reg z = zero();
+        x = add(x, _mm512_alignr_epi32(x, z, 15));
+        x = add(x, _mm512_alignr_epi32(x, z, 14));
+        x = add(x, _mm512_alignr_epi32(x, z, 12));
+        return add(x, _mm512_alignr_epi32(x, z, 8));
+    }
+    static reg shift_up(reg x) { return _mm512_alignr_epi32(x, zero(), 15); }
+    static reg broadcast_last(reg x) { return _mm512_permutexvar_epi32(_mm512_set1_epi32(15), x); }
+};
+
+template <>
+struct Vec<float> {
+    using reg = __m512;
+    using mask = __mmask16;
+    static const size_t lanes = 16;
+    static mask first(size_t n) { return static_cast<__mmask16>((1u << n) - 1); }
+    static reg load(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, reg v) { _mm512_storeu_ps(p, v); }
+    static reg load_fill(const float* p, size_t n, float fill) { return _mm512_mask_loadu_ps(_mm512_set1_ps(fill), first(n), p); }
+    static void store_first(float* p, size_t n, reg v) { _mm512_mask_storeu_ps(p, first(n), v); }
+    static reg set1(float x) { return _mm512_set1_ps(x); }
+    static reg zero() { return _mm512_setzero_ps(); }
+    static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_ps(a, b); }
+    static mask lt(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static mask le(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+    static mask eq(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static mask ne(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ); }
+    static mask gt(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static mask ge(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+    static reg select(mask m, reg a, reg b) { return _mm512_mask_blend_ps(m, b, a); }
+    static __m512i select_index(mask m, __m512i a, __m512i b) { return _mm512_mask_blend_epi32(m, b, a); }
+    static size_t count(mask m) { return _mm_popcnt_u32(_cvtmask16_u32(m)); }
+    static size_t count_first(mask m, size_t n) { return count(m & first(n)); }
+    static float hsum(reg x) { return _mm512_reduce_add_ps(x); }
+    static float hmin(reg x) { return _mm512_reduce_min_ps(x); }
+    static float hmax(reg x) { return _mm512_reduce_max_ps(x); }
+    static reg prefix(reg x) {
+        const __m512i z = _mm512_setzero_si512();
+        x = add(x, _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), z, 15)));
+        x = add(x, _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), z, 14)));
+        x = add(x, _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), z, 12)));
+        return add(x, _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), z, 8)));
+    }
+    static reg shift_up(reg x) {
+        return _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), _mm512_setzero_si512(), 15));
+    }
+    static reg broadcast_last(reg x) { return _mm512_permutexvar_ps(_mm512_set1_epi32(15), x); }
+};
+
+using Index = Vec<int32_t>;
+
+// Сума int32_t без розширення кожного регістра: молодші 16 біт (без знака) і старші (зі знаком)
+// накопичуються окремо в 32-бітних смугах. За SUM_BLOCK регістрів смуга не переповнюється
+// (2^15 доданків, менших за 2^16), тож лише суми блоку розширюються до int64_t.
+const size_t SUM_BLOCK = 32768;
+
+int64_t sum_i32_avx512(const int32_t* data, size_t size) {
+    using V = Index;
+    int64_t total = 0;
+    size_t i = 0;
+    while (i < size) {
+        const size_t end = size - i < SUM_BLOCK * V::lanes ? size : i + SUM_BLOCK * V::lanes;
+        V::reg low = V::zero(), high = V::zero();
+        for (; i + V::lanes <= end; i += V::lanes) {
+            const V::reg x = V::load(data + i);
+            low = V::add(low, V::low16(x));
+            high = V::add(high, V::high16(x));
+        }
+        if (i < end) {
+            const V::reg x = V::load_fill(data + i, end - i, 0);
+            low = V::add(low, V::low16(x));
+            high = V::add(high, V::high16(x));
+            i = end;
+        }
+        total += V::widen_sum(high) * 65536 + V::widen_sum(low);
+    }
+    return total;
+}
+
+// Чотири незалежні акумулятори ховають затримку додавання
+float sum_f32_avx512(const float* data, size_t size) {
+    using V = Vec<float>;
+    V::reg acc0 = V::zero(), acc1 = V::zero(), acc2 = V::zero(), acc3 = V::zero();
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        acc0 = V::add(acc0, V::load(data + i));
+        acc1 = V::add(acc1, V::load(data + i + 16));
+        acc2 = V::add(acc2, V::load(data + i + 32));
+        acc3 = V::add(acc3, V::load(data + i + 48));
+    }
+    for (; i + 16 <= size; i += 16) {
+        acc0 = V::add(acc0, V::load(data + i));
+    }
+    if (i < size) {
+        acc1 = V::add(acc1, V::load_fill(data + i, size - i, 0.0f));
+    }
+    return V::hsum(V::add(V::add(acc0, acc1), V::add(acc2, acc3)));
+}
+
+template <typename T>
+T lowest() {
+    return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::min();
+}
+
+template <typename T>
+T highest() {
+    return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+}
+
+struct MinOp {
+    template <typename T> static T identity() { return highest<T>(); }
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::min(a, b); }
+    template <typename V> static typename V::mask better(typename V::reg a, typename V::reg b) { return V::lt(a, b); }
+    template <typename T> static bool wins(T a, T b) { return a < b; }
+    template <typename V, typename T> static T horizontal(typename V::reg x) { return V::hmin(x); }
+};
+
+struct MaxOp {
+    template <typename T> static T identity() { return lowest<T>(); }
+    template <typename V> static typename V::reg apply(typename V::reg a, typename V::reg b) { return V::max(a, b); }
+    template <typename V> static typename V::mask better(typename V::reg a, typename V::reg b) { return V::gt(a, b); }
+    template <typename T> static bool wins(T a, T b) { return a > b; }
+    template <typename V, typename T> static T horizontal(typename V::reg x) { return V::hmax(x); }
+};
+
+template <typename T, typename Op>
+T extremum(const T* data, size_t size) {
+    using V = Vec<T>;
+    using reg = typename V::reg;
+    reg acc0 = V::set1(Op::template identity<T>());
+    reg acc1 = acc0;
+    size_t i = 0;
+    for (; i + 2 * V::lanes <= size; i += 2 * V::lanes) {
+        acc0 = Op::template apply<V>(acc0, V::load(data + i));
+        acc1 = Op::template apply<V>(acc1, V::load(data + i + V::lanes));
+    }
+    for (; i + V::lanes <= size; i += V::lanes) {
+        acc0 = Op::template apply<V>(acc0, V::load(data + i));
+    }
+    if (i < size) {
+        acc1 = Op::template apply<V>(acc1, V::load_fill(data + i, size - i, Op::template identity<T>()));
+    }
+    return Op::template horizontal<V, T>(Op::template apply<V>(acc0, acc1));
+}
+
+template <typename T> T min_avx512(const T* data, size_t size) { return extremum<T, MinOp>(data, size); }
+template <typename T> T max_avx512(const T* data, size_t size) { return extremum<T, MaxOp>(data, size); }
+
+// Кожна смуга пам'ятає найкраще значення й індекс його першої появи (строге порівняння).
+// Потім із смуг, де значення дорівнює найкращому, береться найменший індекс. Індекси 32-бітні,
+// тож довгі масиви обробляються відрізками по ARG_SEGMENT елементів.
+template <typename T, typename Op>
+size_t arg_segment(const T* data, size_t size, T& best_value) {
+    using V = Vec<T>;
+    using reg = typename V::reg;
+    const T identity = Op::template identity<T>();
+    // Два незалежні набори (парні й непарні регістри), щоб розірвати ланцюжок порівняння й вибору
+    reg best0 = V::set1(identity), best1 = best0;
+    Index::reg best_index0 = Index::set1(INT32_MAX), best_index1 = best_index0;
+    Index::reg index = Index::lane_indices();
+    const Index::reg step = Index::set1(static_cast<int32_t>(V::lanes));
+    size_t i = 0;
+    for (; i + 2 * V::lanes <= size; i += 2 * V::lanes) {
+        const reg x0 = V::load(data + i);
+        const reg x1 = V::load(data + i + V::lanes);
+        const typename V::mask m0 = Op::template better<V>(x0, best0);
+        const typename V::mask m1 = Op::template better<V>(x1, best1);
+        best0 = V::select(m0, x0, best0);
+        best1 = V::select(m1, x1, best1);
+        best_index0 = V::select_index(m0, index, best_index0);
+        best_index1 = V::select_index(m1, Index::add(index, step), best_index1);
+        index = Index::add(index, Index::add(step, step));
+    }
+    for (; i < size; i += V::lanes) {
+        // Заповнювач — нейтральний елемент: він ніколи не строго кращий
+        const reg x = i + V::lanes <= size ? V::load(data + i) : V::load_fill(data + i, size - i, identity);
+        const typename V::mask m = Op::template better<V>(x, best0);
+        best0 = V::select(m, x, best0);
+        best_index0 = V::select_index(m, index, best_index0);
+        index = Index::add(index, step);
+    }
+    // У кожній смузі кожного набору — перша поява її найкращого значення, тож перша поява загального
+    // найкращого — найменший індекс серед смуг, де воно досягається
+    best_value = Op::template horizontal<V, T>(Op::template apply<V>(best0, best1));
+    const reg target = V::set1(best_value);
+    const Index::reg none = Index::set1(INT32_MAX);
+    const int32_t found = Index::hmin(Index::min(V::select_index(V::eq(best0, target), best_index0, none),
+                                                 V::select_index(V::eq(best1, target), best_index1, none)));
+    // Жодна смуга не оновилася: усі елементи дорівнюють нейтральному, перший із них — індекс 0
+    return found == INT32_MAX ? 0 : static_cast<size_t>(found);
+}
+
+template <typename T, typename Op>
+size_t arg_extremum(const T* data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    T best_value;
+    size_t best = arg_segment<T, Op>(data, size < ARG_SEGMENT ? size : ARG_SEGMENT, best_value);
+    for (size_t begin = ARG_SEGMENT; begin < size; begin += ARG_SEGMENT) {
+        const size_t length = size - begin < ARG_SEGMENT ? size - begin : ARG_SEGMENT;
+        T value;
+        const size_t index = arg_segment<T, Op>(data + begin, length, value);
+        if (Op::wins(value, best_value)) {
+            best_value = value;
+            best = begin + index;
+        }
+    }
+    return best;
+}
+
+template <typename T> size_t argmin_avx512(const T* data, size_t size) { return arg_extremum<T, MinOp>(data, size); }
+template <typename T> size_t argmax_avx512(const T* data, size_t size) { return arg_extremum<T, MaxOp>(data, size); }
+
+struct LessOp { template <typename V> static typename V::mask apply(typename V::reg x, typename V::reg v) { return V::lt(x, v); } };
+struct LessEqualOp { template <typename V> static typename V::mask apply(typename V::reg x, typename V::reg v) { return V::le(x, v); } };
+struct EqualOp { template <typename V> static typename V::mask apply(typename V::reg x, typename V::reg v) { return V::eq(x, v); } };
+struct NotEqualOp { template <typename V> static typename V::mask apply(typename V::reg x, typename V::reg v) { return V::ne(x, v); } };
+struct GreaterOp { template <typename V> static typename V::mask apply(typename V::reg x, typename V::reg v) { return V::gt(x, v); } };
+struct GreaterEqualOp { template <typename V> static typename V::mask apply(typename V::reg x, typename V::reg v) { return V::ge(x, v); } };
+
+template <typename T, typename Pred>
+size_t count_with(const T* data, size_t size, T value) {
+    using V = Vec<T>;
+    const typename V::reg v = V::set1(value);
+    size_t count0 = 0, count1 = 0;
+    size_t i = 0;
+    for (; i + 2 * V::lanes <= size; i += 2 * V::lanes) {
+        count0 += V::count(Pred::template apply<V>(V::load(data + i), v));
+        count1 += V::count(Pred::template apply<V>(V::load(data + i + V::lanes), v));
+    }
+    for (; i + V::lanes <= size; i += V::lanes) {
+        count0 += V::count(Pred::template apply<V>(V::load(data + i), v));
+    }
+    if (i < size) {
+        count1 += V::count_first(Pred::template apply<V>(V::load_fill(data + i, size - i, T()), v), size - i);
+    }
+    return count0 + count1;
+}
+
+template <typename T>
+size_t count_if_avx512(const T* data, size_t size, Compare compare, T value) {
+    switch (compare) {
+    case Compare::Less: return count_with<T, LessOp>(data, size, value);
+    case Compare::LessEqual: return count_with<T, LessEqualOp>(data, size, value);
+    case Compare::Equal: return count_with<T, EqualOp>(data, size, value);
+    case Compare::NotEqual: return count_with<T, NotEqualOp>(data, size, value);
+    case Compare::Greater: return count_with<T, GreaterOp>(data, size, value);
+    case Compare::GreaterEqual: return count_with<T, GreaterEqualOp>(data, size, value);
+    }
+    return 0;
+}
+
+// Префіксна сума регістра плюс перенесення з попередніх; перенесення — останній елемент,
+// розмножений на всі смуги. Регістр читається до запису, тож result може збігатися з data.
+template <typename T, bool Inclusive>
+void scan_avx512(const T* data, T* result, size_t size, T offset) {
+    using V = Vec<T>;
+    using reg = typename V::reg;
+    reg carry = V::set1(offset);
+    size_t i = 0;
+    for (; i + V::lanes <= size; i += V::lanes) {
+        const reg local = V::prefix(V::load(data + i));
+        V::store(result + i, V::add(carry, Inclusive ? local : V::shift_up(local)));
+        carry = V::add(carry, V::broadcast_last(local));
+    }
+    if (i < size) {
+        const reg local = V::prefix(V::load_fill(data + i, size - i, T()));
+        V::store_first(result + i, size - i, V::add(carry, Inclusive ? local : V::shift_up(local)));
+    }
+}
+
+template <typename T> void inclusive_scan_avx512(const T* data, T* result, size_t size, T offset) { scan_avx512<T, true>(data, result, size, offset); }
+template <typename T> void exclusive_scan_avx512(const T* data, T* result, size_t size, T offset) { scan_avx512<T, false>(data, result, size, offset); }
+
+}  // namespace
+
+const ReduceTable avx512_reduce = {
+    CpuTier::AVX512,
+    {
+        sum_i32_avx512,
+        min_avx512<int32_t>,
+        max_avx512<int32_t>,
+        argmin_avx512<int32_t>,
+        argmax_avx512<int32_t>,
+        count_if_avx512<int32_t>,
+        inclusive_scan_avx512<int32_t>,
+        exclusive_scan_avx512<int32_t>,
+    },
+    {
+        sum_f32_avx512,
+        min_avx512<float>,
+        max_avx512<float>,
+        argmin_avx512<float>,
+        argmax_avx512<float>,
+        count_if_avx512<float>,
+        inclusive_scan_avx512<float>,
+        exclusive_scan_avx512<float>,
+    },
+};
+
+}  // namespace simd
+
+#include "target_end.h"
@@ -0,0 +1,15 @@
+﻿#pragma once
+#include "reduce.h"
+
+// Таблиці, визначені в reduce_<рівень>.cpp. Використовуються лише диспетчером.
+namespace simd {
+
+extern const ReduceTable scalar_reduce;
+extern const ReduceTable sse42_reduce;
+extern const ReduceTable avx2_reduce;
+extern const ReduceTable avx512_reduce;
+
+// Довжина відрізка, на які argmin/argmax ділять масив, щоб індекси вміщалися в 32-бітні смуги
+const size_t ARG_SEGMENT = size_t(1) << 30;
+
+}  // namespace simd
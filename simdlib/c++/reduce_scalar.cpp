@@ -0,0 +1,138 @@
+﻿#include <cstdint>
+#include <limits>
+
+#include "reduce_internal.h"
+
+// Еталонні реалізації без ручної векторизації
+namespace simd {
+
+namespace {
+
+int64_t sum_i32_scalar(const int32_t* data, size_t size) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+float sum_f32_scalar(const float* data, size_t size) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < size; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+template <typename T>
+T min_scalar(const T* data, size_t size) {
+    T best = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+    for (size_t i = 0; i < size; ++i) {
+        best = data[i] < best ? data[i] : best;
+    }
+    return best;
+}
+
+template <typename T>
+T max_scalar(const T* data, size_t size) {
+    T best = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::min();
+    for (size_t i = 0; i < size; ++i) {
+        best = data[i] > best ? data[i] : best;
+    }
+    return best;
+}
+
+template <typename T>
+size_t argmin_scalar(const T* data, size_t size) {
+    size_t best = size;
+    for (size_t i = 0; i < size; ++i) {
+        if (best == size || data[i] < data[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+template <typename T>
+size_t argmax_scalar(const T* data, size_t size) {
+    size_t best = size;
+    for (size_t i = 0; i < size; ++i) {
+        if (best == size || data[i] > data[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+template <typename T>
+size_t count_if_scalar(const T* data, size_t size, Compare compare, T value) {
+    size_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        const T x = data[i];
+        switch (compare) {
+        case Compare::Less: count += x < value; break;
+        case Compare::LessEqual: count += x <= value; break;
+        case Compare::Equal: count += x == value; break;
+        case Compare::NotEqual: count += x != value; break;
+        case Compare::Greater: count += x > value; break;
+        case Compare::GreaterEqual: count += x >= value; break;
+        }
+    }
+    return count;
+}
+
+// Цілі додаються в uint32_t: переповнення за модулем 2^32 без невизначеної поведінки
+int32_t add_wrapping(int32_t a, int32_t b) {
+    return static_cast<int32_t>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+}
+
+float add_wrapping(float a, float b) {
+    return a + b;
+}
+
+template <typename T>
+void inclusive_scan_scalar(const T* data, T* result, size_t size, T offset) {
+    T running = offset;
+    for (size_t i = 0; i < size; ++i) {
+        running = add_wrapping(running, data[i]);
+        result[i] = running;
+    }
+}
+
+template <typename T>
+void exclusive_scan_scalar(const T* data, T* result, size_t size, T offset) {
+    T running = offset;
+    for (size_t i = 0; i < size; ++i) {
+        const T x = data[i];
+        result[i] = running;
+        running = add_wrapping(running, x);
+    }
+}
+
+}  // namespace
+
+const ReduceTable scalar_reduce = {
+    CpuTier::Scalar,
+    {
+        sum_i32_scalar,
+        min_scalar<int32_t>,
+        max_scalar<int32_t>,
+        argmin_scalar<int32_t>,
+        argmax_scalar<int32_t>,
+        count_if_scalar<int32_t>,
+        inclusive_scan_scalar<int32_t>,
+        exclusive_scan_scalar<int32_t>,
+    },
+    {
+        sum_f32_scalar,
+        min_scalar<float>,
+        max_scalar<float>,
+        argmin_scalar<float>,
+        argmax_scalar<float>,
+        count_if_scalar<float>,
+        inclusive_scan_scalar<float>,
+        exclusive_scan_scalar<float>,
+    },
+};
+
+}  // namespace simd
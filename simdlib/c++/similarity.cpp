@@ -0,0 +1,205 @@
+﻿#include "similarity.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "generic_dot.h"
+#include "kernels.h"
+#include "parallel.h"
+#include "similarity_internal.h"
+
+namespace simd {
+
+namespace {
+
+// Скільки байтів матриці обробляється за один прохід по блоках запитів: плитка рядків лишається
+// в L2, поки її множать на всі запити, тож матриця читається з пам'яті один раз на виклик
+const size_t TILE_BYTES = 128u << 10;
+
+// Оцінка однієї пари: скалярний добуток або квадрат евклідової відстані
+template <bool L2>
+float pair_score(const float* x, const float* q, size_t dim) {
+    return generic_dot(dim, [&](size_t d) {
+        const float diff = x[d] - q[d];
+        return L2 ? diff * diff : x[d] * q[d];
+    });
+}
+
+// Мікроядро без явного SIMD для рівнів scalar і sse4.2
+void similarity_block_generic(const float* matrix, size_t rows, size_t ld, size_t dim,
+                              const float* queries, size_t query_count, size_t query_ld,
+                              bool l2, float* scores, float* norms) {
+    for (size_t r = 0; r < rows; ++r) {
+        const float* x = matrix + r * ld;
+        for (size_t j = 0; j < query_count; ++j) {
+            const float* q = queries + j * query_ld;
+            scores[r * SIMILARITY_QUERIES + j] = l2 ? pair_score<true>(x, q, dim) : pair_score<false>(x, q, dim);
+        }
+        if (norms) {
+            norms[r] = pair_score<false>(x, x, dim);
+        }
+    }
+}
+
+SimilarityKernelFn select_kernel() {
+    switch (active_tier()) {
+    case CpuTier::AVX512: return similarity_block_avx512;
+    case CpuTier::AVX2: return similarity_block_avx2;
+    default: return similarity_block_generic;
+    }
+}
+
+// Кандидат у купі: key більший — краще (для L2 це відстань зі знаком мінус)
+struct Candidate {
+    float key;
+    size_t row;
+};
+
+// a краще за b; рівні ключі впорядковуються за номером рядка
+bool better(const Candidate& a, const Candidate& b) {
+    return a.key > b.key || (a.key == b.key && a.row < b.row);
+}
+
+// k найкращих кандидатів: купа з найгіршим на вершині, тож більшість рядків відкидається одним порівнянням
+class TopK {
+public:
+    explicit TopK(size_t k) : k_(k) { heap_.reserve(k); }
+
+    void push(Candidate candidate) {
+        if (heap_.size() < k_) {
+            heap_.push_back(candidate);
+            std::push_heap(heap_.begin(), heap_.end(), better);
+        }
+        else if (better(candidate, heap_.front())) {
+            std::pop_heap(heap_.begin(), heap_.end(), better);
+            heap_.back() = candidate;
+            std::push_heap(heap_.begin(), heap_.end(), better);
+        }
+    }
+
+    const std::vector<Candidate>& candidates() const { return heap_; }
+
+    // Кандидати від найкращого; купа після цього не придатна для push
+    std::vector<Candidate>& sorted() {
+        std::sort_heap(heap_.begin(), heap_.end(), better);
+        return heap_;
+    }
+
+private:
+    size_t k_;
+    std::vector<Candidate> heap_;
+};
+
+struct SearchParams {
+    const float* matrix;
+    size_t ld;
+    size_t dim;
+    const float* queries;
+    size_t query_count;
+    size_t query_ld;
+    Metric metric;
+    const float* query_norms;  // Квадрати норм запитів, лише для Cosine
+    SimilarityKernelFn kernel;
+};
+
+// Норми приходять у квадратах. Знаменник рахується в double: квадрат float у double точний,
+// тож для рядка, що збігається із запитом, sqrt(n * n) == n і оцінка дорівнює рівно 1
+float cosine(float dot, float row_norm2, float query_norm2) {
+    const double denominator = std::sqrt(static_cast<double>(row_norm2) * query_norm2);
+    return denominator > 0.0 ? static_cast<float>(dot / denominator) : 0.0f;
+}
+
+// Рядки [first, last) проти всіх запитів; heaps — по одній купі на запит
+void search_rows(const SearchParams& p, size_t first, size_t last, std::vector<TopK>& heaps) {
+    const size_t tile_rows = std::min(last - first, std::max<size_t>(16, TILE_BYTES / (p.dim * sizeof(float) + 1)));
+    std::vector<float> scores(tile_rows * SIMILARITY_QUERIES);
+    std::vector<float> norms(p.metric == Metric::Cosine ? tile_rows : 0);
+    const bool l2 = p.metric == Metric::L2;
+
+    for (size_t tile = first; tile < last; tile += tile_rows) {
+        const size_t rows = std::min(tile_rows, last - tile);
+        const float* matrix = p.matrix + tile * p.ld;
+        for (size_t q0 = 0; q0 < p.query_count; q0 += SIMILARITY_QUERIES) {
+            const size_t queries = std::min(SIMILARITY_QUERIES, p.query_count - q0);
+            // Норми рядків плитки однакові для всіх блоків запитів, тож рахуються лише в першому
+            float* row_norms = p.metric == Metric::Cosine && q0 == 0 ? norms.data() : nullptr;
+            p.kernel(matrix, rows, p.ld, p.dim, p.queries + q0 * p.query_ld, queries, p.query_ld, l2,
+                     scores.data(), row_norms);
+            for (size_t j = 0; j < queries; ++j) {
+                TopK& heap = heaps[q0 + j];
+                for (size_t r = 0; r < rows; ++r) {
+                    float key = scores[r * SIMILARITY_QUERIES + j];
+                    if (p.metric == Metric::L2) {
+                        key = -key;
+                    }
+                    else if (p.metric == Metric::Cosine) {
+                        key = cosine(key, norms[r], p.query_norms[q0 + j]);
+                    }
+                    heap.push({ key, tile + r });
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+size_t top_k(const float* matrix, size_t rows, size_t dim, size_t ld,
+             const float* queries, size_t query_count, size_t query_ld,
+             size_t k, Metric metric, Neighbor* neighbors, ThreadPool& pool) {
+    const size_t found = std::min(k, rows);
+    if (found == 0 || query_count == 0) {
+        return found;
+    }
+
+    // Норми запитів рахує те саме мікроядро, що й норми рядків (запити подаються йому як матриця),
+    // тож рядок, рівний запиту, дає побітово ті самі скалярний добуток і норми
+    const SimilarityKernelFn kernel = select_kernel();
+    std::vector<float> query_norms;
+    if (metric == Metric::Cosine) {
+        query_norms.resize(query_count);
+        std::vector<float> unused_scores(query_count * SIMILARITY_QUERIES);
+        kernel(queries, query_count, query_ld, dim, queries, 1, query_ld, false, unused_scores.data(), query_norms.data());
+    }
+    const SearchParams params = { matrix, ld, dim, queries, query_count, query_ld, metric, query_norms.data(), kernel };
+
+    // Статичний поділ рядків між потоками; малі матриці рахуються в потоці, що викликав
+    const size_t parts = rows * dim * sizeof(float) < PARALLEL_MIN_BYTES ? 1 : std::min(pool.size(), rows);
+    std::vector<std::vector<TopK>> heaps(parts, std::vector<TopK>(query_count, TopK(found)));
+    const auto run_part = [&](size_t index, size_t count) {
+        if (index < parts) {
+            const size_t per_part = (rows + count - 1) / count;
+            const size_t first = std::min(rows, index * per_part);
+            search_rows(params, first, std::min(rows, first + per_part), heaps[index]);
+        }
+    };
+    if (parts == 1) {
+        run_part(0, 1);
+    }
+    else {
+        pool.run_on_all([&](size_t index, size_t) { run_part(index, parts); });
+    }
+
+    // Злиття куп потоків: повний порядок better робить результат незалежним від поділу
+    for (size_t j = 0; j < query_count; ++j) {
+        TopK merged(found);
+        for (size_t part = 0; part < parts; ++part) {
+            for (const Candidate& candidate : heaps[part][j].candidates()) {
+                merged.push(candidate);
+            }
+        }
+        const std::vector<Candidate>& best = merged.sorted();
+        for (size_t i = 0; i < found; ++i) {
+            neighbors[j * k + i] = { best[i].row, metric == Metric::L2 ? -best[i].key : best[i].key };
+        }
+    }
+    return found;
+}
+
+size_t top_k(const float* matrix, size_t rows, size_t dim, const float* queries, size_t query_count,
+             size_t k, Metric metric, Neighbor* neighbors) {
+    return top_k(matrix, rows, dim, dim, queries, query_count, dim, k, metric, neighbors);
+}
+
+}  // namespace simd
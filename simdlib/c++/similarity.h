@@ -0,0 +1,38 @@
+﻿#pragma once
+#include <cstddef>
+
+#include "thread_pool.h"
+
+namespace simd {
+
+// Міра близькості рядка матриці x до запиту q
+enum class Metric {
+    Dot,     // q · x, більше — ближче
+    Cosine,  // q · x / (|q| |x|), більше — ближче; з нульовим вектором — 0
+    L2,      // |q - x|^2 (квадрат евклідової відстані), менше — ближче
+};
+
+// Знайдений рядок і його оцінка в мірі пошуку
+struct Neighbor {
+    size_t row;
+    float score;
+};
+
+// Точний пошук k найближчих рядків (brute force) для query_count запитів. matrix — rows x dim
+// у порядку рядків із кроком ld, queries — query_count x dim із кроком query_ld.
+// Результат запиту q — neighbors[q * k], ..., neighbors[q * k + min(k, rows) - 1] від найближчого;
+// рівні оцінки впорядковуються за номером рядка, тож результат не залежить від кількості потоків.
+// Повертає min(k, rows). Для рядків або запитів з NaN порядок не визначений.
+//
+// Оцінки рахує регістрове мікроядро: кілька рядків матриці множаться одразу на кілька запитів,
+// тож кожне завантаження рядка використовується кількома запитами. Матриця ділиться на діапазони
+// рядків між потоками pool; кожен потік тримає власні купи з k кандидатів на запит, які потім зливаються.
+size_t top_k(const float* matrix, size_t rows, size_t dim, size_t ld,
+             const float* queries, size_t query_count, size_t query_ld,
+             size_t k, Metric metric, Neighbor* neighbors, ThreadPool& pool = default_pool());
+
+// Те саме для щільно упакованих матриці й запитів (ld = query_ld = dim)
+size_t top_k(const float* matrix, size_t rows, size_t dim, const float* queries, size_t query_count,
+             size_t k, Metric metric, Neighbor* neighbors);
+
+}  // namespace simd
@@ -0,0 +1,147 @@
+﻿#include <immintrin.h>
+#include <cstddef>
+
+#include "similarity_internal.h"
+
+#include "target_avx2.h"
+
+namespace simd {
+
+namespace {
+
+const size_t ROWS = 2;
+
+// Горизонтальні суми чотирьох регістрів одразу: [sum a, sum b, sum c, sum d]
+__m128 reduce4(__m256 a, __m256 b, __m256 c, __m256 d) {
+    const __m256 ab = _mm256_add_ps(_mm256_unpacklo_ps(a, b), _mm256_unpackhi_ps(a, b));
+    const __m256 cd = _mm256_add_ps(_mm256_unpacklo_ps(c, d), _mm256_unpackhi_ps(c, d));
+    const __m256 abcd = _mm256_add_ps(_mm256_shuffle_ps(ab, cd, 0x44), _mm256_shuffle_ps(ab, cd, 0xEE));
+    return _mm_add_ps(_mm256_castps256_ps128(abcd), _mm256_extractf128_ps(abcd, 1));
+}
+
+// Один крок по виміру: рядки xv проти запитів qv
+template <bool L2, bool Norms, size_t Q>
+void accumulate(const __m256 (&xv)[ROWS], const __m256 (&qv)[Q], __m256 (&acc)[ROWS][Q], __m256 (&norm)[ROWS]) {
+    SIMDLIB_UNROLL
+    for (size_t i = 0; i < ROWS; ++i) {
+        if (Norms) {
+            norm[i] = _mm256_fmadd_ps(xv[i], xv[i], norm[i]);
+        }
+        SIMDLIB_UNROLL
+        for (size_t j = 0; j < Q; ++j) {
+            if (L2) {
+                const __m256 diff = _mm256_sub_ps(xv[i], qv[j]);
+                acc[i][j] = _mm256_fmadd_ps(diff, diff, acc[i][j]);
+            }
+            else {
+                acc[i][j] = _mm256_fmadd_ps(xv[i], qv[j], acc[i][j]);
+            }
+        }
+    }
+}
+
+// Регістровий блок 2 рядки x Q запитів (Q <= 4): до 8 акумуляторів, 2 під норми рядків, 6 регістрів
+// під завантаження (усього 16 YMM). Неповний блок рядків повторює останній рядок; зайві оцінки
+// не записуються. Залишок виміру, коротший за регістр, читається vmaskmov.
+template <bool L2, bool Norms, size_t Q>
+void score_block(const float* matrix, size_t rows, size_t ld, size_t dim,
+                 const float* queries, size_t query_ld, float* scores, float* norms) {
+    const float* q[Q];
+    SIMDLIB_UNROLL
+    for (size_t j = 0; j < Q; ++j) {
+        q[j] = queries + j * query_ld;
+    }
+    const size_t full = dim - dim % 8;
+    const __m256i tail = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(dim % 8)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+    for (size_t r = 0; r < rows; r += ROWS) {
+        const float* x[ROWS];
+        SIMDLIB_UNROLL
+        for (size_t i = 0; i < ROWS; ++i) {
+            x[i] = matrix + (r + i < rows ? r + i : rows - 1) * ld;
+        }
+        __m256 acc[ROWS][Q];
+        __m256 norm[ROWS];
+        SIMDLIB_UNROLL
+        for (size_t i = 0; i < ROWS; ++i) {
+            norm[i] = _mm256_setzero_ps();
+            SIMDLIB_UNROLL
+            for (size_t j = 0; j < Q; ++j) {
+                acc[i][j] = _mm256_setzero_ps();
+            }
+        }
+
+        __m256 xv[ROWS];
+        __m256 qv[Q];
+        for (size_t d = 0; d < full; d += 8) {
+            SIMDLIB_UNROLL
+            for (size_t i = 0; i < ROWS; ++i) {
+                xv[i] = _mm256_loadu_ps(x[i] + d);
+            }
+            SIMDLIB_UNROLL
+            for (size_t j = 0; j < Q; ++j) {
+                qv[j] = _mm256_loadu_ps(q[j] + d);
+            }
+            accumulate<L2, Norms, Q>(xv, qv, acc, norm);
+        }
+        if (full < dim) {
+            // Масковані елементи читаються як нулі й не змінюють ні добутків, ні відстаней
+            SIMDLIB_UNROLL
+            for (size_t i = 0; i < ROWS; ++i) {
+                xv[i] = _mm256_maskload_ps(x[i] + full, tail);
+            }
+            SIMDLIB_UNROLL
+            for (size_t j = 0; j < Q; ++j) {
+                qv[j] = _mm256_maskload_ps(q[j] + full, tail);
+            }
+            accumulate<L2, Norms, Q>(xv, qv, acc, norm);
+        }
+
+        const size_t valid = rows - r < ROWS ? rows - r : ROWS;
+        SIMDLIB_UNROLL
+        for (size_t i = 0; i < ROWS; ++i) {
+            if (i < valid) {
+                _mm_storeu_ps(scores + (r + i) * SIMILARITY_QUERIES, reduce4(acc[i][0], acc[i][Q > 1 ? 1 : 0], acc[i][Q > 2 ? 2 : 0], acc[i][Q > 3 ? 3 : 0]));
+            }
+        }
+        if (Norms) {
+            alignas(16) float sums[4];
+            _mm_store_ps(sums, reduce4(norm[0], norm[1], norm[0], norm[1]));
+            for (size_t i = 0; i < valid; ++i) {
+                norms[r + i] = sums[i];
+            }
+        }
+    }
+}
+
+// Блок із query_count < 4 запитів рахується ядром меншої ширини, а не повторенням запитів
+template <bool L2, bool Norms>
+void score_queries(const float* matrix, size_t rows, size_t ld, size_t dim,
+                   const float* queries, size_t query_count, size_t query_ld, float* scores, float* norms) {
+    switch (query_count) {
+    case 1: score_block<L2, Norms, 1>(matrix, rows, ld, dim, queries, query_ld, scores, norms); break;
+    case 2: score_block<L2, Norms, 2>(matrix, rows, ld, dim, queries, query_ld, scores, norms); break;
+    case 3: score_block<L2, Norms, 3>(matrix, rows, ld, dim, queries, query_ld, scores, norms); break;
+    default: score_block<L2, Norms, 4>(matrix, rows, ld, dim, queries, query_ld, scores, norms); break;
+    }
+}
+
+}  // namespace
+
+void similarity_block_avx2(const float* matrix, size_t rows, size_t ld, size_t dim,
+                           const float* queries, size_t query_count, size_t query_ld,
+                           bool l2, float* scores, float* norms) {
+    if (l2) {
+        score_queries<true, false>(matrix, rows, ld, dim, queries, query_count, query_ld, scores, nullptr);
+    }
+    else if (norms) {
+        score_queries<false, true>(matrix, rows, ld, dim, queries, query_count, query_ld, scores, norms);
+    }
+    else {
+        score_queries<false, false>(matrix, rows, ld, dim, queries, query_count, query_ld, scores, nullptr);
+    }
+}
+
+}  // namespace simd
+
+#include "target_end.h"
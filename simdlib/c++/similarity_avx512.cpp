@@ -0,0 +1,128 @@
+﻿#include <immintrin.h>
+#include <cstddef>
+
+#include "similarity_internal.h"
+
+#include "target_avx512.h"
+
+namespace simd {
+
+namespace {
+
+const size_t ROWS = 4;
+
+// Горизонтальні суми чотирьох регістрів одразу: [sum a, sum b, sum c, sum d]
+__m128 reduce4(__m512 a, __m512 b, __m512 c, __m512 d) {
+    const __m512 ab = _mm512_add_ps(_mm512_unpacklo_ps(a, b), _mm512_unpackhi_ps(a, b));
+    const __m512 cd = _mm512_add_ps(_mm512_unpacklo_ps(c, d), _mm512_unpackhi_ps(c, d));
+    const __m512 abcd = _mm512_add_ps(_mm512_shuffle_ps(ab, cd, 0x44), _mm512_shuffle_ps(ab, cd, 0xEE));
+    const __m256 half = _mm256_add_ps(_mm512_castps512_ps256(abcd), _mm512_extractf32x8_ps(abcd, 1));
+    return _mm_add_ps(_mm256_castps256_ps128(half), _mm256_extractf128_ps(half, 1));
+}
+
+// Регістровий блок 4 рядки x Q запитів (Q <= 4): до 16 акумуляторів і ще 4 під норми рядків. На кожному
+// кроці завантажуються 4 регістри рядків і Q регістрів запитів на 4 * Q FMA (для L2 — ще стільки ж віднімань).
+// Неповний блок рядків повторює останній рядок; зайві оцінки не записуються.
+template <bool L2, bool Norms, size_t Q>
+void score_block(const float* matrix, size_t rows, size_t ld, size_t dim,
+                 const float* queries, size_t query_ld, float* scores, float* norms) {
+    const float* q[Q];
+    SIMDLIB_UNROLL
+    for (size_t j = 0; j < Q; ++j) {
+        q[j] = queries + j * query_ld;
+    }
+    const size_t full = dim - dim % 16;
+    const __mmask16 tail = static_cast<__mmask16>((1u << (dim % 16)) - 1);
+
+    for (size_t r = 0; r < rows; r += ROWS) {
+        const float* x[ROWS];
+        SIMDLIB_UNROLL
+        for (size_t i = 0; i < ROWS; ++i) {
+            x[i] = matrix + (r + i < rows ? r + i : rows - 1) * ld;
+        }
+        __m512 acc[ROWS][Q];
+        __m512 norm[ROWS];
+        SIMDLIB_UNROLL
+        for (size_t i = 0; i < ROWS; ++i) {
+            norm[i] = _mm512_setzero_ps();
+            SIMDLIB_UNROLL
+            for (size_t j = 0; j < Q; ++j) {
+                acc[i][j] = _mm512_setzero_ps();
+            }
+        }
+
+        for (size_t d = 0; d < dim; d += 16) {
+            // Останній неповний крок читає маскою: нулі не змінюють ні добутків, ні відстаней
+            const __mmask16 m = d < full ? static_cast<__mmask16>(0xFFFF) : tail;
+            __m512 xv[ROWS];
+            SIMDLIB_UNROLL
+            for (size_t i = 0; i < ROWS; ++i) {
+                xv[i] = _mm512_maskz_loadu_ps(m, x[i] + d);
+                if (Norms) {
+                    norm[i] = _mm512_fmadd_ps(xv[i], xv[i], norm[i]);
+                }
+            }
+            SIMDLIB_UNROLL
+            for (size_t j = 0; j < Q; ++j) {
+                const __m512 qv = _mm512_maskz_loadu_ps(m, q[j] + d);
+                SIMDLIB_UNROLL
+                for (size_t i = 0; i < ROWS; ++i) {
+                    if (L2) {
+                        const __m512 diff = _mm512_sub_ps(xv[i], qv);
+                        acc[i][j] = _mm512_fmadd_ps(diff, diff, acc[i][j]);
+                    }
+                    else {
+                        acc[i][j] = _mm512_fmadd_ps(xv[i], qv, acc[i][j]);
+                    }
+                }
+            }
+        }
+
+        const size_t valid = rows - r < ROWS ? rows - r : ROWS;
+        SIMDLIB_UNROLL
+        for (size_t i = 0; i < ROWS; ++i) {
+            if (i < valid) {
+                _mm_storeu_ps(scores + (r + i) * SIMILARITY_QUERIES, reduce4(acc[i][0], acc[i][Q > 1 ? 1 : 0], acc[i][Q > 2 ? 2 : 0], acc[i][Q > 3 ? 3 : 0]));
+            }
+        }
+        if (Norms) {
+            alignas(16) float sums[ROWS];
+            _mm_store_ps(sums, reduce4(norm[0], norm[1], norm[2], norm[3]));
+            for (size_t i = 0; i < valid; ++i) {
+                norms[r + i] = sums[i];
+            }
+        }
+    }
+}
+
+// Блок із query_count < 4 запитів рахується ядром меншої ширини, а не повторенням запитів
+template <bool L2, bool Norms>
+void score_queries(const float* matrix, size_t rows, size_t ld, size_t dim,
+                   const float* queries, size_t query_count, size_t query_ld, float* scores, float* norms) {
+    switch (query_count) {
+    case 1: score_block<L2, Norms, 1>(matrix, rows, ld, dim, queries, query_ld, scores, norms); break;
+    case 2: score_block<L2, Norms, 2>(matrix, rows, ld, dim, queries, query_ld, scores, norms); break;
+    case 3: score_block<L2, Norms, 3>(matrix, rows, ld, dim, queries, query_ld, scores, norms); break;
+    default: score_block<L2, Norms, 4>(matrix, rows, ld, dim, queries, query_ld, scores, norms); break;
+    }
+}
+
+}  // namespace
+
+void similarity_block_avx512(const float* matrix, size_t rows, size_t ld, size_t dim,
+                             const float* queries, size_t query_count, size_t query_ld,
+                             bool l2, float* scores, float* norms) {
+    if (l2) {
+        score_queries<true, false>(matrix, rows, ld, dim, queries, query_count, query_ld, scores, nullptr);
+    }
+    else if (norms) {
+        score_queries<false, true>(matrix, rows, ld, dim, queries, query_count, query_ld, scores, norms);
+    }
+    else {
+        score_queries<false, false>(matrix, rows, ld, dim, queries, query_count, query_ld, scores, nullptr);
+    }
+}
+
+}  // namespace simd
+
+#include "target_end.h"
@@ -0,0 +1,25 @@
+﻿#pragma once
+#include <cstddef>
+
+#include "gemm_internal.h"  // SIMDLIB_UNROLL
+
+namespace simd {
+
+// Скільки запитів рахує мікроядро за один прохід по рядках
+const size_t SIMILARITY_QUERIES = 4;
+
+// Мікроядро пошуку: для рядків r < rows матриці й запитів q < query_count (query_count <= SIMILARITY_QUERIES)
+// пише в scores[r * SIMILARITY_QUERIES + q] скалярний добуток (l2 == false) або квадрат відстані (l2 == true),
+// а в norms[r], якщо norms не nullptr, — квадрат норми рядка.
+using SimilarityKernelFn = void (*)(const float* matrix, size_t rows, size_t ld, size_t dim,
+                                    const float* queries, size_t query_count, size_t query_ld,
+                                    bool l2, float* scores, float* norms);
+
+void similarity_block_avx2(const float* matrix, size_t rows, size_t ld, size_t dim,
+                           const float* queries, size_t query_count, size_t query_ld,
+                           bool l2, float* scores, float* norms);
+void similarity_block_avx512(const float* matrix, size_t rows, size_t ld, size_t dim,
+                             const float* queries, size_t query_count, size_t query_ld,
+                             bool l2, float* scores, float* norms);
+
+}  // namespace simd
@@ -0,0 +1,91 @@
+﻿#include "small_gemm.h"
+
+#include <algorithm>
+
+#include "kernels.h"
+#include "parallel.h"
+#include "small_gemm_internal.h"
+
+namespace simd {
+
+namespace {
+
+// Ядра без явного SIMD для рівнів scalar і sse4.2: порядок i-k-j із рядком C у тимчасовому масиві,
+// внутрішній цикл за j компілятор векторизує сам
+template <size_t M, size_t N, size_t K>
+void small_gemm_aos_generic(size_t count, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                            float* C, size_t stride_c) {
+    for (size_t m = 0; m < count; ++m, A += stride_a, B += stride_b, C += stride_c) {
+        for (size_t i = 0; i < M; ++i) {
+            float row[N] = {};
+            for (size_t k = 0; k < K; ++k) {
+                const float a = A[i * K + k];
+                for (size_t j = 0; j < N; ++j) {
+                    row[j] += a * B[k * N + j];
+                }
+            }
+            std::copy(row, row + N, C + i * N);
+        }
+    }
+}
+
+template <size_t M, size_t N, size_t K>
+void small_gemm_interleaved_generic(size_t count, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                                    float* C, size_t stride_c) {
+    constexpr size_t L = SMALL_GEMM_LANES;
+    for (size_t g = 0; g < count; ++g, A += stride_a, B += stride_b, C += stride_c) {
+        for (size_t i = 0; i < M; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                float acc[L] = {};
+                for (size_t k = 0; k < K; ++k) {
+                    for (size_t l = 0; l < L; ++l) {
+                        acc[l] += A[(i * K + k) * L + l] * B[(k * N + j) * L + l];
+                    }
+                }
+                std::copy(acc, acc + L, C + (i * N + j) * L);
+            }
+        }
+    }
+}
+
+template <size_t M, size_t N, size_t K>
+SmallGemmFn select_small_gemm(BatchLayout layout) {
+    const bool aos = layout == BatchLayout::AoS;
+    switch (active_tier()) {
+    case CpuTier::AVX512: return aos ? small_gemm_aos_avx512<M, N, K> : small_gemm_interleaved_avx512<M, N, K>;
+    case CpuTier::AVX2: return aos ? small_gemm_aos_avx2<M, N, K> : small_gemm_interleaved_avx2<M, N, K>;
+    default: return aos ? small_gemm_aos_generic<M, N, K> : small_gemm_interleaved_generic<M, N, K>;
+    }
+}
+
+}  // namespace
+
+namespace detail {
+
+template <size_t M, size_t N, size_t K>
+void small_gemm_batch(size_t batch, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                      float* C, size_t stride_c, BatchLayout layout, ThreadPool& pool) {
+    const SmallGemmFn fn = select_small_gemm<M, N, K>(layout);
+    // Одиниця роботи — матриця (AoS) або група (Interleaved)
+    const size_t lanes = layout == BatchLayout::AoS ? 1 : SMALL_GEMM_LANES;
+    const size_t units = (batch + lanes - 1) / lanes;
+    const size_t bytes = batch * (M * K + K * N + M * N) * sizeof(float);
+    if (bytes < PARALLEL_MIN_BYTES || pool.size() == 1 || units < 2) {
+        fn(units, A, stride_a, B, stride_b, C, stride_c);
+        return;
+    }
+    // Кілька частин на потік, щоб вирівняти навантаження, коли потоки стартують не одночасно
+    const size_t grain = std::max<size_t>(1, units / (4 * pool.size()));
+    pool.parallel_for(units, grain, [&](size_t first, size_t last) {
+        fn(last - first, A + first * stride_a, stride_a, B + first * stride_b, stride_b, C + first * stride_c, stride_c);
+    });
+}
+
+#define SIMDLIB_INSTANTIATE_SMALL_GEMM(M, N, K)                                                              \
+    template void small_gemm_batch<M, N, K>(size_t, const float*, size_t, const float*, size_t, float*, size_t, \
+                                            BatchLayout, ThreadPool&);
+SIMDLIB_SMALL_GEMM_SHAPES(SIMDLIB_INSTANTIATE_SMALL_GEMM)
+
+}  // namespace detail
+
+}  // namespace simd
@@ -0,0 +1,73 @@
+﻿#pragma once
+#include <cstddef>
+
+#include "thread_pool.h"
+
+namespace simd {
+
+// Пакетне множення малих матриць float: C[b] = A[b] * B[b] для b < batch, A[b] — M x K, B[b] — K x N,
+// C[b] — M x N, усі в порядку рядків. Форма задається параметрами шаблону, тож ядро кожної форми
+// збирається окремо: цикли за рядками й стовпцями розгорнуті, блок C лежить в акумуляторах-регістрах
+// протягом усього циклу за K, і немає ні пакування, ні перевірок розміру, як у sgemm.
+
+// Кількість матриць у групі розкладки Interleaved (однакова на всіх рівнях, тож дані не залежать від процесора)
+const size_t SMALL_GEMM_LANES = 16;
+
+enum class BatchLayout {
+    // Кожна матриця суцільна; матриця b починається з елемента b * stride відповідного масиву.
+    // Крок 0 — одна матриця для всього пакета (наприклад, спільні ваги B).
+    AoS,
+
+    // Матриці згруповані по SMALL_GEMM_LANES: елемент (i, j) матриці g * LANES + l лежить за індексом
+    // g * stride + (i * cols + j) * LANES + l. Кожен регістр містить той самий елемент 16 матриць,
+    // тож добуток — лише вертикальні FMA без трансляцій; вигідно для найменших форм. Остання група
+    // читається й записується повністю, навіть якщо batch не кратний LANES.
+    Interleaved,
+};
+
+// Форми (M, N, K), для яких зібрано ядра: усі поєднання 4, 8, 16 і 32, а також
+// SIMDLIB_SMALL_GEMM_EXTRA_SHAPES. Ядра рівнів працюють з будь-якими M, N, K (неповні регістри — маски),
+// тож іншу форму можна додати під час збірки, не змінюючи цей файл; прапорець задається для всіх
+// файлів бібліотеки й програми, а форми в ньому не повинні повторювати наведені тут:
+//   -D'SIMDLIB_SMALL_GEMM_EXTRA_SHAPES(F)=F(6, 6, 6) F(12, 12, 12)'
+#ifndef SIMDLIB_SMALL_GEMM_EXTRA_SHAPES
+#define SIMDLIB_SMALL_GEMM_EXTRA_SHAPES(F)
+#endif
+#define SIMDLIB_SMALL_GEMM_K(F, M, N) F(M, N, 4) F(M, N, 8) F(M, N, 16) F(M, N, 32)
+#define SIMDLIB_SMALL_GEMM_N(F, M) \
+    SIMDLIB_SMALL_GEMM_K(F, M, 4) SIMDLIB_SMALL_GEMM_K(F, M, 8) SIMDLIB_SMALL_GEMM_K(F, M, 16) SIMDLIB_SMALL_GEMM_K(F, M, 32)
+#define SIMDLIB_SMALL_GEMM_SHAPES(F)                                                                        \
+    SIMDLIB_SMALL_GEMM_N(F, 4) SIMDLIB_SMALL_GEMM_N(F, 8) SIMDLIB_SMALL_GEMM_N(F, 16) SIMDLIB_SMALL_GEMM_N(F, 32) \
+    SIMDLIB_SMALL_GEMM_EXTRA_SHAPES(F)
+
+// Чи є форма в SIMDLIB_SMALL_GEMM_SHAPES
+#define SIMDLIB_SMALL_GEMM_SHAPE_MATCHES(M_, N_, K_) || (m == (M_) && n == (N_) && k == (K_))
+constexpr bool small_gemm_shape_compiled(size_t m, size_t n, size_t k) {
+    return false SIMDLIB_SMALL_GEMM_SHAPES(SIMDLIB_SMALL_GEMM_SHAPE_MATCHES);
+}
+#undef SIMDLIB_SMALL_GEMM_SHAPE_MATCHES
+
+namespace detail {
+
+// Явно інстанційована в small_gemm.cpp для кожної форми SIMDLIB_SMALL_GEMM_SHAPES
+template <size_t M, size_t N, size_t K>
+void small_gemm_batch(size_t batch, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                      float* C, size_t stride_c, BatchLayout layout, ThreadPool& pool);
+
+}  // namespace detail
+
+// Рахує пакет; stride_a, stride_b, stride_c — кроки між матрицями (AoS) або групами (Interleaved) в елементах,
+// щільна розкладка — M * K, K * N, M * N (для Interleaved — помножені на SMALL_GEMM_LANES).
+// Пакет, у якого всі матриці разом займають від PARALLEL_MIN_BYTES, ділиться між потоками pool.
+// Форма, якої немає в SIMDLIB_SMALL_GEMM_SHAPES, не компілюється.
+template <size_t M, size_t N, size_t K>
+void small_gemm_batch(size_t batch, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                      float* C, size_t stride_c, BatchLayout layout = BatchLayout::AoS,
+                      ThreadPool& pool = default_pool()) {
+    static_assert(small_gemm_shape_compiled(M, N, K),
+                  "small_gemm_batch: no kernel for this shape; add it to SIMDLIB_SMALL_GEMM_SHAPES "
+                  "or SIMDLIB_SMALL_GEMM_EXTRA_SHAPES");
+    detail::small_gemm_batch<M, N, K>(batch, A, stride_a, B, stride_b, C, stride_c, layout, pool);
+}
+
+}  // namespace simd
@@ -0,0 +1,172 @@
+﻿#include <immintrin.h>
+#include <algorithm>
+#include <cstddef>
+
+#include "small_gemm_internal.h"
+
+#include "target_avx2.h"
+
+namespace simd {
+
+namespace {
+
+// Маска перших N % 8 елементів для останнього неповного регістра рядка
+template <size_t N>
+__m256i tail_mask() {
+    constexpr int r = static_cast<int>(N % 8);
+    return _mm256_setr_epi32(0 < r ? -1 : 0, 1 < r ? -1 : 0, 2 < r ? -1 : 0, 3 < r ? -1 : 0,
+                             4 < r ? -1 : 0, 5 < r ? -1 : 0, 6 < r ? -1 : 0, 7 < r ? -1 : 0);
+}
+
+// Регістр v рядка з N елементів
+template <size_t N>
+__m256 load_part(const float* row, size_t v) {
+    return v < N / 8 ? _mm256_loadu_ps(row + 8 * v) : _mm256_maskload_ps(row + 8 * v, tail_mask<N>());
+}
+
+template <size_t N>
+void store_part(float* row, size_t v, __m256 x) {
+    if (v < N / 8) {
+        _mm256_storeu_ps(row + 8 * v, x);
+    }
+    else {
+        _mm256_maskstore_ps(row + 8 * v, tail_mask<N>(), x);
+    }
+}
+
+// MB рядків C однієї матриці: a і c вказують на перший рядок блоку. На кожному кроці k рядок B
+// завантажується в NV регістрів один раз і множиться на трансльовані a[i][k] всіх рядків блоку.
+template <size_t MB, size_t N, size_t K>
+void aos_block(const float* a, const float* b, float* c) {
+    constexpr size_t NV = (N + 7) / 8;
+    __m256 acc[MB][NV];
+    SIMDLIB_UNROLL_ALL
+    for (size_t i = 0; i < MB; ++i) {
+        SIMDLIB_UNROLL_ALL
+        for (size_t v = 0; v < NV; ++v) {
+            acc[i][v] = _mm256_setzero_ps();
+        }
+    }
+    for (size_t k = 0; k < K; ++k) {
+        __m256 bv[NV];
+        SIMDLIB_UNROLL_ALL
+        for (size_t v = 0; v < NV; ++v) {
+            bv[v] = load_part<N>(b + k * N, v);
+        }
+        SIMDLIB_UNROLL_ALL
+        for (size_t i = 0; i < MB; ++i) {
+            const __m256 ai = _mm256_broadcast_ss(a + i * K + k);
+            SIMDLIB_UNROLL_ALL
+            for (size_t v = 0; v < NV; ++v) {
+                acc[i][v] = _mm256_fmadd_ps(ai, bv[v], acc[i][v]);
+            }
+        }
+    }
+    SIMDLIB_UNROLL_ALL
+    for (size_t i = 0; i < MB; ++i) {
+        SIMDLIB_UNROLL_ALL
+        for (size_t v = 0; v < NV; ++v) {
+            store_part<N>(c + i * N, v, acc[i][v]);
+        }
+    }
+}
+
+// Блок MI x JB елементів C групи: кожен елемент — два регістри (16 матриць), a вказує на A(i0, 0),
+// b — на B(0, j0), c — на C(i0, j0). Добуток — вертикальні FMA: a(i, k) і b(k, j) завантажуються один раз на k.
+template <size_t MI, size_t JB, size_t N, size_t K>
+void interleaved_block(const float* a, const float* b, float* c) {
+    constexpr size_t L = SMALL_GEMM_LANES;
+    __m256 acc[MI][JB][2];
+    SIMDLIB_UNROLL_ALL
+    for (size_t i = 0; i < MI; ++i) {
+        SIMDLIB_UNROLL_ALL
+        for (size_t j = 0; j < JB; ++j) {
+            acc[i][j][0] = _mm256_setzero_ps();
+            acc[i][j][1] = _mm256_setzero_ps();
+        }
+    }
+    for (size_t k = 0; k < K; ++k) {
+        __m256 av[MI][2];
+        SIMDLIB_UNROLL_ALL
+        for (size_t i = 0; i < MI; ++i) {
+            av[i][0] = _mm256_loadu_ps(a + (i * K + k) * L);
+            av[i][1] = _mm256_loadu_ps(a + (i * K + k) * L + 8);
+        }
+        SIMDLIB_UNROLL_ALL
+        for (size_t j = 0; j < JB; ++j) {
+            SIMDLIB_UNROLL_ALL
+            for (size_t h = 0; h < 2; ++h) {
+                const __m256 bv = _mm256_loadu_ps(b + (k * N + j) * L + 8 * h);
+                SIMDLIB_UNROLL_ALL
+                for (size_t i = 0; i < MI; ++i) {
+                    acc[i][j][h] = _mm256_fmadd_ps(av[i][h], bv, acc[i][j][h]);
+                }
+            }
+        }
+    }
+    SIMDLIB_UNROLL_ALL
+    for (size_t i = 0; i < MI; ++i) {
+        SIMDLIB_UNROLL_ALL
+        for (size_t j = 0; j < JB; ++j) {
+            _mm256_storeu_ps(c + (i * N + j) * L, acc[i][j][0]);
+            _mm256_storeu_ps(c + (i * N + j) * L + 8, acc[i][j][1]);
+        }
+    }
+}
+
+// MI рядків C групи блоками по JB стовпців і неповним останнім блоком
+template <size_t MI, size_t JB, size_t N, size_t K>
+void interleaved_rows(const float* a, const float* b, float* c) {
+    constexpr size_t L = SMALL_GEMM_LANES;
+    constexpr size_t NF = N / JB * JB;
+    for (size_t j = 0; j < NF; j += JB) {
+        interleaved_block<MI, JB, N, K>(a, b + j * L, c + j * L);
+    }
+    if constexpr (NF < N) {
+        interleaved_block<MI, N - NF, N, K>(a, b + NF * L, c + NF * L);
+    }
+}
+
+}  // namespace
+
+// 16 регістрів: NV регістрів рядка B, трансляція a[i][k] і акумулятори на решту
+template <size_t M, size_t N, size_t K>
+void small_gemm_aos_avx2(size_t count, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                         float* C, size_t stride_c) {
+    constexpr size_t NV = (N + 7) / 8;
+    constexpr size_t MB = small_gemm_row_block(M, NV, 15 - std::min<size_t>(NV, 14));
+    constexpr size_t MF = M / MB * MB;
+    for (size_t m = 0; m < count; ++m, A += stride_a, B += stride_b, C += stride_c) {
+        for (size_t i = 0; i < MF; i += MB) {
+            aos_block<MB, N, K>(A + i * K, B, C + i * N);
+        }
+        if constexpr (MF < M) {
+            aos_block<M - MF, N, K>(A + MF * K, B, C + MF * N);
+        }
+    }
+}
+
+// Блок 2 x 2 елементи: 8 акумуляторів, 4 регістри A і регістр B
+template <size_t M, size_t N, size_t K>
+void small_gemm_interleaved_avx2(size_t count, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                                 float* C, size_t stride_c) {
+    constexpr size_t L = SMALL_GEMM_LANES;
+    constexpr size_t MI = std::min<size_t>(2, M);
+    constexpr size_t JB = std::min<size_t>(2, N);
+    constexpr size_t MF = M / MI * MI;
+    for (size_t g = 0; g < count; ++g, A += stride_a, B += stride_b, C += stride_c) {
+        for (size_t i = 0; i < MF; i += MI) {
+            interleaved_rows<MI, JB, N, K>(A + i * K * L, B, C + i * N * L);
+        }
+        if constexpr (MF < M) {
+            interleaved_rows<M - MF, JB, N, K>(A + MF * K * L, B, C + MF * N * L);
+        }
+    }
+}
+
+#define SIMDLIB_INSTANTIATE_SMALL_GEMM_AVX2(M, N, K) SIMDLIB_INSTANTIATE_SMALL_GEMM_TIER(M, N, K, avx2)
+SIMDLIB_SMALL_GEMM_SHAPES(SIMDLIB_INSTANTIATE_SMALL_GEMM_AVX2)
+
+}  // namespace simd
+
+#include "target_end.h"
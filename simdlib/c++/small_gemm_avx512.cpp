@@ -0,0 +1,146 @@
+﻿#include <immintrin.h>
+#include <algorithm>
+#include <cstddef>
+
+#include "small_gemm_internal.h"
+
+#include "target_avx512.h"
+
+namespace simd {
+
+namespace {
+
+// Маска елементів регістра v рядка з N елементів: повна для всіх регістрів, крім неповного останнього
+template <size_t N>
+constexpr __mmask16 part_mask(size_t v) {
+    return v < N / 16 ? static_cast<__mmask16>(0xFFFF) : static_cast<__mmask16>((1u << (N % 16)) - 1);
+}
+
+// MB рядків C однієї матриці: a і c вказують на перший рядок блоку; рядок B — NV регістрів
+template <size_t MB, size_t N, size_t K>
+void aos_block(const float* a, const float* b, float* c) {
+    constexpr size_t NV = (N + 15) / 16;
+    __m512 acc[MB][NV];
+    SIMDLIB_UNROLL_ALL
+    for (size_t i = 0; i < MB; ++i) {
+        SIMDLIB_UNROLL_ALL
+        for (size_t v = 0; v < NV; ++v) {
+            acc[i][v] = _mm512_setzero_ps();
+        }
+    }
+    for (size_t k = 0; k < K; ++k) {
+        __m512 bv[NV];
+        SIMDLIB_UNROLL_ALL
+        for (size_t v = 0; v < NV; ++v) {
+            bv[v] = _mm512_maskz_loadu_ps(part_mask<N>(v), b + k * N + 16 * v);
+        }
+        SIMDLIB_UNROLL_ALL
+        for (size_t i = 0; i < MB; ++i) {
+            const __m512 ai = _mm512_set1_ps(a[i * K + k]);
+            SIMDLIB_UNROLL_ALL
+            for (size_t v = 0; v < NV; ++v) {
+                acc[i][v] = _mm512_fmadd_ps(ai, bv[v], acc[i][v]);
+            }
+        }
+    }
+    SIMDLIB_UNROLL_ALL
+    for (size_t i = 0; i < MB; ++i) {
+        SIMDLIB_UNROLL_ALL
+        for (size_t v = 0; v < NV; ++v) {
+            _mm512_mask_storeu_ps(c + i * N + 16 * v, part_mask<N>(v), acc[i][v]);
+        }
+    }
+}
+
+// Блок MI x JB елементів C групи, один регістр на елемент (16 матриць): a вказує на A(i0, 0),
+// b — на B(0, j0), c — на C(i0, j0)
+template <size_t MI, size_t JB, size_t N, size_t K>
+void interleaved_block(const float* a, const float* b, float* c) {
+    constexpr size_t L = SMALL_GEMM_LANES;
+    __m512 acc[MI][JB];
+    SIMDLIB_UNROLL_ALL
+    for (size_t i = 0; i < MI; ++i) {
+        SIMDLIB_UNROLL_ALL
+        for (size_t j = 0; j < JB; ++j) {
+            acc[i][j] = _mm512_setzero_ps();
+        }
+    }
+    for (size_t k = 0; k < K; ++k) {
+        __m512 av[MI];
+        SIMDLIB_UNROLL_ALL
+        for (size_t i = 0; i < MI; ++i) {
+            av[i] = _mm512_loadu_ps(a + (i * K + k) * L);
+        }
+        SIMDLIB_UNROLL_ALL
+        for (size_t j = 0; j < JB; ++j) {
+            const __m512 bv = _mm512_loadu_ps(b + (k * N + j) * L);
+            SIMDLIB_UNROLL_ALL
+            for (size_t i = 0; i < MI; ++i) {
+                acc[i][j] = _mm512_fmadd_ps(av[i], bv, acc[i][j]);
+            }
+        }
+    }
+    SIMDLIB_UNROLL_ALL
+    for (size_t i = 0; i < MI; ++i) {
+        SIMDLIB_UNROLL_ALL
+        for (size_t j = 0; j < JB; ++j) {
+            _mm512_storeu_ps(c + (i * N + j) * L, acc[i][j]);
+        }
+    }
+}
+
+template <size_t MI, size_t JB, size_t N, size_t K>
+void interleaved_rows(const float* a, const float* b, float* c) {
+    constexpr size_t L = SMALL_GEMM_LANES;
+    constexpr size_t NF = N / JB * JB;
+    for (size_t j = 0; j < NF; j += JB) {
+        interleaved_block<MI, JB, N, K>(a, b + j * L, c + j * L);
+    }
+    if constexpr (NF < N) {
+        interleaved_block<MI, N - NF, N, K>(a, b + NF * L, c + NF * L);
+    }
+}
+
+}  // namespace
+
+// 32 регістри: NV регістрів рядка B, трансляція a[i][k] і акумулятори на решту
+template <size_t M, size_t N, size_t K>
+void small_gemm_aos_avx512(size_t count, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                           float* C, size_t stride_c) {
+    constexpr size_t NV = (N + 15) / 16;
+    constexpr size_t MB = small_gemm_row_block(M, NV, 31 - std::min<size_t>(NV, 30));
+    constexpr size_t MF = M / MB * MB;
+    for (size_t m = 0; m < count; ++m, A += stride_a, B += stride_b, C += stride_c) {
+        for (size_t i = 0; i < MF; i += MB) {
+            aos_block<MB, N, K>(A + i * K, B, C + i * N);
+        }
+        if constexpr (MF < M) {
+            aos_block<M - MF, N, K>(A + MF * K, B, C + MF * N);
+        }
+    }
+}
+
+// Блок 4 x 6 елементів: 24 акумулятори, 4 регістри A і регістр B
+template <size_t M, size_t N, size_t K>
+void small_gemm_interleaved_avx512(size_t count, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                                   float* C, size_t stride_c) {
+    constexpr size_t L = SMALL_GEMM_LANES;
+    constexpr size_t MI = std::min<size_t>(4, M);
+    constexpr size_t JB = std::min<size_t>(6, N);
+    constexpr size_t MF = M / MI * MI;
+    for (size_t g = 0; g < count; ++g, A += stride_a, B += stride_b, C += stride_c) {
+        for (size_t i = 0; i < MF; i += MI) {
+            interleaved_rows<MI, JB, N, K>(A + i * K * L, B, C + i * N * L);
+        }
+        if constexpr (MF < M) {
+            interleaved_rows<M - MF, JB, N, K>(A + MF * K * L, B, C + MF * N * L);
+        }
+    }
+}
+
+#define SIMDLIB_INSTANTIATE_SMALL_GEMM_AVX512(M, N, K) SIMDLIB_INSTANTIATE_SMALL_GEMM_TIER(M, N, K, avx512)
+SIMDLIB_SMALL_GEMM_SHAPES(SIMDLIB_INSTANTIATE_SMALL_GEMM_AVX512)
+
+}  // namespace simd
+
+#include "target_end.h"
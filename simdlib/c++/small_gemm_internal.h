@@ -0,0 +1,47 @@
+﻿#pragma once
+#include <cstddef>
+
+#include "small_gemm.h"
+
+// Повне розгортання циклів за рядками й регістрами блоку (до 32 ітерацій), щоб кожен акумулятор
+// мав сталий індекс і жив у регістрі. Цикл за K не розгортається: він і так довгий, а код ядра зростав би в K разів.
+#if defined(__GNUC__)
+#define SIMDLIB_UNROLL_ALL _Pragma("GCC unroll 32")
+#else
+#define SIMDLIB_UNROLL_ALL
+#endif
+
+// Ядра small_gemm_<рівень>.cpp. Використовуються лише диспетчером.
+namespace simd {
+
+// Скільки рядків C рахувати одним блоком, якщо на рядок припадає nv регістрів, а під акумулятори
+// лишається budget регістрів: блоки однакового розміру, наскільки дозволяє M
+constexpr size_t small_gemm_row_block(size_t M, size_t nv, size_t budget) {
+    const size_t most = nv < budget ? budget / nv : 1;
+    const size_t blocks = (M + most - 1) / most;
+    return (M + blocks - 1) / blocks;
+}
+
+// Рахує count матриць (AoS) або груп по SMALL_GEMM_LANES матриць (Interleaved), починаючи з A, B, C
+using SmallGemmFn = void (*)(size_t count, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                             float* C, size_t stride_c);
+
+template <size_t M, size_t N, size_t K>
+void small_gemm_aos_avx2(size_t count, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                         float* C, size_t stride_c);
+template <size_t M, size_t N, size_t K>
+void small_gemm_interleaved_avx2(size_t count, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                                 float* C, size_t stride_c);
+template <size_t M, size_t N, size_t K>
+void small_gemm_aos_avx512(size_t count, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                           float* C, size_t stride_c);
+template <size_t M, size_t N, size_t K>
+void small_gemm_interleaved_avx512(size_t count, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                                   float* C, size_t stride_c);
+
+// Явні інстанціювання ядер рівня tier для всіх форм SIMDLIB_SMALL_GEMM_SHAPES
+#define SIMDLIB_INSTANTIATE_SMALL_GEMM_TIER(M, N, K, tier)                                                   \
+    template void small_gemm_aos_##tier<M, N, K>(size_t, const float*, size_t, const float*, size_t, float*, size_t); \
+    template void small_gemm_interleaved_##tier<M, N, K>(size_t, const float*, size_t, const float*, size_t, float*, size_t);
+
+}  // namespace simd
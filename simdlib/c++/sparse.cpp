@@ -0,0 +1,175 @@
+﻿#include "sparse.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "kernels.h"
+#include "parallel.h"
+#include "sparse_internal.h"
+
+namespace simd {
+
+namespace {
+
+// Ядра без явного SIMD для рівнів scalar і sse4.2 (gather з'являється лише в AVX2)
+void spmv_csr_generic(const CsrMatrix& A, const float* x, float* y, size_t first, size_t last) {
+    for (size_t r = first; r < last; ++r) {
+        float sum = 0.0f;
+        for (size_t i = A.row_ptr[r]; i < A.row_ptr[r + 1]; ++i) {
+            sum += A.values[i] * x[A.col_idx[i]];
+        }
+        y[r] = sum;
+    }
+}
+
+void spmv_sell_generic(const SellMatrix& A, const float* x, float* y, size_t first, size_t last) {
+    for (size_t s = first; s < last; ++s) {
+        const size_t base = A.slice_ptr[s];
+        const uint32_t* len = A.row_len.data() + s * SELL_SLICE;
+        for (size_t r = 0; r < SELL_SLICE && s * SELL_SLICE + r < A.rows; ++r) {
+            float sum = 0.0f;
+            for (size_t j = 0; j < len[r]; ++j) {
+                const size_t i = base + j * SELL_SLICE + r;
+                sum += A.values[i] * x[A.col_idx[i]];
+            }
+            y[A.row_order[s * SELL_SLICE + r]] = sum;
+        }
+    }
+}
+
+CsrKernelFn csr_kernel() {
+    switch (active_tier()) {
+    case CpuTier::AVX512: return spmv_csr_avx512;
+    case CpuTier::AVX2: return spmv_csr_avx2;
+    default: return spmv_csr_generic;
+    }
+}
+
+SellKernelFn sell_kernel() {
+    switch (active_tier()) {
+    case CpuTier::AVX512: return spmv_sell_avx512;
+    case CpuTier::AVX2: return spmv_sell_avx2;
+    default: return spmv_sell_generic;
+    }
+}
+
+// Межа частини index із parts: перша одиниця u (рядок або зріз), з якої робота ptr[u] + u * unit_cost
+// досягає частки index / parts усієї роботи. Одиниця коштує свої ненульові плюс unit_cost
+// (запис y, згортка суми), тож порожні рядки теж розподіляються.
+size_t part_boundary(const std::vector<size_t>& ptr, size_t unit_cost, size_t index, size_t parts) {
+    const size_t units = ptr.size() - 1;
+    const size_t target = (ptr[units] + units * unit_cost) * index / parts;
+    size_t lo = 0, hi = units;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (ptr[mid] + mid * unit_cost < target) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Викликає kernel(first, last) для частин, збалансованих за ненульовими
+template <typename Kernel>
+void run_balanced(const std::vector<size_t>& ptr, size_t unit_cost, size_t bytes, ThreadPool& pool, const Kernel& kernel) {
+    const size_t units = ptr.size() - 1;
+    if (bytes < PARALLEL_MIN_BYTES || pool.size() == 1 || units < 2) {
+        kernel(0, units);
+        return;
+    }
+    pool.run_on_all([&](size_t index, size_t count) {
+        const size_t first = part_boundary(ptr, unit_cost, index, count);
+        const size_t last = part_boundary(ptr, unit_cost, index + 1, count);
+        if (first < last) {
+            kernel(first, last);
+        }
+    });
+}
+
+}  // namespace
+
+CsrMatrix csr_from_dense(const float* dense, size_t rows, size_t cols, size_t ld) {
+    CsrMatrix csr;
+    csr.rows = rows;
+    csr.cols = cols;
+    csr.row_ptr.reserve(rows + 1);
+    csr.row_ptr.push_back(0);
+    for (size_t r = 0; r < rows; ++r) {
+        const float* row = dense + r * ld;
+        for (size_t c = 0; c < cols; ++c) {
+            if (row[c] != 0.0f) {
+                csr.col_idx.push_back(static_cast<uint32_t>(c));
+                csr.values.push_back(row[c]);
+            }
+        }
+        csr.row_ptr.push_back(csr.values.size());
+    }
+    return csr;
+}
+
+SellMatrix sell_from_csr(const CsrMatrix& csr, size_t sigma) {
+    SellMatrix sell;
+    sell.rows = csr.rows;
+    sell.cols = csr.cols;
+    sell.sigma = sigma <= 1 ? 1 : (sigma + SELL_SLICE - 1) / SELL_SLICE * SELL_SLICE;
+    const size_t slices = (csr.rows + SELL_SLICE - 1) / SELL_SLICE;
+    const auto length = [&](uint32_t r) { return csr.row_ptr[r + 1] - csr.row_ptr[r]; };
+
+    // Стабільне сортування у вікнах: рівні рядки лишаються у вихідному порядку, що зберігає локальність x
+    sell.row_order.resize(csr.rows);
+    std::iota(sell.row_order.begin(), sell.row_order.end(), 0u);
+    if (sell.sigma > 1) {
+        for (size_t start = 0; start < csr.rows; start += sell.sigma) {
+            std::stable_sort(sell.row_order.begin() + start, sell.row_order.begin() + std::min(csr.rows, start + sell.sigma),
+                             [&](uint32_t a, uint32_t b) { return length(a) > length(b); });
+        }
+    }
+
+    sell.row_len.assign(slices * SELL_SLICE, 0);
+    sell.slice_ptr.assign(slices + 1, 0);
+    for (size_t p = 0; p < csr.rows; ++p) {
+        sell.row_len[p] = static_cast<uint32_t>(length(sell.row_order[p]));
+    }
+    for (size_t s = 0; s < slices; ++s) {
+        const uint32_t* len = sell.row_len.data() + s * SELL_SLICE;
+        sell.slice_ptr[s + 1] = sell.slice_ptr[s] + *std::max_element(len, len + SELL_SLICE) * SELL_SLICE;
+    }
+
+    // Доповнення — стовпець 0 і нуль; ядра його не читають, але індекс лишається допустимим
+    sell.col_idx.assign(sell.slice_ptr[slices], 0);
+    sell.values.assign(sell.slice_ptr[slices], 0.0f);
+    for (size_t p = 0; p < csr.rows; ++p) {
+        const size_t base = sell.slice_ptr[p / SELL_SLICE] + p % SELL_SLICE;
+        const size_t begin = csr.row_ptr[sell.row_order[p]];
+        for (size_t j = 0; j < sell.row_len[p]; ++j) {
+            sell.col_idx[base + j * SELL_SLICE] = csr.col_idx[begin + j];
+            sell.values[base + j * SELL_SLICE] = csr.values[begin + j];
+        }
+    }
+    return sell;
+}
+
+void spmv(const CsrMatrix& A, const float* x, float* y, ThreadPool& pool) {
+    if (A.row_ptr.size() < 2) {
+        return;
+    }
+    const CsrKernelFn kernel = csr_kernel();
+    const size_t bytes = A.nnz() * (sizeof(float) + sizeof(uint32_t)) + A.rows * (sizeof(size_t) + sizeof(float)) +
+                         A.cols * sizeof(float);
+    run_balanced(A.row_ptr, 1, bytes, pool, [&](size_t first, size_t last) { kernel(A, x, y, first, last); });
+}
+
+void spmv(const SellMatrix& A, const float* x, float* y, ThreadPool& pool) {
+    if (A.slices() == 0) {
+        return;
+    }
+    const SellKernelFn kernel = sell_kernel();
+    const size_t bytes = A.values.size() * (sizeof(float) + sizeof(uint32_t)) + A.rows * 3 * sizeof(uint32_t) +
+                         A.cols * sizeof(float);
+    run_balanced(A.slice_ptr, SELL_SLICE, bytes, pool, [&](size_t first, size_t last) { kernel(A, x, y, first, last); });
+}
+
+}  // namespace simd
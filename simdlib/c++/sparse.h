@@ -0,0 +1,60 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace simd {
+
+// Розріджена матриця float у форматі CSR: ненульові рядка r — індекси row_ptr[r] .. row_ptr[r + 1] - 1
+// масивів col_idx і values (стовпці в межах рядка за зростанням). Індекси 32-бітні, як у vgatherdps,
+// тож cols не перевищує 2^31.
+struct CsrMatrix {
+    size_t rows = 0;
+    size_t cols = 0;
+    std::vector<size_t> row_ptr;    // rows + 1 елемент
+    std::vector<uint32_t> col_idx;
+    std::vector<float> values;
+
+    size_t nnz() const { return values.size(); }
+};
+
+// Висота зрізу SELL-C-sigma (C): один регістр AVX-512 або два AVX2. Однакова на всіх рівнях,
+// тож перетворена матриця не залежить від процесора.
+const size_t SELL_SLICE = 16;
+
+// Sliced ELLPACK із сортуванням рядків (SELL-C-sigma). Рядки в межах вікна з sigma рядків упорядковані
+// за кількістю ненульових (спадно) і згруповані по SELL_SLICE; зріз зберігається за стовпцями:
+// елемент j рядка на позиції s * SELL_SLICE + r лежить за індексом slice_ptr[s] + j * SELL_SLICE + r.
+// Ширина зрізу — найдовший рядок у ньому, коротші рядки доповнені (доповнення не читається, його
+// відкидає маска row_len). Кожен крок ядра — одне завантаження індексів, gather x і FMA для 16 рядків
+// одразу, без горизонтальних сум, які CSR платить за кожен рядок.
+struct SellMatrix {
+    size_t rows = 0;
+    size_t cols = 0;
+    size_t sigma = 1;
+    std::vector<size_t> slice_ptr;     // Початки зрізів; кількість зрізів + 1 елемент
+    std::vector<uint32_t> row_len;     // Ненульові рядка на позиції p; для позицій від rows — 0
+    std::vector<uint32_t> row_order;   // Номер у вихідній матриці рядка на позиції p < rows
+    std::vector<uint32_t> col_idx;
+    std::vector<float> values;
+
+    size_t slices() const { return slice_ptr.empty() ? 0 : slice_ptr.size() - 1; }
+};
+
+// Збирає CSR з ненульових елементів щільної матриці rows x cols у порядку рядків із кроком ld
+CsrMatrix csr_from_dense(const float* dense, size_t rows, size_t cols, size_t ld);
+
+// Перетворює CSR у SELL-C-sigma. sigma — вікно сортування рядків (округлюється вгору до кратного
+// SELL_SLICE): більше вікно — менше доповнення, але x читається менш локально. sigma = 1 — без сортування.
+SellMatrix sell_from_csr(const CsrMatrix& csr, size_t sigma = 256);
+
+// y = A * x, x — A.cols елементів, y — A.rows елементів у вихідному порядку рядків.
+// Рядки (зрізи) діляться між потоками pool на частини з приблизно однаковою кількістю ненульових,
+// а не рядків, тож кілька щільних рядків не лишають решту потоків без роботи. Матриця, яка разом
+// із векторами менша за PARALLEL_MIN_BYTES, рахується в потоці, що викликав.
+void spmv(const CsrMatrix& A, const float* x, float* y, ThreadPool& pool = default_pool());
+void spmv(const SellMatrix& A, const float* x, float* y, ThreadPool& pool = default_pool());
+
+}  // namespace simd
@@ -0,0 +1,94 @@
+﻿#include <immintrin.h>
+#include <cstddef>
+#include <cstdint>
+
+#include "sparse_internal.h"
+
+#include "target_avx2.h"
+
+namespace simd {
+
+namespace {
+
+float reduce_add(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+    return _mm_cvtss_f32(sum);
+}
+
+// Крок зрізу для 8 рядків: values[i] * x[col_idx[i]]; mask відкидає доповнення рядків, коротших за крок
+__m256 gather_fma(const float* x, const uint32_t* cols, const float* values, __m256i mask, __m256 acc) {
+    const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols));
+    const __m256 xv = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), x, idx, _mm256_castsi256_ps(mask), 4);
+    return _mm256_fmadd_ps(_mm256_loadu_ps(values), xv, acc);
+}
+
+}  // namespace
+
+// Рядок — по 16 ненульових у двох незалежних акумуляторах (gather має довгу затримку). Хвіст, коротший
+// за регістр, рахується скалярно: у коротких рядках (до кількох ненульових) маскований gather і згортка
+// регістра коштують більше, ніж кілька скалярних завантажень.
+void spmv_csr_avx2(const CsrMatrix& A, const float* x, float* y, size_t first, size_t last) {
+    const size_t* ptr = A.row_ptr.data();
+    const uint32_t* cols = A.col_idx.data();
+    const float* values = A.values.data();
+    for (size_t r = first; r < last; ++r) {
+        const size_t end = ptr[r + 1];
+        size_t i = ptr[r];
+        float sum = 0.0f;
+        if (i + 8 <= end) {
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            for (; i + 16 <= end; i += 16) {
+                const __m256i idx0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols + i));
+                const __m256i idx1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols + i + 8));
+                acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(values + i), _mm256_i32gather_ps(x, idx0, 4), acc0);
+                acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(values + i + 8), _mm256_i32gather_ps(x, idx1, 4), acc1);
+            }
+            if (i + 8 <= end) {
+                const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols + i));
+                acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(values + i), _mm256_i32gather_ps(x, idx, 4), acc0);
+                i += 8;
+            }
+            sum = reduce_add(_mm256_add_ps(acc0, acc1));
+        }
+        for (; i < end; ++i) {
+            sum += values[i] * x[cols[i]];
+        }
+        y[r] = sum;
+    }
+}
+
+// Зріз із 16 рядків — два регістри; на кроці j рядки, коротші за j + 1, відкидаються маскою
+void spmv_sell_avx2(const SellMatrix& A, const float* x, float* y, size_t first, size_t last) {
+    static_assert(SELL_SLICE == 16, "a slice is two AVX2 registers");
+    for (size_t s = first; s < last; ++s) {
+        const size_t base = A.slice_ptr[s];
+        const size_t width = (A.slice_ptr[s + 1] - base) / SELL_SLICE;
+        const uint32_t* len = A.row_len.data() + s * SELL_SLICE;
+        const __m256i len0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(len));
+        const __m256i len1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(len + 8));
+        const uint32_t* cols = A.col_idx.data() + base;
+        const float* values = A.values.data() + base;
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        for (size_t j = 0; j < width; ++j, cols += SELL_SLICE, values += SELL_SLICE) {
+            const __m256i step = _mm256_set1_epi32(static_cast<int>(j));
+            acc0 = gather_fma(x, cols, values, _mm256_cmpgt_epi32(len0, step), acc0);
+            acc1 = gather_fma(x, cols + 8, values + 8, _mm256_cmpgt_epi32(len1, step), acc1);
+        }
+        alignas(32) float sums[SELL_SLICE];
+        _mm256_store_ps(sums, acc0);
+        _mm256_store_ps(sums + 8, acc1);
+        const size_t count = A.rows - s * SELL_SLICE < SELL_SLICE ? A.rows - s * SELL_SLICE : SELL_SLICE;
+        const uint32_t* order = A.row_order.data() + s * SELL_SLICE;
+        for (size_t r = 0; r < count; ++r) {
+            y[order[r]] = sums[r];
+        }
+    }
+}
+
+}  // namespace simd
+
+#include "target_end.h"
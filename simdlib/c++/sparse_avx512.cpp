@@ -0,0 +1,80 @@
+﻿#include <immintrin.h>
+#include <cstddef>
+#include <cstdint>
+
+#include "sparse_internal.h"
+
+#include "target_avx512.h"
+
+namespace simd {
+
+// Рядок — по 32 ненульових у двох незалежних акумуляторах, хвіст — маскою. Рядки коротші за 8 ненульових
+// рахуються скалярно: там маскований gather і згортка регістра коштують більше за кілька скалярних завантажень.
+void spmv_csr_avx512(const CsrMatrix& A, const float* x, float* y, size_t first, size_t last) {
+    const size_t* ptr = A.row_ptr.data();
+    const uint32_t* cols = A.col_idx.data();
+    const float* values = A.values.data();
+    for (size_t r = first; r < last; ++r) {
+        const size_t end = ptr[r + 1];
+        size_t i = ptr[r];
+        if (end - i < 8) {
+            float sum = 0.0f;
+            for (; i < end; ++i) {
+                sum += values[i] * x[cols[i]];
+            }
+            y[r] = sum;
+            continue;
+        }
+        __m512 acc0 = _mm512_setzero_ps();
+        __m512 acc1 = _mm512_setzero_ps();
+        for (; i + 32 <= end; i += 32) {
+            const __m512i idx0 = _mm512_loadu_si512(cols + i);
+            const __m512i idx1 = _mm512_loadu_si512(cols + i + 16);
+            acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(values + i), _mm512_i32gather_ps(idx0, x, 4), acc0);
+            acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(values + i + 16), _mm512_i32gather_ps(idx1, x, 4), acc1);
+        }
+        for (; i < end; i += 16) {
+            const __mmask16 mask = end - i >= 16 ? static_cast<__mmask16>(0xFFFF) : static_cast<__mmask16>((1u << (end - i)) - 1);
+            const __m512i idx = _mm512_maskz_loadu_epi32(mask, cols + i);
+            const __m512 xv = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, idx, x, 4);
+            acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, values + i), xv, acc1);
+        }
+        y[r] = _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    }
+}
+
+// Зріз — один регістр; суми пишуться у вихідні рядки scatter'ом за row_order
+void spmv_sell_avx512(const SellMatrix& A, const float* x, float* y, size_t first, size_t last) {
+    static_assert(SELL_SLICE == 16, "a slice is one AVX-512 register");
+    for (size_t s = first; s < last; ++s) {
+        const size_t base = A.slice_ptr[s];
+        const size_t width = (A.slice_ptr[s + 1] - base) / SELL_SLICE;
+        const __m512i len = _mm512_loadu_si512(A.row_len.data() + s * SELL_SLICE);
+        const uint32_t* cols = A.col_idx.data() + base;
+        const float* values = A.values.data() + base;
+        __m512 acc0 = _mm512_setzero_ps();
+        __m512 acc1 = _mm512_setzero_ps();
+        size_t j = 0;
+        for (; j + 2 <= width; j += 2, cols += 2 * SELL_SLICE, values += 2 * SELL_SLICE) {
+            const __mmask16 mask0 = _mm512_cmpgt_epu32_mask(len, _mm512_set1_epi32(static_cast<int>(j)));
+            const __mmask16 mask1 = _mm512_cmpgt_epu32_mask(len, _mm512_set1_epi32(static_cast<int>(j + 1)));
+            const __m512 x0 = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask0, _mm512_loadu_si512(cols), x, 4);
+            const __m512 x1 = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask1, _mm512_loadu_si512(cols + SELL_SLICE), x, 4);
+            acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(values), x0, acc0);
+            acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(values + SELL_SLICE), x1, acc1);
+        }
+        if (j < width) {
+            const __mmask16 mask = _mm512_cmpgt_epu32_mask(len, _mm512_set1_epi32(static_cast<int>(j)));
+            const __m512 xv = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, _mm512_loadu_si512(cols), x, 4);
+            acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(values), xv, acc0);
+        }
+        const size_t count = A.rows - s * SELL_SLICE;
+        const __mmask16 valid = count >= SELL_SLICE ? static_cast<__mmask16>(0xFFFF) : static_cast<__mmask16>((1u << count) - 1);
+        const __m512i order = _mm512_maskz_loadu_epi32(valid, A.row_order.data() + s * SELL_SLICE);
+        _mm512_mask_i32scatter_ps(y, valid, order, _mm512_add_ps(acc0, acc1), 4);
+    }
+}
+
+}  // namespace simd
+
+#include "target_end.h"
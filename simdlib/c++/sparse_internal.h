@@ -0,0 +1,19 @@
+﻿#pragma once
+#include <cstddef>
+
+#include "sparse.h"
+
+// Ядра sparse_<рівень>.cpp. Використовуються лише диспетчером.
+namespace simd {
+
+// Рядки first .. last - 1 матриці CSR
+using CsrKernelFn = void (*)(const CsrMatrix& A, const float* x, float* y, size_t first, size_t last);
+// Зрізи first .. last - 1 матриці SELL-C-sigma
+using SellKernelFn = void (*)(const SellMatrix& A, const float* x, float* y, size_t first, size_t last);
+
+void spmv_csr_avx2(const CsrMatrix& A, const float* x, float* y, size_t first, size_t last);
+void spmv_sell_avx2(const SellMatrix& A, const float* x, float* y, size_t first, size_t last);
+void spmv_csr_avx512(const CsrMatrix& A, const float* x, float* y, size_t first, size_t last);
+void spmv_sell_avx512(const SellMatrix& A, const float* x, float* y, size_t first, size_t last);
+
+}  // namespace simd
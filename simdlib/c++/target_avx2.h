@@ -0,0 +1,10 @@
+﻿// Вмикає AVX2/FMA для решти одиниці трансляції, аж до target_end.h.
+// Код під цими прагмами викликається лише після перевірки cpuid у диспетчері,
+// тому бібліотеку можна збирати без -mavx2/-mavx512f.
+// Стандартні заголовки слід підключати ДО цього файлу.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma,bmi,bmi2,popcnt,f16c,pclmul"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma,bmi,bmi2,popcnt,f16c,pclmul")
+#endif
@@ -0,0 +1,7 @@
+﻿// Вмикає AVX-512 (F/BW/VL/DQ) для решти одиниці трансляції, аж до target_end.h (див. target_avx2.h).
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f,avx512bw,avx512vl,avx512dq,avx2,fma,bmi,bmi2,popcnt,f16c,pclmul"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512vl,avx512dq,avx2,fma,bmi,bmi2,popcnt,f16c,pclmul")
+#endif
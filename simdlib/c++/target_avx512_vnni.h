@@ -0,0 +1,8 @@
+﻿// Вмикає AVX-512 разом з AVX512_VNNI для решти одиниці трансляції, аж до target_end.h
+// (див. target_avx2.h). Код під цією прагмою викликається лише за CpuFeatures::avx512_vnni.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f,avx512bw,avx512vl,avx512dq,avx2,fma,bmi,bmi2,popcnt,f16c,pclmul,avx512vnni"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512vl,avx512dq,avx2,fma,bmi,bmi2,popcnt,f16c,pclmul,avx512vnni")
+#endif
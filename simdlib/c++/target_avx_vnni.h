@@ -0,0 +1,8 @@
+﻿// Вмикає AVX2 разом з AVX-VNNI (vpdpbusd на YMM) для решти одиниці трансляції, аж до target_end.h
+// (див. target_avx2.h). Код під цією прагмою викликається лише за CpuFeatures::avx_vnni.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma,bmi,bmi2,popcnt,f16c,pclmul,avxvnni"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma,bmi,bmi2,popcnt,f16c,pclmul,avxvnni")
+#endif
@@ -0,0 +1,6 @@
+﻿// Завершує область, відкриту одним із target_*.h
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
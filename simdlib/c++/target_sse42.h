@@ -0,0 +1,7 @@
+﻿// Вмикає SSE4.2 для решти одиниці трансляції, аж до target_end.h (див. target_avx2.h).
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.2,popcnt"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse4.2,popcnt")
+#endif
@@ -0,0 +1,269 @@
+﻿#include "text_index.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "bit_ops.h"
+#include "kernels.h"
+#include "parallel.h"
+#include "text_index_internal.h"
+#include "thread_pool.h"
+
+namespace simd {
+
+namespace {
+
+using ClassifyFn = void (*)(const ByteClassTables& t, const char* text, size_t len, uint64_t* masks, uint64_t& inside);
+
+void classify_blocks_scalar(const ByteClassTables& t, const char* text, size_t len, uint64_t* masks, uint64_t& inside) {
+    for (size_t i = 0; i < len; i += 64, masks += t.count) {
+        std::fill(masks, masks + t.count, 0);
+        const size_t n = std::min<size_t>(64, len - i);
+        for (size_t j = 0; j < n; ++j) {
+            const uint8_t c = t.classes[static_cast<uint8_t>(text[i + j])];
+            if (c) {
+                masks[ctz32(c)] |= uint64_t(1) << j;
+            }
+        }
+        if (t.quote >= 0) {
+            mask_quoted(t, masks, prefix_xor(masks[t.quote]), inside);
+        }
+    }
+}
+
+ClassifyFn classifier() {
+    switch (active_tier()) {
+    case CpuTier::AVX512: return classify_blocks_avx512;
+    case CpuTier::AVX2: return classify_blocks_avx2;
+    case CpuTier::SSE42: return classify_blocks_sse42;
+    case CpuTier::Scalar: break;
+    }
+    return classify_blocks_scalar;
+}
+
+// Додає байт до таблиць; повертає його клас або -1, якщо класів уже MAX_SCAN_BYTES
+int add_class(ByteClassTables& t, char byte) {
+    const uint8_t c = static_cast<uint8_t>(byte);
+    if (t.classes[c]) {
+        return static_cast<int>(ctz32(t.classes[c]));
+    }
+    if (t.count == MAX_SCAN_BYTES) {
+        return -1;
+    }
+    const uint8_t bit = static_cast<uint8_t>(1u << t.count);
+    t.lo[c & 0x0F] |= bit;
+    t.hi[c >> 4] |= bit;
+    t.classes[c] = bit;
+    return static_cast<int>(t.count++);
+}
+
+// Проходить text пакетами по SCAN_BATCH байтів і викликає fn(offset, masks, blocks) для кожного пакета,
+// де offset — зміщення пакета від text
+template <typename Fn>
+void scan(const ByteClassTables& t, ClassifyFn classify, const char* text, size_t len, uint64_t inside, Fn&& fn) {
+    uint64_t masks[SCAN_BATCH / 64 * MAX_SCAN_BYTES];
+    for (size_t offset = 0; offset < len; offset += SCAN_BATCH) {
+        const size_t n = std::min(SCAN_BATCH, len - offset);
+        classify(t, text + offset, n, masks, inside);
+        fn(offset, masks, (n + 63) / 64);
+    }
+}
+
+// Записує в p позиції base + i для всіх встановлених бітів i маски; повертає кінець записаного
+uint64_t* write_positions(uint64_t* p, uint64_t base, uint64_t mask) {
+    for (; mask; mask &= mask - 1) {
+        *p++ = base + ctz64(mask);
+    }
+    return p;
+}
+
+// Позиції байтів усіх класів, зсунуті на base. Позиції пакета збираються в буфер на стеку
+// й дописуються до out одним insert, а не по одній.
+void collect_positions(const ByteClassTables& t, ClassifyFn classify, const char* text, size_t len,
+                       uint64_t base, std::vector<uint64_t>& out) {
+    uint64_t found[SCAN_BATCH];
+    scan(t, classify, text, len, 0, [&](size_t offset, const uint64_t* masks, size_t blocks) {
+        uint64_t* p = found;
+        for (size_t k = 0; k < blocks; ++k, masks += t.count) {
+            uint64_t any = 0;
+            for (size_t b = 0; b < t.count; ++b) {
+                any |= masks[b];
+            }
+            p = write_positions(p, base + offset + 64 * k, any);
+        }
+        out.insert(out.end(), found, p);
+    });
+}
+
+// Шматки паралельної обробки: кратні 64 байтам, тож неповним буває лише останній блок тексту
+struct TextChunks {
+    size_t size = 0;
+    size_t count = 1;
+
+    size_t begin(size_t i) const { return i * size; }
+    size_t length(size_t i, size_t len) const { return std::min(size, len - begin(i)); }
+};
+
+TextChunks plan_chunks(size_t len, const ThreadPool& pool) {
+    TextChunks chunks;
+    chunks.size = len;
+    if (len >= PARALLEL_MIN_BYTES && pool.size() > 1) {
+        // Кілька шматків на потік вирівнюють навантаження, коли щільність роздільників різна
+        const size_t target = std::max<size_t>(len / (4 * pool.size()), 256u << 10);
+        chunks.size = (target + 63) / 64 * 64;
+        chunks.count = (len + chunks.size - 1) / chunks.size;
+    }
+    return chunks;
+}
+
+// Дописує до out результати шматків по черзі; якщо задано shift, до елементів шматка i додається shift[i]
+void concatenate(const std::vector<std::vector<uint64_t>>& parts, std::vector<uint64_t>& out, ThreadPool& pool,
+                 const std::vector<uint64_t>* shift = nullptr) {
+    std::vector<size_t> start(parts.size() + 1, out.size());
+    for (size_t i = 0; i < parts.size(); ++i) {
+        start[i + 1] = start[i] + parts[i].size();
+    }
+    out.resize(start.back());
+    pool.parallel_for(parts.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const uint64_t add = shift ? (*shift)[i] : 0;
+            uint64_t* p = out.data() + start[i];
+            for (uint64_t v : parts[i]) {
+                *p++ = v + add;
+            }
+        }
+    });
+}
+
+// Позиції байтів класів зі зсувом base, дописані до out (паралельно для великих текстів)
+void positions(const ByteClassTables& t, const char* text, size_t len, uint64_t base, std::vector<uint64_t>& out) {
+    const ClassifyFn classify = classifier();
+    ThreadPool& pool = default_pool();
+    const TextChunks chunks = plan_chunks(len, pool);
+    if (chunks.count == 1) {
+        collect_positions(t, classify, text, len, base, out);
+        return;
+    }
+    std::vector<std::vector<uint64_t>> parts(chunks.count);
+    pool.parallel_for(chunks.count, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            collect_positions(t, classify, text + chunks.begin(i), chunks.length(i, len), base + chunks.begin(i), parts[i]);
+        }
+    });
+    concatenate(parts, out, pool);
+}
+
+// Поля одного шматка; row_ends — номери полів відносно початку шматка
+void collect_fields(const ByteClassTables& t, ClassifyFn classify, const char* text, size_t len, uint64_t base,
+                    uint64_t inside, int delimiter, int newline,
+                    std::vector<uint64_t>& field_ends, std::vector<uint64_t>& row_ends) {
+    uint64_t found[SCAN_BATCH];
+    uint64_t rows_found[SCAN_BATCH];
+    scan(t, classify, text, len, inside, [&](size_t offset, const uint64_t* masks, size_t blocks) {
+        uint64_t* p = found;
+        uint64_t* r = rows_found;
+        for (size_t k = 0; k < blocks; ++k, masks += t.count) {
+            const uint64_t rows = masks[newline];
+            const uint64_t ends = masks[delimiter] | rows;
+            const uint64_t first = field_ends.size() + static_cast<uint64_t>(p - found);
+            for (uint64_t m = rows; m; m &= m - 1) {
+                // Поле, що закінчується цим newline, має номер first + кількість кінців полів до нього включно
+                const uint64_t through = (uint64_t(2) << ctz64(m)) - 1;
+                *r++ = first + popcount64(ends & through);
+            }
+            p = write_positions(p, base + offset + 64 * k, ends);
+        }
+        field_ends.insert(field_ends.end(), found, p);
+        row_ends.insert(row_ends.end(), rows_found, r);
+    });
+}
+
+}  // namespace
+
+bool find_bytes(const char* text, size_t len, const std::string& bytes, std::vector<uint64_t>& positions_out) {
+    ByteClassTables t;
+    for (char c : bytes) {
+        if (add_class(t, c) < 0) {
+            return false;
+        }
+    }
+    if (t.count == 0) {
+        return false;
+    }
+    positions_out.clear();
+    positions(t, text, len, 0, positions_out);
+    return true;
+}
+
+std::vector<uint64_t> line_index(const char* text, size_t len, char newline) {
+    std::vector<uint64_t> starts;
+    if (len == 0) {
+        return starts;
+    }
+    ByteClassTables t;
+    add_class(t, newline);
+    starts.push_back(0);
+    positions(t, text, len, 1, starts);  // Рядок починається після newline
+    if (starts.back() == len) {
+        starts.pop_back();
+    }
+    return starts;
+}
+
+FieldIndex index_fields(const char* text, size_t len, const TextDialect& dialect) {
+    ByteClassTables t;
+    const int delimiter = add_class(t, dialect.delimiter);
+    const int newline = add_class(t, dialect.newline);
+    if (dialect.quote != '\0') {
+        t.quote = add_class(t, dialect.quote);
+    }
+
+    FieldIndex index;
+    const ClassifyFn classify = classifier();
+    ThreadPool& pool = default_pool();
+    const TextChunks chunks = plan_chunks(len, pool);
+    if (chunks.count == 1) {
+        collect_fields(t, classify, text, len, 0, 0, delimiter, newline, index.field_ends, index.row_ends);
+    }
+    else {
+        // Перший прохід: стан лапок на початку кожного шматка — парність лапок у попередніх
+        std::vector<uint64_t> inside(chunks.count, 0);
+        if (t.quote >= 0) {
+            std::vector<uint8_t> odd(chunks.count);
+            pool.parallel_for(chunks.count, 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    odd[i] = count_substring(text + chunks.begin(i), chunks.length(i, len), &dialect.quote, 1) & 1;
+                }
+            });
+            for (size_t i = 1; i < chunks.count; ++i) {
+                inside[i] = inside[i - 1] ^ (odd[i - 1] ? ~uint64_t(0) : 0);
+            }
+        }
+
+        std::vector<std::vector<uint64_t>> fields(chunks.count), rows(chunks.count);
+        pool.parallel_for(chunks.count, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                collect_fields(t, classify, text + chunks.begin(i), chunks.length(i, len), chunks.begin(i),
+                               inside[i], delimiter, newline, fields[i], rows[i]);
+            }
+        });
+
+        // Номери полів у row_ends шматка зсуваються на кількість полів у попередніх шматках
+        std::vector<uint64_t> field_base(chunks.count, 0);
+        for (size_t i = 1; i < chunks.count; ++i) {
+            field_base[i] = field_base[i - 1] + fields[i - 1].size();
+        }
+        concatenate(fields, index.field_ends, pool);
+        concatenate(rows, index.row_ends, pool, &field_base);
+    }
+
+    // Останній рядок без завершального newline
+    const bool terminated = !index.row_ends.empty() && index.field_ends[index.row_ends.back() - 1] == len - 1;
+    if (len > 0 && !terminated) {
+        index.field_ends.push_back(len);
+        index.row_ends.push_back(index.field_ends.size());
+    }
+    return index;
+}
+
+}  // namespace simd
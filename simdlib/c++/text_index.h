@@ -0,0 +1,46 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace simd {
+
+// Структурний сканер тексту: позиції кількох заданих байтів (перенесення рядка, роздільник, лапки,
+// табуляція) знаходяться за один прохід блоками по 64 байти. Клас байта визначається двома pshufb
+// за молодшим і старшим півбайтами, маски класів обходяться через tzcnt. Тексти від PARALLEL_MIN_BYTES
+// діляться на шматки між потоками default_pool(), результат не залежить від кількості потоків.
+
+// Скільки різних байтів сканер шукає одночасно (по біту класу на байт)
+const size_t MAX_SCAN_BYTES = 8;
+
+// Записує в positions зростаючі позиції всіх байтів text, що входять у bytes. Повертає false і не змінює
+// positions, якщо bytes порожній або містить більше MAX_SCAN_BYTES різних байтів.
+bool find_bytes(const char* text, size_t len, const std::string& bytes, std::vector<uint64_t>& positions);
+
+// Початки рядків: 0 і кожна позиція після newline, менша за len (для порожнього тексту — жодної).
+// Рядок i займає [starts[i], starts[i + 1]) разом із завершальним newline.
+std::vector<uint64_t> line_index(const char* text, size_t len, char newline = '\n');
+
+// Формат CSV-подібного тексту. Усі три байти мають бути різними.
+struct TextDialect {
+    char delimiter = ',';
+    char quote = '"';     // Між лапками роздільники й newline — частина поля; '\0' — лапки не розпізнаються
+    char newline = '\n';  // '\r' перед newline лишається в останньому полі рядка
+};
+
+// Межі полів. Поле j закінчується роздільником або newline у позиції field_ends[j] і починається після
+// field_ends[j - 1] (перше — з 0). Якщо текст не закінчується newline поза лапками, останнє поле
+// закінчується в len. Рядок r складається з полів [row_ends[r - 1], row_ends[r]) (перший — з 0).
+struct FieldIndex {
+    std::vector<uint64_t> field_ends;
+    std::vector<uint64_t> row_ends;
+};
+
+// Індекс полів за один прохід. Стан «між лапками» — префіксне XOR маски лапок у блоці (множення без
+// переносів на рівнях AVX2 і AVX-512), перенесене з попереднього блоку; подвоєні лапки всередині поля
+// перемикають стан двічі, тож екранування за RFC 4180 нічого не ламає. Паралельна версія спершу рахує
+// парність лапок у кожному шматку, щоб знати стан на його початку.
+FieldIndex index_fields(const char* text, size_t len, const TextDialect& dialect = TextDialect());
+
+}  // namespace simd
@@ -0,0 +1,56 @@
+﻿#include <immintrin.h>
+#include <cstring>
+
+#include "text_index_internal.h"
+
+#include "target_avx2.h"
+
+namespace simd {
+
+namespace {
+
+inline __m256i classes(__m256i lo, __m256i hi, __m256i chunk) {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    return _mm256_and_si256(_mm256_shuffle_epi8(lo, _mm256_and_si256(chunk, nibble)),
+                            _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble)));
+}
+
+// Префіксне XOR одним множенням без переносів на число з усіх одиниць
+inline uint64_t prefix_xor_clmul(uint64_t x) {
+    const __m128i product = _mm_clmulepi64_si128(_mm_cvtsi64_si128(static_cast<int64_t>(x)), _mm_set1_epi8(-1), 0);
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(product));
+}
+
+}  // namespace
+
+// Блок — два 32-байтові шматки; неповний останній блок копіюється в буфер із нулями
+void classify_blocks_avx2(const ByteClassTables& t, const char* text, size_t len, uint64_t* masks, uint64_t& inside) {
+    const __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)t.lo));
+    const __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)t.hi));
+    alignas(32) char tail[64];
+    for (size_t i = 0; i < len; i += 64, masks += t.count) {
+        const char* block = text + i;
+        uint64_t valid = ~uint64_t(0);
+        if (len - i < 64) {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, block, len - i);
+            block = tail;
+            valid = (uint64_t(1) << (len - i)) - 1;
+        }
+        const __m256i c0 = classes(lo, hi, _mm256_loadu_si256((const __m256i*)block));
+        const __m256i c1 = classes(lo, hi, _mm256_loadu_si256((const __m256i*)(block + 32)));
+        for (size_t b = 0; b < t.count; ++b) {
+            const __m256i bit = _mm256_set1_epi8(static_cast<char>(1u << b));
+            const uint32_t m0 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(c0, bit), bit)));
+            const uint32_t m1 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(c1, bit), bit)));
+            masks[b] = (m0 | uint64_t(m1) << 32) & valid;
+        }
+        if (t.quote >= 0) {
+            mask_quoted(t, masks, prefix_xor_clmul(masks[t.quote]), inside);
+        }
+    }
+}
+
+}  // namespace simd
+
+#include "target_end.h"
@@ -0,0 +1,40 @@
+﻿#include <immintrin.h>
+
+#include "text_index_internal.h"
+
+#include "target_avx512.h"
+
+namespace simd {
+
+namespace {
+
+inline uint64_t prefix_xor_clmul(uint64_t x) {
+    const __m128i product = _mm_clmulepi64_si128(_mm_cvtsi64_si128(static_cast<int64_t>(x)), _mm_set1_epi8(-1), 0);
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(product));
+}
+
+}  // namespace
+
+// Блок — один 64-байтовий регістр; неповний останній блок читається маскою, тож копія не потрібна.
+// Маска класу b — vptestmb класів байтів з бітом b.
+void classify_blocks_avx512(const ByteClassTables& t, const char* text, size_t len, uint64_t* masks, uint64_t& inside) {
+    const __m512i lo = _mm512_broadcast_i32x4(_mm_load_si128((const __m128i*)t.lo));
+    const __m512i hi = _mm512_broadcast_i32x4(_mm_load_si128((const __m128i*)t.hi));
+    const __m512i nibble = _mm512_set1_epi8(0x0F);
+    for (size_t i = 0; i < len; i += 64, masks += t.count) {
+        const __mmask64 valid = len - i < 64 ? _bzhi_u64(~uint64_t(0), static_cast<unsigned>(len - i)) : ~uint64_t(0);
+        const __m512i chunk = _mm512_maskz_loadu_epi8(valid, text + i);
+        const __m512i c = _mm512_and_si512(_mm512_shuffle_epi8(lo, _mm512_and_si512(chunk, nibble)),
+                                           _mm512_shuffle_epi8(hi, _mm512_and_si512(_mm512_srli_epi16(chunk, 4), nibble)));
+        for (size_t b = 0; b < t.count; ++b) {
+            masks[b] = _mm512_mask_test_epi8_mask(valid, c, _mm512_set1_epi8(static_cast<char>(1u << b)));
+        }
+        if (t.quote >= 0) {
+            mask_quoted(t, masks, prefix_xor_clmul(masks[t.quote]), inside);
+        }
+    }
+}
+
+}  // namespace simd
+
+#include "target_end.h"
@@ -0,0 +1,51 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Класифікація блоків для text_index.cpp. Використовується лише диспетчером.
+namespace simd {
+
+// Таблиці класів: байт bytes[b] має клас b, тобто lo[c & 15] & hi[c >> 4] містить біт b лише для c == bytes[b]
+// (кожен біт належить одному байту, тож перетин півбайтових таблиць не дає хибних збігів)
+struct ByteClassTables {
+    alignas(16) uint8_t lo[16] = {};
+    alignas(16) uint8_t hi[16] = {};
+    uint8_t classes[256] = {};  // Той самий біт класу за повним байтом, для скалярного рівня
+    size_t count = 0;           // Кількість класів, не більше MAX_SCAN_BYTES
+    int quote = -1;             // Клас лапок або -1; маски решти класів очищуються між лапками
+};
+
+// Скільки байтів класифікує один виклик: 64 блоки, маски яких лишаються в L1
+const size_t SCAN_BATCH = 4096;
+
+// Класифікує text[0, len), len <= SCAN_BATCH: masks[k * t.count + b] — маска байтів класу b у 64-байтовому
+// блоці k (біт i — байт 64k + i; останній блок може бути неповним). Якщо t.quote >= 0, у масках інших
+// класів очищуються біти між лапками; inside — стан на початку (0 або ~0), після виклику — стан у кінці.
+void classify_blocks_sse42(const ByteClassTables& t, const char* text, size_t len, uint64_t* masks, uint64_t& inside);
+void classify_blocks_avx2(const ByteClassTables& t, const char* text, size_t len, uint64_t* masks, uint64_t& inside);
+void classify_blocks_avx512(const ByteClassTables& t, const char* text, size_t len, uint64_t* masks, uint64_t& inside);
+
+// Префіксне XOR зсувами: біт i результату — XOR бітів 0..i
+inline uint64_t prefix_xor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// Очищує в масках блоку біти між лапками. quoted — префіксне XOR маски лапок блоку: біт встановлено
+// від відкривальних лапок (включно) до закривальних (не включно).
+inline void mask_quoted(const ByteClassTables& t, uint64_t* masks, uint64_t quoted, uint64_t& inside) {
+    const uint64_t in = quoted ^ inside;
+    inside = static_cast<uint64_t>(static_cast<int64_t>(in) >> 63);
+    for (size_t b = 0; b < t.count; ++b) {
+        if (static_cast<int>(b) != t.quote) {
+            masks[b] &= ~in;
+        }
+    }
+}
+
+}  // namespace simd
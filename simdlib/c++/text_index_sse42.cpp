@@ -0,0 +1,57 @@
+﻿#include <immintrin.h>
+#include <cstring>
+
+#include "text_index_internal.h"
+
+#include "target_sse42.h"
+
+namespace simd {
+
+namespace {
+
+// Біт b класу кожного байта 16-байтового шматка
+inline __m128i classes(__m128i lo, __m128i hi, __m128i chunk) {
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    return _mm_and_si128(_mm_shuffle_epi8(lo, _mm_and_si128(chunk, nibble)),
+                         _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(chunk, 4), nibble)));
+}
+
+}  // namespace
+
+// Блок — чотири 16-байтові шматки; неповний останній блок копіюється в буфер із нулями,
+// а зайві біти масок відкидаються. Префіксне XOR — зсувами (PCLMUL на цьому рівні не гарантовано).
+void classify_blocks_sse42(const ByteClassTables& t, const char* text, size_t len, uint64_t* masks, uint64_t& inside) {
+    const __m128i lo = _mm_load_si128((const __m128i*)t.lo);
+    const __m128i hi = _mm_load_si128((const __m128i*)t.hi);
+    alignas(16) char tail[64];
+    for (size_t i = 0; i < len; i += 64, masks += t.count) {
+        const char* block = text + i;
+        uint64_t valid = ~uint64_t(0);
+        if (len - i < 64) {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, block, len - i);
+            block = tail;
+            valid = (uint64_t(1) << (len - i)) - 1;
+        }
+        __m128i c[4];
+        for (size_t q = 0; q < 4; ++q) {
+            c[q] = classes(lo, hi, _mm_loadu_si128((const __m128i*)(block + 16 * q)));
+        }
+        for (size_t b = 0; b < t.count; ++b) {
+            const __m128i bit = _mm_set1_epi8(static_cast<char>(1u << b));
+            uint64_t mask = 0;
+            for (size_t q = 0; q < 4; ++q) {
+                const uint32_t m = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(c[q], bit), bit)));
+                mask |= uint64_t(m) << (16 * q);
+            }
+            masks[b] = mask & valid;
+        }
+        if (t.quote >= 0) {
+            mask_quoted(t, masks, prefix_xor(masks[t.quote]), inside);
+        }
+    }
+}
+
+}  // namespace simd
+
+#include "target_end.h"
@@ -0,0 +1,143 @@
+﻿#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace simd {
+
+namespace {
+
+// Чи виконується поточний потік усередині parallel_for (щоб вкладені виклики йшли послідовно)
+thread_local bool t_in_parallel = false;
+
+size_t default_thread_count() {
+    if (const char* env = std::getenv("SIMDLIB_THREADS")) {
+        const long value = std::strtol(env, nullptr, 10);
+        if (value > 0) {
+            return static_cast<size_t>(value);
+        }
+    }
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw ? hw : 1;
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(size_t threads) {
+    for (size_t i = 1; i < threads; ++i) {
+        workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run_chunks() {
+    const size_t chunks = (job_count_ + job_grain_ - 1) / job_grain_;
+    for (;;) {
+        const size_t chunk = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= chunks) {
+            break;
+        }
+        const size_t begin = chunk * job_grain_;
+        (*job_)(begin, std::min(begin + job_grain_, job_count_));
+    }
+}
+
+void ThreadPool::worker_loop(size_t index) {
+    t_in_parallel = true;
+    size_t seen = 0;
+    for (;;) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) {
+            return;
+        }
+        seen = generation_;
+        lock.unlock();
+
+        if (job_on_all_) {
+            (*job_)(index, size());
+        }
+        else {
+            run_chunks();
+        }
+
+        lock.lock();
+        if (--busy_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
+
+void ThreadPool::parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+
+    // Замало роботи, немає робочих потоків або вкладений виклик — виконуємо на місці
+    if (workers_.empty() || t_in_parallel || count <= grain) {
+        for (size_t begin = 0; begin < count; begin += grain) {
+            fn(begin, std::min(begin + grain, count));
+        }
+        return;
+    }
+
+    start_job(fn, count, grain, false);
+}
+
+void ThreadPool::run_on_all(const std::function<void(size_t, size_t)>& fn) {
+    if (workers_.empty() || t_in_parallel) {
+        for (size_t index = 0; index < size(); ++index) {
+            fn(index, size());
+        }
+        return;
+    }
+    start_job(fn, size(), 1, true);
+}
+
+// Роздає завдання робочим потокам, виконує свою частину й чекає на решту
+void ThreadPool::start_job(const std::function<void(size_t, size_t)>& fn, size_t count, size_t grain, bool on_all) {
+    std::lock_guard<std::mutex> call_lock(call_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &fn;
+        job_count_ = count;
+        job_grain_ = grain;
+        job_on_all_ = on_all;
+        next_chunk_.store(0, std::memory_order_relaxed);
+        busy_ = workers_.size();
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    // Потік, що викликав, теж бере шматки (або виконує index 0)
+    t_in_parallel = true;
+    if (on_all) {
+        fn(0, size());
+    }
+    else {
+        run_chunks();
+    }
+    t_in_parallel = false;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&] { return busy_ == 0; });
+    job_ = nullptr;
+}
+
+ThreadPool& default_pool() {
+    static ThreadPool pool(default_thread_count());
+    return pool;
+}
+
+}  // namespace simd
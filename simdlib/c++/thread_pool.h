@@ -0,0 +1,62 @@
+﻿#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace simd {
+
+// Постійний пул потоків. Потоки створюються один раз і чекають на роботу,
+// тож паралельний виклик не платить за створення потоків.
+class ThreadPool {
+public:
+    // threads — загальна кількість виконавців, включно з потоком, що викликає parallel_for
+    explicit ThreadPool(size_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size() + 1; }
+
+    // Розбиває [0, count) на шматки по grain елементів і викликає fn(begin, end) для кожного.
+    // Шматки роздаються динамічно; виклик повертається, коли всі шматки оброблено.
+    // Вкладений виклик із робочого потоку виконується послідовно.
+    void parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+    // Викликає fn(index, size()) по одному разу для кожного index < size(). Той самий index завжди
+    // виконує той самий потік (0 — потік, що викликав), тож статичний розподіл даних за index
+    // зберігає прив'язку частин масиву до потоків між викликами (first-touch на NUMA-системах).
+    // Вкладений виклик виконує всі index послідовно.
+    void run_on_all(const std::function<void(size_t, size_t)>& fn);
+
+private:
+    void start_job(const std::function<void(size_t, size_t)>& fn, size_t count, size_t grain, bool on_all);
+    void worker_loop(size_t index);
+    void run_chunks();
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::mutex call_mutex_;  // Серіалізує виклики parallel_for із різних потоків
+
+    // Поточне завдання (захищене mutex_, окрім лічильника шматків)
+    const std::function<void(size_t, size_t)>* job_ = nullptr;
+    size_t job_count_ = 0;
+    size_t job_grain_ = 1;
+    bool job_on_all_ = false;          // run_on_all: кожен потік один раз викликає job_(index, size())
+    size_t generation_ = 0;
+    size_t busy_ = 0;
+    bool stop_ = false;
+    std::atomic<size_t> next_chunk_{0};
+};
+
+// Спільний пул бібліотеки. Кількість потоків задається змінною SIMDLIB_THREADS,
+// інакше береться std::thread::hardware_concurrency().
+ThreadPool& default_pool();
+
+}  // namespace simd
@@ -3,6 +3,8 @@
 #include <chrono>       // Для вимірювання часу виконання
 #include <random>       // Для генерації випадкових чисел
 
+#include "../../simdlib/c++/memory.h"
+
 // Звичайна функція додавання масивів без використання SIMD
 // Додавання виконується поелементно
 void add_arrays(const int* a, const int* b, int* result, int size) {
@@ -63,10 +65,10 @@ int main() {
     std::uniform_int_distribution<int> distribution(0, 100);  // Діапазон випадкових чисел
 
     // Виділення пам'яті для трьох масивів: два вхідні та один для результату
-    int* a = new int[size];
-    int* b = new int[size];
-    int* result_regular = new int[size];  // Результат для звичайної функції
-    int* result_avx = new int[size];      // Результат для SIMD функції
+    simd::AlignedBuffer<int> a(size);
+    simd::AlignedBuffer<int> b(size);
+    simd::AlignedBuffer<int> result_regular(size);  // Результат для звичайної функції
+    simd::AlignedBuffer<int> result_avx(size);      // Результат для SIMD функції
 
     // Ініціалізація масивів випадковими значеннями
     for (int i = 0; i < size; ++i) {
@@ -75,24 +77,18 @@ int main() {
     }
 
     // Вимірювання часу виконання звичайної функції додавання масивів
-    measure_time(add_arrays, a, b, result_regular, size, "Regular addition");
+    measure_time(add_arrays, a.data(), b.data(), result_regular.data(), size, "Regular addition");
 
     // Вимірювання часу виконання SIMD-функції додавання масивів
-    measure_time(add_arrays_avx, a, b, result_avx, size, "AVX addition");
+    measure_time(add_arrays_avx, a.data(), b.data(), result_avx.data(), size, "AVX addition");
 
     // Перевірка на відповідність результатів
-    if (compare_arrays(result_regular, result_avx, size)) {
+    if (compare_arrays(result_regular.data(), result_avx.data(), size)) {
         std::cout << "Results match!" << std::endl;
     }
     else {
         std::cout << "Results do not match!" << std::endl;
     }
 
-    // Звільнення виділеної пам'яті
-    delete[] a;
-    delete[] b;
-    delete[] result_regular;
-    delete[] result_avx;
-
     return 0;
 }
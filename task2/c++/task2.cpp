@@ -1,9 +1,10 @@
 ﻿#include <iostream>
 #include <immintrin.h>  // Для AVX-інтринсик-функцій
 #include <chrono>       // Для вимірювання часу виконання
-#include <malloc.h>     // Для _aligned_malloc і _aligned_free
 #include <random>       // Для генерації випадкових чисел
 
+#include "../../simdlib/c++/memory.h"
+
 // Звичайна функція додавання масивів без використання SIMD
 // Додавання виконується поелементно
 void add_arrays(const int* a, const int* b, int* result, int size) {
@@ -63,12 +64,12 @@ int main() {
     std::mt19937 generator(std::random_device{}());
     std::uniform_int_distribution<int> distribution(0, 100);  // Діапазон випадкових чисел
 
-    // Виділення пам'яті для трьох масивів з вирівнюванням 32 байта
-    // Вирівнювання 32 байта необхідне для AVX інструкцій
-    int* a = (int*)_aligned_malloc(size * sizeof(int), 32);
-    int* b = (int*)_aligned_malloc(size * sizeof(int), 32);
-    int* result = (int*)_aligned_malloc(size * sizeof(int), 32);
-    int* result_simd = (int*)_aligned_malloc(size * sizeof(int), 32);  // Масив для результатів SIMD
+    // Виділення пам'яті для масивів: AlignedBuffer вирівнює на 64 байти,
+    // а AVX-інструкціям _mm256_load/_mm256_store потрібне вирівнювання на 32 байти
+    simd::AlignedBuffer<int> a(size);
+    simd::AlignedBuffer<int> b(size);
+    simd::AlignedBuffer<int> result(size);
+    simd::AlignedBuffer<int> result_simd(size);  // Масив для результатів SIMD
 
     // Ініціалізація масивів випадковими значеннями
     for (int i = 0; i < size; ++i) {
@@ -77,24 +78,18 @@ int main() {
     }
 
     // Вимірювання часу виконання звичайної функції додавання масивів
-    measure_time(add_arrays, a, b, result, size, "Regular addition");
+    measure_time(add_arrays, a.data(), b.data(), result.data(), size, "Regular addition");
 
     // Вимірювання часу виконання SIMD-функції додавання масивів з вирівнюванням
-    measure_time(add_arrays_avx_aligned, a, b, result_simd, size, "AVX addition (aligned)");
+    measure_time(add_arrays_avx_aligned, a.data(), b.data(), result_simd.data(), size, "AVX addition (aligned)");
 
     // Перевірка результатів
-    if (check_results(result, result_simd, size)) {
+    if (check_results(result.data(), result_simd.data(), size)) {
         std::cout << "Results match!" << std::endl;  // Якщо результати співпадають
     }
     else {
         std::cout << "Results do not match!" << std::endl;  // Якщо результати не співпадають
     }
 
-    // Звільнення виділеної пам'яті
-    _aligned_free(a);
-    _aligned_free(b);
-    _aligned_free(result);
-    _aligned_free(result_simd);
-
     return 0;
 }
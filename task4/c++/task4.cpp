@@ -1,9 +1,10 @@
 ﻿#include <iostream>
 #include <immintrin.h>  // Для AVX-інструкцій
 #include <chrono>
-#include <memory>
 #include <cstdlib>
 
+#include "../../simdlib/c++/memory.h"
+
 // Звичайна функція для множення векторів
 void multiply_vectors(const float* a, const float* b, float* result, int size) {
     for (int i = 0; i < size; ++i) {
@@ -48,10 +49,10 @@ void measure_time(Func func, const float* a, const float* b, float* result, int
 int main() {
     const int size = 1000000;
 
-    auto a = std::make_unique<float[]>(size);
-    auto b = std::make_unique<float[]>(size);
-    auto result = std::make_unique<float[]>(size);
-    auto result_avx = std::make_unique<float[]>(size);
+    simd::AlignedBuffer<float> a(size);
+    simd::AlignedBuffer<float> b(size);
+    simd::AlignedBuffer<float> result(size);
+    simd::AlignedBuffer<float> result_avx(size);
 
     // Ініціалізація випадковими значеннями
     for (int i = 0; i < size; ++i) {
@@ -60,13 +61,13 @@ int main() {
     }
 
     // Вимір часу для звичайної функції
-    measure_time(multiply_vectors, a.get(), b.get(), result.get(), size, "Regular vector multiplication");
+    measure_time(multiply_vectors, a.data(), b.data(), result.data(), size, "Regular vector multiplication");
 
     // Вимір часу для AVX-функції
-    measure_time(multiply_vectors_avx, a.get(), b.get(), result_avx.get(), size, "AVX vector multiplication");
+    measure_time(multiply_vectors_avx, a.data(), b.data(), result_avx.data(), size, "AVX vector multiplication");
 
     // Перевірка результатів
-    if (check_results(result.get(), result_avx.get(), size)) {
+    if (check_results(result.data(), result_avx.data(), size)) {
         std::cout << "Results match!" << std::endl;
     }
     else {
@@ -5,8 +5,13 @@
 #include <cstring>
 #include <random>
 
+#include "../../simdlib/c++/memory.h"
+
 // Функція для підрахунку входжень підрядка за допомогою простого циклу
 int count_substring_loop(const char* str, size_t str_len, const char* substr, size_t substr_len) {
+    if (substr_len == 0 || str_len < substr_len) {
+        return 0;
+    }
     int count = 0;
     for (size_t i = 0; i <= str_len - substr_len; ++i) {
         if (memcmp(str + i, substr, substr_len) == 0) {
@@ -18,6 +23,10 @@ int count_substring_loop(const char* str, size_t str_len, const char* substr, si
 
 // Функція для підрахунку входжень підрядка за допомогою AVX2
 int count_substring_avx2(const char* str, size_t str_len, const char* substr, size_t substr_len) {
+    // Інакше str_len - substr_len нижче переповнюється (size_t)
+    if (substr_len == 0 || str_len < substr_len) {
+        return 0;
+    }
     int count = 0;
     size_t i = 0;
 
@@ -25,7 +34,7 @@ int count_substring_avx2(const char* str, size_t str_len, const char* substr, si
     __m256i first_char = _mm256_set1_epi8(substr[0]);
 
     // Обробляємо 32 символи за раз
-    for (; i <= str_len - 32; i += 32) {
+    for (; i + 32 <= str_len; i += 32) {
         __m256i str_chunk = _mm256_loadu_si256((__m256i*)(str + i));
         __m256i cmp_result = _mm256_cmpeq_epi8(str_chunk, first_char);
         int mask = _mm256_movemask_epi8(cmp_result);
@@ -77,14 +86,11 @@ int main() {
     const size_t str_len = 10000000;
     const size_t substr_len = 4;
 
-    // Виділяємо пам'ять з вирівнюванням для рядка та підрядка
-    char* str = static_cast<char*>(_aligned_malloc(str_len + 1, 32));
-    char* substr = static_cast<char*>(_aligned_malloc(substr_len + 1, 32));
-
-    if (!str || !substr) {
-        std::cerr << "Memory allocation failed" << std::endl;
-        return 1;
-    }
+    // Виділяємо пам'ять з вирівнюванням для рядка та підрядка (AlignedBuffer кидає std::bad_alloc при нестачі пам'яті)
+    simd::AlignedBuffer<char> str_buffer(str_len + 1);
+    simd::AlignedBuffer<char> substr_buffer(substr_len + 1);
+    char* str = str_buffer.data();
+    char* substr = substr_buffer.data();
 
     // Генеруємо випадковий рядок
     std::random_device rd;
@@ -106,9 +112,5 @@ int main() {
     // Вимірюємо час для функції AVX2
     measure_time(count_substring_avx2, str, str_len, substr, substr_len, "AVX2 search");
 
-    // Звільняємо виділену пам'ять
-    _aligned_free(str);
-    _aligned_free(substr);
-
     return 0;
 }